@@ -37,7 +37,7 @@ program gambit2metis5
   use mesh_mod
   implicit none
 
-  character(:),allocatable :: infile,metisfile,filename,file
+  character(:),allocatable :: infile,metisfile,filename,file,weights,weightspart
   character(len=512) :: arg
   type(meshtype)     :: mesh
   integer            :: n,np
@@ -46,18 +46,28 @@ program gambit2metis5
   infile=trim(adjustl(arg));n=len(infile)
   call get_command_argument(2,arg)
   read(arg,*)np
+  ! optional: prefix of the partition weights written by SeisSol (SEISSOL_PARTITION_WEIGHTS)
+  !           and the partition file of the run that wrote them
+  weights=''
+  weightspart=''
+  if(command_argument_count()>=4)then
+     call get_command_argument(3,arg)
+     weights=trim(adjustl(arg))
+     call get_command_argument(4,arg)
+     weightspart=trim(adjustl(arg))
+  endif
   call mesh%read_gambit(infile)
   filename=get_filename(infile);filename=filename(1:len(filename)-4)
-  call do_partitioning_external(mesh,np,filename)
+  call do_partitioning_external(mesh,np,filename,weights,weightspart)
 
 contains
 
-  subroutine do_partitioning_external(mesh,np,filename)
+  subroutine do_partitioning_external(mesh,np,filename,weights,weightspart)
     use ifport, only:system
     implicit none
     type(meshtype) :: mesh
     character(:),allocatable :: metisfile
-    character(len=*) :: filename
+    character(len=*) :: filename,weights,weightspart
     integer :: np
     integer :: i,iun
     metisfile=filename//'.met'  
@@ -68,6 +78,9 @@ contains
     end do
     close(iun)
     i=system('m2gmetis '//filename//'.met '//filename//'.met.dgraph ')
+    if(len(weights)>0)then
+       call add_weights(filename//'.met.dgraph',weights,weightspart,mesh%nelem)
+    endif
     i=system('gpmetis '//filename//'.met.dgraph '//int2str(np))
     !clean up of files
     i=system('rm '//filename//'.met')
@@ -75,6 +88,70 @@ contains
     i=system('mv '//filename//'.met.dgraph.part.'//int2str(np)//' '//filename//'.met.epart.'//int2str(np))
   end subroutine do_partitioning_external
 
+  !> Adds the (multi-constraint) partition weights written by SeisSol to the vertices of the graph.
+  !! The weights of each rank are stored in global element order, the partition of the run maps them back.
+  subroutine add_weights(graphfile,weights,weightspart,nelem)
+    use ifport, only:system
+    implicit none
+    character(len=*) :: graphfile,weights,weightspart
+    integer :: nelem
+    integer, allocatable :: part(:),order(:),offsets(:),w(:,:)
+    integer :: i,j,k,iun,iout,nranks,ncells,ncon,nvtx,nedges
+    character(len=65536) :: line
+    ! read partition of the run
+    allocate(part(nelem))
+    open(newunit=iun,file=weightspart,action='read')
+    do i = 1,nelem
+       read(iun,*)part(i)
+    end do
+    close(iun)
+    nranks=maxval(part)+1
+    ! order the elements by rank (counting sort, preserves the global order)
+    allocate(offsets(0:nranks),order(nelem))
+    offsets=0
+    do i = 1,nelem
+       offsets(part(i)+1)=offsets(part(i)+1)+1
+    end do
+    do j = 1,nranks
+       offsets(j)=offsets(j)+offsets(j-1)
+    end do
+    do i = 1,nelem
+       offsets(part(i))=offsets(part(i))+1
+       order(offsets(part(i)))=i
+    end do
+    do j = nranks,1,-1
+       offsets(j)=offsets(j-1)
+    end do
+    offsets(0)=0
+    ! read weights of all ranks
+    do j = 0,nranks-1
+       open(newunit=iun,file=weights//'.'//int2str(j),action='read')
+       read(iun,*)ncells,ncon
+       if(ncells/=offsets(j+1)-offsets(j))then
+          write(*,*)'number of weights of rank ',j,' does not match the partition'
+          stop
+       endif
+       if(.not.allocated(w))allocate(w(ncon,nelem))
+       do k = offsets(j)+1,offsets(j+1)
+          read(iun,*)w(:,order(k))
+       end do
+       close(iun)
+    end do
+    ! rewrite graph with vertex weights
+    open(newunit=iun,file=graphfile,action='read')
+    open(newunit=iout,file=graphfile//'.w',action='write')
+    read(iun,*)nvtx,nedges
+    write(iout,'(I0,1X,I0,A,I0)')nvtx,nedges,' 010 ',size(w,1)
+    do i = 1,nvtx
+       read(iun,'(A)')line
+       write(iout,'(*(I0,1X))',advance='no')w(:,i)
+       write(iout,'(A)')trim(line)
+    end do
+    close(iun)
+    close(iout)
+    i=system('mv '//graphfile//'.w '//graphfile)
+  end subroutine add_weights
+
   function get_filename(filestring,mext)
     implicit none
     character(len=*) :: filestring
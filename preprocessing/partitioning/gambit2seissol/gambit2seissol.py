@@ -42,6 +42,7 @@ from lib.partition import DummyPartition
 from lib.partition import PartitionWriter
 from lib.tmp import TmpDir
 
+from partition.metis import WeightReader
 from partition.partitioner import Partitioner
 from reorder.reorderer import Reorderer
 
@@ -67,7 +68,10 @@ def main():
     if args.partitions() > 1:
         print 'Starting partitioner'
         try:
-            partitioner = Partitioner(mesh, args.partitions(), tmpdir)
+            weights = None
+            if args.weights():
+                weights = WeightReader(args.weights(), args.weightsPartition())
+            partitioner = Partitioner(mesh, args.partitions(), tmpdir, weights)
             partition = partitioner.partition()
         except Exception, e:
             print >> sys.stderr, 'Could not partition mesh'
@@ -65,6 +65,11 @@ class Args:
             help='do not reorder the mesh using Zoltan')
         parser.add_argument('-t', '--tmp', type=writableDir, default=None,
             help='tmp directory that should be used instead of the default', metavar='DIR')
+        parser.add_argument('-w', '--weights', default=None,
+            help='prefix of the partition weights written by SeisSol (SEISSOL_PARTITION_WEIGHTS)',
+            metavar='PREFIX')
+        parser.add_argument('--weights-partition', type=argparse.FileType('rU'), default=None,
+            help='partition file of the run that wrote the weights', metavar='FILE')
         parser.add_argument('-v', '--version', action='version', version='%(prog)s 0.1')
         
         try:
@@ -73,6 +78,9 @@ class Args:
         except IOError, e:
             parser.error(str(e))
             
+        if self.__options.weights and not self.__options.weights_partition:
+            parser.error('--weights requires --weights-partition')
+            
     def inputFile(self):
         return self.__options.input
     
@@ -87,3 +95,9 @@ class Args:
     
     def tmpDir(self):
         return self.__options.tmp
+    
+    def weights(self):
+        return self.__options.weights
+    
+    def weightsPartition(self):
+        return self.__options.weights_partition
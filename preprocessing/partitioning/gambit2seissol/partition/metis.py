@@ -51,6 +51,74 @@ class MeshWriter:
             
         file.close()
         
+class WeightReader:
+    """Reads the per-rank partition weights written by SeisSol
+    (SEISSOL_PARTITION_WEIGHTS) and converts them to the global element order
+    using the partition of the run"""
+    
+    def __init__(self, prefix, partition):
+        if isinstance(partition, basestring):
+            partition = open(partition, 'rU')
+        partition = [int(line) for line in partition]
+        
+        # Read the weights of all ranks
+        rankWeights = []
+        self.__constraints = 0
+        for rank in range(max(partition)+1):
+            file = open(prefix+'.'+str(rank), 'rU')
+            
+            size, constraints = map(int, file.readline().split())
+            if rank == 0:
+                self.__constraints = constraints
+            elif constraints != self.__constraints:
+                raise Exception('Number of constraints in '+prefix+'.'+str(rank)+' does not match')
+            
+            weights = [line.split() for line in file]
+            if len(weights) != size:
+                raise Exception('Number of weights in '+prefix+'.'+str(rank)+' does not match its header')
+            rankWeights.append(weights)
+            
+            file.close()
+        
+        # Elements are stored in global order on each rank
+        self.__weights = []
+        offsets = [0] * len(rankWeights)
+        for p in partition:
+            self.__weights.append(rankWeights[p][offsets[p]])
+            offsets[p] += 1
+            
+        for p in range(len(rankWeights)):
+            if offsets[p] != len(rankWeights[p]):
+                raise Exception('Partition does not match the weights of rank '+str(p))
+            
+    def constraints(self):
+        return self.__constraints
+    
+    def __len__(self):
+        return len(self.__weights)
+    
+    def __getitem__(self, key):
+        return self.__weights[key]
+        
+class GraphWeighter:
+    """Adds vertex weights to a graph in metis format"""
+    
+    def __init__(self, graph, weights):
+        lines = [line for line in open(graph, 'rU') if not line.startswith('%')]
+        
+        header = lines[0].split()
+        if len(header) > 2:
+            raise Exception('Graph '+graph+' already contains weights')
+        if int(header[0]) != len(weights):
+            raise Exception('Graph size and number of weights do not match: graph size = '
+                +header[0]+' != number of weights = '+str(len(weights)))
+        
+        file = open(graph, 'w')
+        print >> file, header[0], header[1], '010', weights.constraints()
+        for i, line in enumerate(lines[1:]):
+            print >> file, ' '.join(weights[i]), line.strip()
+        file.close()
+        
 class PartitionReader(collections.Iterable):
     """Reads a metis partition file"""
     
@@ -45,7 +45,7 @@ METIS_GRAPH = 'metis.graph'
 class Partitioner:
     """Converts a mesh into graph and partitions it using metis"""
     
-    def __init__(self, mesh, partitions, tmpdir):
+    def __init__(self, mesh, partitions, tmpdir, weights = None):
         metisMesh = tmpdir.path(METIS_MESH)
         
         # Write metis mesh
@@ -59,6 +59,10 @@ class Partitioner:
         if p.returncode:
             raise Exception(errmsg.strip())
         
+        # Add vertex weights (multi-constraint)
+        if weights is not None:
+            metis.GraphWeighter(metisGraph, weights)
+        
         # Run metis
         p = subprocess.Popen(['gpmetis', '-ptype=rb', metisGraph, str(partitions)],
             stdout=subprocess.PIPE, stderr=subprocess.PIPE)
@@ -94,6 +94,9 @@ private:
 	/** Was the checkpoint loaded */
 	bool m_loaded;
 
+	/** Number of bytes written by this rank since the last call to takeBytesWritten() */
+	unsigned long m_bytesWritten;
+
 public:
 	CheckPoint()
 		: m_rank(0), m_partitions(1), // default for no MPI
@@ -102,7 +105,8 @@ public:
 #endif // USE_MPI
 		  m_odd(0), // Start with even checkpoint
 		  m_numTotalElems(0), m_fileOffset(0),
-		  m_loaded(false)
+		  m_loaded(false),
+		  m_bytesWritten(0)
 	{}
 
 	virtual ~CheckPoint() {}
@@ -158,7 +162,27 @@ public:
 	 */
 	virtual void close() = 0;
 
+	/**
+	 * @return The number of bytes written by this rank since the last call
+	 */
+	unsigned long takeBytesWritten()
+	{
+		unsigned long bytes = m_bytesWritten;
+		m_bytesWritten = 0;
+		return bytes;
+	}
+
 protected:
+	/**
+	 * Should be called by the backends for all data written to the file
+	 *
+	 * @param bytes Number of bytes written
+	 */
+	void addBytesWritten(unsigned long bytes)
+	{
+		m_bytesWritten += bytes;
+	}
+
 	/**
 	 * Initializes file names and link file name
 	 *
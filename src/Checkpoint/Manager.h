@@ -45,9 +45,11 @@
 #include <mpi.h>
 #endif // USE_MPI
 
+#include "Telemetry.h"
 #include "Wavefield.h"
 #include "Fault.h"
 #include "posix/Wavefield.h"
+#include "posix/WavefieldAsync.h"
 #include "h5/Wavefield.h"
 #include "h5/Fault.h"
 #include "mpio/Wavefield.h"
@@ -64,6 +66,7 @@ namespace checkpoint
 /** Checkpoint backend types */
 enum Backend {
 	POSIX,
+	POSIX_ASYNC,
 	HDF5,
 	MPIO,
 	MPIO_ASYNC,
@@ -79,9 +82,30 @@ private:
 	/** The dynamic rupture checkpoint */
 	Fault *m_fault;
 
+	/** True if the backend writes asynchronously */
+	bool m_async;
+
+	/** Bandwidth and latency statistics */
+	Telemetry m_telemetry;
+
+	/** True if an asynchronous checkpoint is in progress */
+	bool m_pending;
+
+	/** Simulation time of the pending checkpoint */
+	double m_pendingTime;
+
+	/** Wall time when the pending checkpoint was started */
+	double m_pendingStart;
+
+	/** Time the solver was blocked while starting the pending checkpoint */
+	double m_pendingBlocked;
+
 public:
 	Manager()
-		: m_waveField(0L), m_fault(0L)
+		: m_waveField(0L), m_fault(0L),
+		  m_async(false),
+		  m_pending(false), m_pendingTime(0),
+		  m_pendingStart(0), m_pendingBlocked(0)
 	{
 	}
 
@@ -100,18 +124,29 @@ public:
 		case POSIX:
 			m_waveField = new posix::Wavefield();
 			m_fault = new mpio::Fault();
+			m_telemetry.init("posix");
+			break;
+		case POSIX_ASYNC:
+			m_waveField = new posix::WavefieldAsync();
+			m_fault = new mpio::FaultAsync();
+			m_async = true;
+			m_telemetry.init("posix_async");
 			break;
 		case HDF5:
 			m_waveField = new h5::Wavefield();
 			m_fault = new h5::Fault();
+			m_telemetry.init("hdf5");
 			break;
 		case MPIO:
 			m_waveField = new mpio::Wavefield();
 			m_fault = new mpio::Fault();
+			m_telemetry.init("mpio");
 			break;
 		case MPIO_ASYNC:
 			m_waveField = new mpio::WavefieldAsync();
 			m_fault = new mpio::FaultAsync();
+			m_async = true;
+			m_telemetry.init("mpio_async");
 			break;
 		default:
 			logError() << "Unsupported checkpoint backend";
@@ -132,6 +167,20 @@ public:
 		m_fault->setFilename(filename);
 	}
 
+	/**
+	 * Provides the global element ids of the cells in the DOF array
+	 * (must be called before init)
+	 *
+	 * @see Wavefield::setGlobalIds
+	 */
+	void setGlobalIds(const int* globalIds, const unsigned int* sourceCells)
+	{
+		if (!m_waveField)
+			return;
+
+		m_waveField->setGlobalIds(globalIds, sourceCells);
+	}
+
 	/**
 	 * Initialize checkpointing and load the last checkpoint if present
 	 *
@@ -179,16 +228,72 @@ public:
 		if (!m_waveField)
 			return;
 
+		double start = Telemetry::wallTime();
+
 		m_waveField->write(time, waveFieldTimeStep);
 		m_fault->write(faultTimeStep);
 
+		double finished = Telemetry::wallTime();
+
 		// Update both links at the "same" time
 		m_waveField->updateLink();
 		m_fault->updateLink();
 
+		// Asynchronous backends finalize the previous checkpoint
+		// (the solver is also blocked while preparing DOF updates)
+		if (!m_async)
+			m_telemetry.report(time, takeBytesWritten(), finished - start, finished - start);
+		else if (m_pending)
+			m_telemetry.report(m_pendingTime, takeBytesWritten(),
+				finished - m_pendingStart,
+				m_pendingBlocked + m_waveField->takeBlockedTime() + finished - start);
+
 		// Prepare next checkpoint (only for async checkpoints)
+		double prepareStart = Telemetry::wallTime();
+
 		m_waveField->writePrepare(time, waveFieldTimeStep);
 		m_fault->writePrepare(faultTimeStep);
+
+		if (m_async) {
+			m_pending = true;
+			m_pendingTime = time;
+			m_pendingStart = prepareStart;
+			m_pendingBlocked = Telemetry::wallTime() - prepareStart;
+		}
+	}
+
+	/**
+	 * @return The bandwidth and latency statistics of the checkpoints
+	 */
+	const Telemetry& telemetry() const
+	{
+		return m_telemetry;
+	}
+
+	/**
+	 * Must be called before the solver modifies a range of the DOFs
+	 * (required for asynchronous checkpoints)
+	 *
+	 * @param dofs Pointer to the first modified DOF
+	 * @param numDofs Number of DOFs that will be modified
+	 */
+	void prepareUpdate(const real* dofs, unsigned int numDofs)
+	{
+		if (!m_waveField)
+			return;
+
+		m_waveField->prepareUpdate(dofs, numDofs);
+	}
+
+	/**
+	 * Must be called before the solver modifies arbitrary DOFs
+	 */
+	void prepareUpdateAll()
+	{
+		if (!m_waveField)
+			return;
+
+		m_waveField->prepareUpdateAll();
 	}
 
 	/**
@@ -199,8 +304,28 @@ public:
 		if (!m_waveField)
 			return;
 
+		double start = Telemetry::wallTime();
+
+		// Finalizes pending asynchronous checkpoints
 		m_waveField->close();
 		m_fault->close();
+
+		if (m_pending) {
+			double finished = Telemetry::wallTime();
+			m_telemetry.report(m_pendingTime, takeBytesWritten(),
+				finished - m_pendingStart,
+				m_pendingBlocked + m_waveField->takeBlockedTime() + finished - start);
+			m_pending = false;
+		}
+	}
+
+private:
+	/**
+	 * @return Bytes written by this rank since the last call
+	 */
+	unsigned long takeBytesWritten()
+	{
+		return m_waveField->takeBytesWritten() + m_fault->takeBytesWritten();
 	}
 };
 
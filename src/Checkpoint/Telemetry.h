@@ -0,0 +1,200 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (sebastian.rettenberger AT tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Bandwidth and latency statistics of the checkpoints
+ */
+
+#ifndef CHECKPOINT_TELEMETRY_H
+#define CHECKPOINT_TELEMETRY_H
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif // USE_MPI
+
+#include <cstdio>
+#include <string>
+
+#include "utils/env.h"
+#include "utils/logger.h"
+
+#include "Monitoring/PhaseStatistics.hpp"
+
+namespace seissol
+{
+
+namespace checkpoint
+{
+
+/**
+ * Collects the bandwidth and latency of each checkpoint.
+ *
+ * For every checkpoint, a summary is printed. If SEISSOL_CHECKPOINT_TELEMETRY
+ * is set, rank 0 additionally appends one JSON record per checkpoint to this file.
+ */
+class Telemetry
+{
+private:
+	/** The rank of the process */
+	int m_rank;
+
+	/** Total number of ranks */
+	int m_partitions;
+
+	/** Name of the backend */
+	std::string m_backend;
+
+	/** File for the machine-readable records (empty if disabled) */
+	std::string m_recordFile;
+
+	/** Number of checkpoints reported */
+	unsigned int m_numCheckpoints;
+
+	/** Maximum time (over all ranks) the solver was blocked by the last checkpoint */
+	double m_lastBlocked;
+
+	/** Maximum time (over all ranks) required for the last checkpoint */
+	double m_lastElapsed;
+
+public:
+	Telemetry()
+		: m_rank(0), m_partitions(1),
+		  m_numCheckpoints(0),
+		  m_lastBlocked(0), m_lastElapsed(0)
+	{
+	}
+
+	/**
+	 * @param backend Name of the backend (used in the records)
+	 */
+	void init(const char* backend)
+	{
+#ifdef USE_MPI
+		MPI_Comm_rank(MPI_COMM_WORLD, &m_rank);
+		MPI_Comm_size(MPI_COMM_WORLD, &m_partitions);
+#endif // USE_MPI
+
+		m_backend = backend;
+		m_recordFile = utils::Env::get<const char*>("SEISSOL_CHECKPOINT_TELEMETRY", "");
+	}
+
+	/**
+	 * Reports a finished checkpoint. Has to be called by all ranks.
+	 *
+	 * @param time The simulation time of the checkpoint
+	 * @param bytes Number of bytes written by this rank
+	 * @param elapsed Time from the start until the checkpoint was finalized
+	 * @param blocked Time the solver was blocked by the checkpoint
+	 *  (equal to <code>elapsed</code> for synchronous backends)
+	 */
+	void report(double time, unsigned long bytes, double elapsed, double blocked)
+	{
+		double bandwidth = (elapsed > 0 ? bytes / elapsed * 1e-9 : 0);
+
+		// 0: bytes, 1: elapsed, 2: blocked, 3: overlapped, 4: per rank GB/s
+		double local[5] = {static_cast<double>(bytes), elapsed, blocked, elapsed - blocked, bandwidth};
+		double sum[5] = {local[0], local[1], local[2], local[3], local[4]};
+		double maximum[5] = {local[0], local[1], local[2], local[3], local[4]};
+		double minimum = bandwidth;
+#ifdef USE_MPI
+		MPI_Allreduce(local, sum, 5, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(local, maximum, 5, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+		MPI_Allreduce(&bandwidth, &minimum, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif // USE_MPI
+
+		m_lastElapsed = maximum[1];
+		m_lastBlocked = maximum[2];
+		m_numCheckpoints++;
+
+		const double gigaBytes = sum[0] * 1e-9;
+		const double aggregated = (maximum[1] > 0 ? gigaBytes / maximum[1] : 0);
+
+		logInfo(m_rank) << "Check point" << m_numCheckpoints << "(time" << time << "):"
+			<< gigaBytes << "GB in" << maximum[1] << "s," << aggregated << "GB/s";
+		logInfo(m_rank) << "Check point per rank GB/s (min/avg/max):"
+			<< minimum << sum[4] / m_partitions << maximum[4]
+			<< "blocked [s] (avg/max):" << sum[2] / m_partitions << maximum[2]
+			<< "overlapped [s] (avg/max):" << sum[3] / m_partitions << maximum[3];
+
+		if (m_rank != 0 || m_recordFile.empty())
+			return;
+
+		FILE* f = fopen(m_recordFile.c_str(), "a");
+		if (!f) {
+			logWarning() << "Could not open checkpoint telemetry file" << m_recordFile;
+			return;
+		}
+		fprintf(f, "{\"checkpoint\":%u,\"backend\":\"%s\",\"time\":%.10g,\"ranks\":%d,"
+				"\"bytes\":%.0f,\"elapsed\":%g,\"bandwidth\":%g,"
+				"\"rank_bandwidth\":[%g,%g,%g],\"blocked\":[%g,%g],\"overlapped\":[%g,%g]}\n",
+				m_numCheckpoints, m_backend.c_str(), time, m_partitions,
+				sum[0], maximum[1], aggregated,
+				minimum, sum[4] / m_partitions, maximum[4],
+				sum[2] / m_partitions, maximum[2],
+				sum[3] / m_partitions, maximum[3]);
+		fclose(f);
+	}
+
+	/**
+	 * @return Maximum time the solver was blocked by the last checkpoint
+	 */
+	double lastBlocked() const
+	{
+		return m_lastBlocked;
+	}
+
+	/**
+	 * @return Maximum time required for the last checkpoint
+	 */
+	double lastElapsed() const
+	{
+		return m_lastElapsed;
+	}
+
+	/**
+	 * @return The wall clock time in seconds
+	 */
+	static double wallTime()
+	{
+		return seissol::monitoring::getWallTime();
+	}
+};
+
+}
+
+}
+
+#endif // CHECKPOINT_TELEMETRY_H
@@ -41,6 +41,9 @@
 #ifndef CHECKPOINT_WAVEFIELD_H
 #define CHECKPOINT_WAVEFIELD_H
 
+#include <algorithm>
+#include <cstring>
+
 #include "utils/env.h"
 #include "utils/logger.h"
 
@@ -76,11 +79,30 @@ private:
 	/** Number of cells that can be saved in one iteration (due to the 2GB limit) */
 	const unsigned int m_dofsPerIteration;
 
+	/** Global element id of each cell in the DOF array (only valid during init) */
+	const int* m_globalIds;
+
+	/** The cell that holds the data of each cell in the DOF array (only valid during init) */
+	const unsigned int* m_sourceCells;
+
+	/** True if the global element ids were provided */
+	bool m_hasGlobalIds;
+
+	/** True if the alignment padding of the DOFs is not stored in the file */
+	bool m_packed;
+
+	/** Time the solver was blocked in prepareUpdate since the last call to takeBlockedTime() */
+	double m_blockedTime;
+
 public:
 	Wavefield()
 		: m_dofs(0L), m_numDofs(0),
 		  m_iterations(0), m_totalIterations(0),
-		  m_dofsPerIteration((1ul<<30) / sizeof(real))
+		  m_dofsPerIteration((1ul<<30) / sizeof(real)),
+		  m_globalIds(0L), m_sourceCells(0L),
+		  m_hasGlobalIds(false),
+		  m_packed(false),
+		  m_blockedTime(0)
 	{}
 
 	virtual ~Wavefield() {}
@@ -123,16 +145,29 @@ public:
 		// Compute total number of cells and local offset
 		setSumOffset(numDofsFile);
 
-		// Work around 2 GB limit in MPI-IO
-		m_iterations = (numDofs + m_dofsPerIteration - 1) / m_dofsPerIteration;
-		m_totalIterations = m_iterations;
-#ifdef USE_MPI
-		MPI_Allreduce(MPI_IN_PLACE, &m_totalIterations, 1, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD);
-#endif // USE_MPI
+		initIterations(numDofs);
 
 		return false;
 	}
 
+	/**
+	 * Provides the global element ids of the cells in the DOF array.
+	 * Backends that support it store the checkpoint in global element order,
+	 * which allows restarts with a different number of ranks.
+	 *
+	 * Has to be called before init(). The arrays must remain valid until init() returns.
+	 *
+	 * @param globalIds The global element id of each cell
+	 * @param sourceCells The cell that holds the data of each cell
+	 *  (cells can be duplicated in the DOF array)
+	 */
+	void setGlobalIds(const int* globalIds, const unsigned int* sourceCells)
+	{
+		m_globalIds = globalIds;
+		m_sourceCells = sourceCells;
+		m_hasGlobalIds = true;
+	}
+
 	/**
 	 * Load a checkpoint file. Should only be done if init() returned true.
 	 *
@@ -154,6 +189,38 @@ public:
 	{
 	}
 
+	/**
+	 * Called before the solver modifies a range of the DOFs
+	 *
+	 * Overwrite this function if a checkpoint is written asynchronously
+	 * from the DOF array.
+	 *
+	 * @param dofs Pointer to the first modified DOF
+	 * @param numDofs Number of DOFs that will be modified
+	 */
+	virtual void prepareUpdate(const real* dofs, unsigned int numDofs)
+	{
+	}
+
+	/**
+	 * Called before the solver modifies arbitrary DOFs
+	 */
+	void prepareUpdateAll()
+	{
+		prepareUpdate(m_dofs, m_numDofs);
+	}
+
+	/**
+	 * @return The time the solver was blocked in {@link prepareUpdate}
+	 *  since the last call
+	 */
+	double takeBlockedTime()
+	{
+		double blocked = m_blockedTime;
+		m_blockedTime = 0;
+		return blocked;
+	}
+
 	/**
 	 * Write a checkpoint for the current time
 	 *
@@ -192,6 +259,105 @@ protected:
 	{
 		return m_dofsPerIteration;
 	}
+
+	/**
+	 * Computes the number of iterations required to read/write the local part of the file
+	 *
+	 * @param numDofs Number of DOFs in the local part of the file
+	 */
+	void initIterations(unsigned int numDofs)
+	{
+		// Work around 2 GB limit in MPI-IO
+		m_iterations = std::max((numDofs + m_dofsPerIteration - 1) / m_dofsPerIteration, 1u);
+		m_totalIterations = m_iterations;
+#ifdef USE_MPI
+		MPI_Allreduce(MPI_IN_PLACE, &m_totalIterations, 1, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD);
+#endif // USE_MPI
+	}
+
+	bool hasGlobalIds() const
+	{
+		return m_hasGlobalIds;
+	}
+
+	/**
+	 * Should be called by asynchronous backends for the time spent
+	 * in {@link prepareUpdate} (waiting and copying)
+	 */
+	void addBlockedTime(double blocked)
+	{
+		m_blockedTime += blocked;
+	}
+
+	const int* globalIds() const
+	{
+		return m_globalIds;
+	}
+
+	const unsigned int* sourceCells() const
+	{
+		return m_sourceCells;
+	}
+
+	/**
+	 * Reads the packing option. Should be called by backends that support
+	 * files without the alignment padding.
+	 */
+	void initPacking()
+	{
+		m_packed = utils::Env::get<int>("SEISSOL_CHECKPOINT_PACKED", 0) != 0;
+		if (m_packed)
+			logInfo(rank()) << "Storing checkpoints without alignment padding";
+	}
+
+	bool packed() const
+	{
+		return m_packed;
+	}
+
+	/**
+	 * @return The number of DOFs of one cell in the file
+	 */
+	unsigned int fileDofsPerCell() const
+	{
+		return (m_packed ? NUMBER_OF_DOFS : NUMBER_OF_ALIGNED_DOFS);
+	}
+
+	/**
+	 * Copies cells from the DOF layout to the file layout
+	 */
+	void packCells(const real* dofs, real* fileData, unsigned int numCells) const
+	{
+		if (!m_packed) {
+			memcpy(fileData, dofs, numCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+			return;
+		}
+
+		for (unsigned int i = 0; i < numCells * NUMBER_OF_QUANTITIES; i++)
+			memcpy(&fileData[i * NUMBER_OF_BASIS_FUNCTIONS],
+					&dofs[i * NUMBER_OF_ALIGNED_BASIS_FUNCTIONS],
+					NUMBER_OF_BASIS_FUNCTIONS * sizeof(real));
+	}
+
+	/**
+	 * Copies cells from the file layout to the DOF layout
+	 */
+	void unpackCells(const real* fileData, real* dofs, unsigned int numCells) const
+	{
+		if (!m_packed) {
+			memcpy(dofs, fileData, numCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+			return;
+		}
+
+		for (unsigned int i = 0; i < numCells * NUMBER_OF_QUANTITIES; i++) {
+			memcpy(&dofs[i * NUMBER_OF_ALIGNED_BASIS_FUNCTIONS],
+					&fileData[i * NUMBER_OF_BASIS_FUNCTIONS],
+					NUMBER_OF_BASIS_FUNCTIONS * sizeof(real));
+			// The padding is not stored
+			memset(&dofs[i * NUMBER_OF_ALIGNED_BASIS_FUNCTIONS + NUMBER_OF_BASIS_FUNCTIONS], 0,
+					(NUMBER_OF_ALIGNED_BASIS_FUNCTIONS - NUMBER_OF_BASIS_FUNCTIONS) * sizeof(real));
+		}
+	}
 };
 
 }
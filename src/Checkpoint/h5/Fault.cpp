@@ -142,6 +142,7 @@ void seissol::checkpoint::h5::Fault::write(int timestepFault)
 		checkH5Err(H5Dwrite(m_h5data[odd()][i], H5T_NATIVE_DOUBLE, h5memSpace, m_h5fSpaceData,
 				h5XferList(), data(i)));
 	}
+	addBytesWritten(numSides() * numBndGP() * NUM_VARIABLES * sizeof(double));
 
 	checkH5Err(H5Sclose(h5memSpace));
 
@@ -159,6 +160,21 @@ bool seissol::checkpoint::h5::Fault::validate(hid_t h5file) const
 	// Turn of error printing
 	H5ErrHandler errHandler;
 
+	// Fault checkpoints are stored in rank order
+	// (the wave field can be restarted with a different number of ranks)
+	if (numTotalElems() > 0) {
+		hid_t h5attr = H5Aopen(h5file, "partitions", H5P_DEFAULT);
+		if (h5attr >= 0) {
+			int p;
+			herr_t err = H5Aread(h5attr, H5T_NATIVE_INT, &p);
+			checkH5Err(H5Aclose(h5attr));
+			if (err < 0 || p != partitions()) {
+				logWarning(rank()) << "Restarting dynamic rupture with a different number of partitions is not supported.";
+				return false;
+			}
+		}
+	}
+
 	// Check dimensions
 	for (unsigned int i = 0; i < NUM_VARIABLES; i++) {
 		hid_t h5data = H5Dopen(h5file, VAR_NAMES[i], H5P_DEFAULT);
@@ -249,6 +265,14 @@ hid_t seissol::checkpoint::h5::Fault::initFile(int odd, const char* filename)
 		int t = 0;
 		checkH5Err(H5Awrite(m_h5timestepFault[odd], H5T_NATIVE_INT, &t));
 
+		// Partitions
+		hid_t h5partitions = H5Acreate(h5file, "partitions", H5T_STD_I32LE, h5spaceScalar,
+				H5P_DEFAULT, H5P_DEFAULT);
+		checkH5Err(h5partitions);
+		int p = partitions();
+		checkH5Err(H5Awrite(h5partitions, H5T_NATIVE_INT, &p));
+		checkH5Err(H5Aclose(h5partitions));
+
 		checkH5Err(H5Sclose(h5spaceScalar));
 
 		// Variables
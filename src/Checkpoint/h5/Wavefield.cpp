@@ -39,7 +39,9 @@
 
 #include "Wavefield.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include "utils/env.h"
 #include "utils/mathutils.h"
@@ -49,6 +51,31 @@ bool seissol::checkpoint::h5::Wavefield::init(real* dofs, unsigned int numDofs)
 {
 	seissol::checkpoint::Wavefield::init(dofs, numDofs);
 
+	initPacking();
+	m_numFileDofs = numDofs / NUMBER_OF_ALIGNED_DOFS * fileDofsPerCell();
+
+	m_compression = utils::Env::get<int>("SEISSOL_CHECKPOINT_COMPRESSION", 0);
+	if (m_compression < 0 || m_compression > 9) {
+		logWarning(rank()) << "Invalid checkpoint compression level" << m_compression << ", disabling compression";
+		m_compression = 0;
+	}
+	if (m_compression > 0)
+		logInfo(rank()) << "Compressing checkpoints with deflate level" << m_compression;
+
+	// Use the global element order if all ranks know the global ids
+	int globalOrder = hasGlobalIds();
+#ifdef USE_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &globalOrder, 1, MPI_INT, MPI_LAND, comm());
+#endif // USE_MPI
+	m_globalOrder = globalOrder;
+	if (m_globalOrder) {
+		initGlobalOrder();
+	} else if (packed()) {
+		// Update the size of the local part of the file
+		setSumOffset(m_numFileDofs);
+		initIterations(m_numFileDofs);
+	}
+
 	// Data space for the file
 	hsize_t fileSize = numTotalElems();
 	m_h5fSpaceData = H5Screate_simple(1, &fileSize, 0L);
@@ -86,36 +113,19 @@ void seissol::checkpoint::h5::Wavefield::load(double &time, int &timestepWavefie
 	checkH5Err(h5fSpace);
 
 	// Read the data
-	unsigned int offset = 0;
-	hsize_t fStart = fileOffset();
-	hsize_t count = dofsPerIteration();
-	hid_t h5memSpace = H5Screate_simple(1, &count, 0L);
-	checkH5Err(h5memSpace);
-	checkH5Err(H5Sselect_all(h5memSpace));
-	for (unsigned int i = 0; i < totalIterations()-1; i++) {
-		checkH5Err(H5Sselect_hyperslab(h5fSpace, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
-
-		checkH5Err(H5Dread(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
-				h5XferList(), &dofs()[offset]));
-
-		// We are finished in less iterations, read data twice
-		// so everybody needs the same number of iterations
-		if (i < iterations()-1) {
-			fStart += count;
-			offset += count;
-		}
+	if (m_globalOrder) {
+		real* fileData = new real[m_numFileDofs];
+		readWriteData(false, h5data, h5fSpace, fileData);
+		redistribute(false, fileData);
+		delete [] fileData;
+	} else if (packed()) {
+		real* fileData = new real[m_numFileDofs];
+		readWriteData(false, h5data, h5fSpace, fileData);
+		unpackCells(fileData, dofs(), numDofs() / NUMBER_OF_ALIGNED_DOFS);
+		delete [] fileData;
+	} else {
+		readWriteData(false, h5data, h5fSpace, dofs());
 	}
-	checkH5Err(H5Sclose(h5memSpace));
-
-	// Read reminding data in the last iteration
-	count = numDofs() - (iterations() - 1) * count;
-	h5memSpace = H5Screate_simple(1, &count, 0L);
-	checkH5Err(h5memSpace);
-	checkH5Err(H5Sselect_all(h5memSpace));
-	checkH5Err(H5Sselect_hyperslab(h5fSpace, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
-	checkH5Err(H5Dread(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
-			h5XferList(), &dofs()[offset]));
-	checkH5Err(H5Sclose(h5memSpace));
 
 	checkH5Err(H5Sclose(h5fSpace));
 	checkH5Err(H5Dclose(h5data));
@@ -150,36 +160,22 @@ void seissol::checkpoint::h5::Wavefield::write(double time, int waveFieldTimeSte
 	SCOREP_USER_REGION_BEGIN(r_write_wavefield, "checkpoint_write_wavefield", SCOREP_USER_REGION_TYPE_COMMON);
 
 	// Write the wave field
-	unsigned int offset = 0;
-	hsize_t fStart = fileOffset();
-	hsize_t count = dofsPerIteration();
-	hid_t h5memSpace = H5Screate_simple(1, &count, 0L);
-	checkH5Err(h5memSpace);
-	checkH5Err(H5Sselect_all(h5memSpace));
-	for (unsigned int i = 0; i < totalIterations()-1; i++) {
-		checkH5Err(H5Sselect_hyperslab(m_h5fSpaceData, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
-
-		checkH5Err(H5Dwrite(m_h5data[odd()], H5T_NATIVE_DOUBLE, h5memSpace, m_h5fSpaceData,
-				h5XferList(), &dofs()[offset]));
-
-		// We are finished in less iterations, read data twice
-		// so everybody needs the same number of iterations
-		if (i < iterations()-1) {
-			fStart += count;
-			offset += count;
-		}
+	if (m_globalOrder) {
+		real* fileData = new real[m_numFileDofs];
+		redistribute(true, fileData);
+		readWriteData(true, m_h5data[odd()], m_h5fSpaceData, fileData);
+		delete [] fileData;
+	} else if (packed()) {
+		real* fileData = new real[m_numFileDofs];
+		packCells(dofs(), fileData, numDofs() / NUMBER_OF_ALIGNED_DOFS);
+		readWriteData(true, m_h5data[odd()], m_h5fSpaceData, fileData);
+		delete [] fileData;
+	} else {
+		readWriteData(true, m_h5data[odd()], m_h5fSpaceData, dofs());
 	}
-	checkH5Err(H5Sclose(h5memSpace));
 
-	// Save reminding data in the last iteration
-	count = numDofs() - (iterations() - 1) * count;
-	h5memSpace = H5Screate_simple(1, &count, 0L);
-	checkH5Err(h5memSpace);
-	checkH5Err(H5Sselect_all(h5memSpace));
-	checkH5Err(H5Sselect_hyperslab(m_h5fSpaceData, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
-	checkH5Err(H5Dwrite(m_h5data[odd()], H5T_NATIVE_DOUBLE, h5memSpace, m_h5fSpaceData,
-			h5XferList(), &dofs()[offset]));
-	checkH5Err(H5Sclose(h5memSpace));
+	// Size before compression
+	addBytesWritten(m_numFileDofs * sizeof(real));
 
 	EPIK_USER_END(r_write_wavefield);
 	SCOREP_USER_REGION_END(r_write_wavefield);
@@ -195,21 +191,55 @@ bool seissol::checkpoint::h5::Wavefield::validate(hid_t h5file) const
 	// Turn of error printing
 	H5ErrHandler errHandler;
 
-	// Check #partitions
-	hid_t h5attr = H5Aopen(h5file, "partitions", H5P_DEFAULT);
-	if (h5attr < 0) {
-		logWarning(rank()) << "Checkpoint does not have a partition attribute.";
+	// Check the element order (checkpoints without this attribute use the rank order)
+	int globalOrder = 0;
+	hid_t h5attr = H5Aopen(h5file, "global_order", H5P_DEFAULT);
+	if (h5attr >= 0) {
+		herr_t err = H5Aread(h5attr, H5T_NATIVE_INT, &globalOrder);
+		checkH5Err(H5Aclose(h5attr));
+		if (err < 0) {
+			logWarning(rank()) << "Could not read the element order of the checkpoint.";
+			return false;
+		}
+	}
+	if (globalOrder != m_globalOrder) {
+		logWarning(rank()) << "Element order in checkpoint does not match.";
 		return false;
 	}
 
-	int p;
-	herr_t err = H5Aread(h5attr, H5T_NATIVE_INT, &p);
-	checkH5Err(H5Aclose(h5attr));
-	if (err < 0 || p != partitions()) {
-		logWarning(rank()) << "Partitions in checkpoint do not match.";
+	// Check the alignment padding (checkpoints without this attribute contain the padding)
+	int packedFile = 0;
+	h5attr = H5Aopen(h5file, "packed", H5P_DEFAULT);
+	if (h5attr >= 0) {
+		herr_t err = H5Aread(h5attr, H5T_NATIVE_INT, &packedFile);
+		checkH5Err(H5Aclose(h5attr));
+		if (err < 0) {
+			logWarning(rank()) << "Could not read the padding information of the checkpoint.";
+			return false;
+		}
+	}
+	if (packedFile != packed()) {
+		logWarning(rank()) << "Alignment padding in checkpoint does not match.";
 		return false;
 	}
 
+	// Check #partitions (not required for the global order)
+	if (!m_globalOrder) {
+		h5attr = H5Aopen(h5file, "partitions", H5P_DEFAULT);
+		if (h5attr < 0) {
+			logWarning(rank()) << "Checkpoint does not have a partition attribute.";
+			return false;
+		}
+
+		int p;
+		herr_t err = H5Aread(h5attr, H5T_NATIVE_INT, &p);
+		checkH5Err(H5Aclose(h5attr));
+		if (err < 0 || p != partitions()) {
+			logWarning(rank()) << "Partitions in checkpoint do not match.";
+			return false;
+		}
+	}
+
 	// Check dimensions
 	hid_t h5data = H5Dopen(h5file, "values", H5P_DEFAULT);
 	if (h5data < 0) {
@@ -300,6 +330,22 @@ hid_t seissol::checkpoint::h5::Wavefield::initFile(int odd, const char* filename
 		checkH5Err(H5Awrite(h5partitions, H5T_NATIVE_INT, &p));
 		checkH5Err(H5Aclose(h5partitions));
 
+		// Element order
+		hid_t h5globalOrder = H5Acreate(h5file, "global_order", H5T_STD_I32LE, h5spaceScalar,
+				H5P_DEFAULT, H5P_DEFAULT);
+		checkH5Err(h5globalOrder);
+		int globalOrder = m_globalOrder;
+		checkH5Err(H5Awrite(h5globalOrder, H5T_NATIVE_INT, &globalOrder));
+		checkH5Err(H5Aclose(h5globalOrder));
+
+		// Alignment padding
+		hid_t h5packed = H5Acreate(h5file, "packed", H5T_STD_I32LE, h5spaceScalar,
+				H5P_DEFAULT, H5P_DEFAULT);
+		checkH5Err(h5packed);
+		int packedFile = packed();
+		checkH5Err(H5Awrite(h5packed, H5T_NATIVE_INT, &packedFile));
+		checkH5Err(H5Aclose(h5packed));
+
 		// Wavefield writer
 		m_h5timestepWavefield[odd] = H5Acreate(h5file, "timestep_wavefield",
 				H5T_STD_I32LE, h5spaceScalar, H5P_DEFAULT, H5P_DEFAULT);
@@ -312,7 +358,18 @@ hid_t seissol::checkpoint::h5::Wavefield::initFile(int odd, const char* filename
 		// Variable
 		h5plist = H5Pcreate(H5P_DATASET_CREATE);
 		checkH5Err(h5plist);
-		checkH5Err(H5Pset_layout(h5plist, H5D_CONTIGUOUS));
+		if (m_compression > 0 && numTotalElems() > 0) {
+			// Filters require a chunked layout, chunks contain complete cells
+			hsize_t chunkSize = utils::Env::get<hsize_t>("SEISSOL_CHECKPOINT_CHUNK_SIZE", 1ul << 22)
+				/ (fileDofsPerCell() * sizeof(real));
+			chunkSize = std::max(chunkSize, static_cast<hsize_t>(1)) * fileDofsPerCell();
+			chunkSize = std::min(chunkSize, static_cast<hsize_t>(numTotalElems()));
+			checkH5Err(H5Pset_chunk(h5plist, 1, &chunkSize));
+			checkH5Err(H5Pset_shuffle(h5plist));
+			checkH5Err(H5Pset_deflate(h5plist, m_compression));
+		} else {
+			checkH5Err(H5Pset_layout(h5plist, H5D_CONTIGUOUS));
+		}
 		checkH5Err(H5Pset_alloc_time(h5plist, H5D_ALLOC_TIME_EARLY));
 		m_h5data[odd] = H5Dcreate(h5file, "values", H5T_IEEE_F64LE, m_h5fSpaceData,
 				H5P_DEFAULT, h5plist, H5P_DEFAULT);
@@ -322,3 +379,181 @@ hid_t seissol::checkpoint::h5::Wavefield::initFile(int odd, const char* filename
 
 	return h5file;
 }
+
+void seissol::checkpoint::h5::Wavefield::initGlobalOrder()
+{
+	logInfo(rank()) << "Storing the checkpoint in global element order";
+
+	const unsigned int numCells = numDofs() / NUMBER_OF_ALIGNED_DOFS;
+
+	// Total number of elements
+	int maxId = -1;
+	for (unsigned int i = 0; i < numCells; i++)
+		maxId = std::max(maxId, globalIds()[i]);
+#ifdef USE_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &maxId, 1, MPI_INT, MPI_MAX, comm());
+#endif // USE_MPI
+	const unsigned long numElements = maxId + 1;
+
+	// Each rank stores a contiguous block of elements in the file
+	const unsigned long blockSize = (numElements + partitions() - 1) / partitions();
+	const unsigned long blockStart = std::min(rank() * blockSize, numElements);
+	const unsigned long blockEnd = std::min(blockStart + blockSize, numElements);
+
+	// Sort the cells by the rank that writes them
+	m_sendCounts.assign(partitions(), 0);
+	for (unsigned int i = 0; i < numCells; i++)
+		m_sendCounts[globalIds()[i] / blockSize]++;
+
+	m_sendDispls.resize(partitions());
+	m_sendDispls[0] = 0;
+	for (int i = 1; i < partitions(); i++)
+		m_sendDispls[i] = m_sendDispls[i-1] + m_sendCounts[i-1];
+
+	m_sendCells.resize(numCells);
+	m_sendSources.resize(numCells);
+	std::vector<int> sendIds(numCells);
+	std::vector<int> next(m_sendDispls);
+	for (unsigned int i = 0; i < numCells; i++) {
+		int pos = next[globalIds()[i] / blockSize]++;
+		m_sendCells[pos] = i;
+		m_sendSources[pos] = sourceCells()[i];
+		sendIds[pos] = globalIds()[i];
+	}
+
+	// Exchange the global ids
+	m_recvCounts.resize(partitions());
+	m_recvDispls.resize(partitions());
+#ifdef USE_MPI
+	MPI_Alltoall(&m_sendCounts[0], 1, MPI_INT, &m_recvCounts[0], 1, MPI_INT, comm());
+#else // USE_MPI
+	m_recvCounts[0] = m_sendCounts[0];
+#endif // USE_MPI
+	m_recvDispls[0] = 0;
+	for (int i = 1; i < partitions(); i++)
+		m_recvDispls[i] = m_recvDispls[i-1] + m_recvCounts[i-1];
+	unsigned int numRecv = m_recvDispls[partitions()-1] + m_recvCounts[partitions()-1];
+
+	std::vector<int> recvIds(numRecv);
+#ifdef USE_MPI
+	MPI_Alltoallv(numCells > 0 ? &sendIds[0] : 0L, &m_sendCounts[0], &m_sendDispls[0], MPI_INT,
+			numRecv > 0 ? &recvIds[0] : 0L, &m_recvCounts[0], &m_recvDispls[0], MPI_INT, comm());
+#else // USE_MPI
+	recvIds = sendIds;
+#endif // USE_MPI
+
+	m_recvPositions.resize(numRecv);
+	for (unsigned int i = 0; i < numRecv; i++) {
+		assert(recvIds[i] >= static_cast<int>(blockStart) && recvIds[i] < static_cast<int>(blockEnd));
+		m_recvPositions[i] = recvIds[i] - blockStart;
+	}
+
+	// Update the size of the local part of the file
+	m_numFileDofs = (blockEnd - blockStart) * fileDofsPerCell();
+	setSumOffset(m_numFileDofs);
+	initIterations(m_numFileDofs);
+
+#ifdef USE_MPI
+	MPI_Type_contiguous(NUMBER_OF_ALIGNED_DOFS, MPI_DOUBLE, &m_cellType);
+	MPI_Type_commit(&m_cellType);
+#endif // USE_MPI
+}
+
+void seissol::checkpoint::h5::Wavefield::readWriteData(bool write, hid_t h5data, hid_t h5fSpace, real* data)
+{
+	unsigned int offset = 0;
+	hsize_t fStart = fileOffset();
+	hsize_t count = dofsPerIteration();
+	hid_t h5memSpace = H5Screate_simple(1, &count, 0L);
+	checkH5Err(h5memSpace);
+	checkH5Err(H5Sselect_all(h5memSpace));
+	for (unsigned int i = 0; i < totalIterations()-1; i++) {
+		checkH5Err(H5Sselect_hyperslab(h5fSpace, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
+
+		if (write)
+			checkH5Err(H5Dwrite(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
+					h5XferList(), &data[offset]));
+		else
+			checkH5Err(H5Dread(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
+					h5XferList(), &data[offset]));
+
+		// We are finished in less iterations, read/write data twice
+		// so everybody needs the same number of iterations
+		if (i < iterations()-1) {
+			fStart += count;
+			offset += count;
+		}
+	}
+	checkH5Err(H5Sclose(h5memSpace));
+
+	// Read/write reminding data in the last iteration
+	count = m_numFileDofs - (iterations() - 1) * count;
+	hsize_t memSize = std::max(count, static_cast<hsize_t>(1));
+	h5memSpace = H5Screate_simple(1, &memSize, 0L);
+	checkH5Err(h5memSpace);
+	if (count > 0) {
+		checkH5Err(H5Sselect_all(h5memSpace));
+		checkH5Err(H5Sselect_hyperslab(h5fSpace, H5S_SELECT_SET, &fStart, 0L, &count, 0L));
+	} else {
+		// Empty local part
+		checkH5Err(H5Sselect_none(h5memSpace));
+		checkH5Err(H5Sselect_none(h5fSpace));
+	}
+	real dummy;
+	real* buffer = (count > 0 ? &data[offset] : &dummy);
+	if (write)
+		checkH5Err(H5Dwrite(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
+				h5XferList(), buffer));
+	else
+		checkH5Err(H5Dread(h5data, H5T_NATIVE_DOUBLE, h5memSpace, h5fSpace,
+				h5XferList(), buffer));
+	checkH5Err(H5Sclose(h5memSpace));
+}
+
+void seissol::checkpoint::h5::Wavefield::redistribute(bool toFile, real* fileData)
+{
+	const unsigned int numSend = m_sendCells.size();
+	const unsigned int numRecv = m_recvPositions.size();
+
+	real* sendBuffer = new real[numSend * NUMBER_OF_ALIGNED_DOFS];
+	real* recvBuffer = new real[numRecv * NUMBER_OF_ALIGNED_DOFS];
+
+	if (toFile) {
+		// Duplicated cells are always taken from the cell that holds the data
+		for (unsigned int i = 0; i < numSend; i++)
+			memcpy(&sendBuffer[i * NUMBER_OF_ALIGNED_DOFS],
+					&dofs()[m_sendSources[i] * NUMBER_OF_ALIGNED_DOFS],
+					NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+
+#ifdef USE_MPI
+		MPI_Alltoallv(sendBuffer, &m_sendCounts[0], &m_sendDispls[0], m_cellType,
+				recvBuffer, &m_recvCounts[0], &m_recvDispls[0], m_cellType, comm());
+#else // USE_MPI
+		memcpy(recvBuffer, sendBuffer, numSend * NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+#endif // USE_MPI
+
+		for (unsigned int i = 0; i < numRecv; i++)
+			packCells(&recvBuffer[i * NUMBER_OF_ALIGNED_DOFS],
+					&fileData[m_recvPositions[i] * fileDofsPerCell()], 1);
+	} else {
+		// Send the data back to all ranks that need it
+		for (unsigned int i = 0; i < numRecv; i++)
+			unpackCells(&fileData[m_recvPositions[i] * fileDofsPerCell()],
+					&recvBuffer[i * NUMBER_OF_ALIGNED_DOFS], 1);
+
+#ifdef USE_MPI
+		MPI_Alltoallv(recvBuffer, &m_recvCounts[0], &m_recvDispls[0], m_cellType,
+				sendBuffer, &m_sendCounts[0], &m_sendDispls[0], m_cellType, comm());
+#else // USE_MPI
+		memcpy(sendBuffer, recvBuffer, numRecv * NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+#endif // USE_MPI
+
+		for (unsigned int i = 0; i < numSend; i++)
+			memcpy(&dofs()[m_sendCells[i] * NUMBER_OF_ALIGNED_DOFS],
+					&sendBuffer[i * NUMBER_OF_ALIGNED_DOFS],
+					NUMBER_OF_ALIGNED_DOFS * sizeof(real));
+	}
+
+	delete [] sendBuffer;
+	delete [] recvBuffer;
+}
@@ -50,6 +50,7 @@
 
 
 #include <string>
+#include <vector>
 
 #include <hdf5.h>
 
@@ -89,9 +90,40 @@ private:
 	/** Identifiers for the file space of the data set */
 	hid_t m_h5fSpaceData;
 
+	/** True if the checkpoint is stored in global element order */
+	bool m_globalOrder;
+
+	/** Number of DOFs in the local part of the file */
+	unsigned int m_numFileDofs;
+
+	/** Deflate level for the data set (0: no compression) */
+	int m_compression;
+
+	/** Number of cells sent to/received from each rank (global order) */
+	std::vector<int> m_sendCounts;
+	std::vector<int> m_sendDispls;
+	std::vector<int> m_recvCounts;
+	std::vector<int> m_recvDispls;
+
+	/** Cells in the DOF array in the order they are sent (global order) */
+	std::vector<unsigned int> m_sendCells;
+
+	/** Cells that hold the data of the sent cells (global order) */
+	std::vector<unsigned int> m_sendSources;
+
+	/** Position in the local part of the file of each received cell (global order) */
+	std::vector<unsigned int> m_recvPositions;
+
+#ifdef USE_MPI
+	/** MPI type for the DOFs of one cell */
+	MPI_Datatype m_cellType;
+#endif // USE_MPI
+
 public:
 	Wavefield()
-		: m_h5fSpaceData(-1)
+		: m_h5fSpaceData(-1),
+		  m_globalOrder(false), m_numFileDofs(0),
+		  m_compression(0)
 	{
 	}
 
@@ -110,6 +142,11 @@ public:
 		}
 		checkH5Err(H5Sclose(m_h5fSpaceData));
 
+#ifdef USE_MPI
+		if (m_globalOrder)
+			MPI_Type_free(&m_cellType);
+#endif // USE_MPI
+
 		CheckPoint::close();
 	}
 
@@ -117,6 +154,24 @@ protected:
 	bool validate(hid_t h5file) const;
 
 	hid_t initFile(int odd, const char* filename);
+
+private:
+	/**
+	 * Setup the redistribution of the cells into global element order
+	 */
+	void initGlobalOrder();
+
+	/**
+	 * Read or write the local part of the file
+	 */
+	void readWriteData(bool write, hid_t h5data, hid_t h5fSpace, real* data);
+
+	/**
+	 * Exchange the cells between the DOF array and the local part of the file
+	 *
+	 * @param toFile True to redistribute the DOFs into the file order
+	 */
+	void redistribute(bool toFile, real* fileData);
 };
 
 #endif // USE_HDF
@@ -124,6 +124,7 @@ void seissol::checkpoint::mpio::Fault::write(int timestepFault)
 
 	for (int i = 0; i < NUM_VARIABLES; i++)
 		checkMPIErr(MPI_File_write_all(file(), data(i), numSides() * numBndGP(), MPI_DOUBLE, MPI_STATUS_IGNORE));
+	addBytesWritten(numSides() * numBndGP() * NUM_VARIABLES * sizeof(double));
 
 	EPIK_USER_END(r_write_fault);
 	SCOREP_USER_REGION_END(r_write_fault);
@@ -81,6 +81,7 @@ void seissol::checkpoint::mpio::FaultAsync::writePrepare(int timestepFault)
 
 	checkMPIErr(setDataView(file()));
 	checkMPIErr(MPI_File_write_all_begin(file(), m_dataCopy, numSides() * numBndGP() * NUM_VARIABLES, MPI_DOUBLE));
+	addBytesWritten(numSides() * numBndGP() * NUM_VARIABLES * sizeof(double));
 
 	EPIK_USER_END(r_write_fault);
 	SCOREP_USER_REGION_END(r_write_fault);
@@ -111,6 +111,7 @@ void seissol::checkpoint::mpio::Wavefield::write(double time, int timestepWaveFi
 	checkMPIErr(setDataView(file()));
 
 	checkMPIErr(MPI_File_write_all(file(), dofs(), numDofs(), MPI_DOUBLE, MPI_STATUS_IGNORE));
+	addBytesWritten(numDofs() * sizeof(real));
 
 	EPIK_USER_END(r_write_wavefield);
 	SCOREP_USER_REGION_END(r_write_wavefield);
@@ -72,6 +72,7 @@ void seissol::checkpoint::mpio::WavefieldAsync::writePrepare(double time, int ti
 	checkMPIErr(setDataView(file()));
 
 	checkMPIErr(MPI_File_write_all_begin(file(), m_dofsCopy, numDofs(), MPI_DOUBLE));
+	addBytesWritten(numDofs() * sizeof(real));
 
 	EPIK_USER_END(r_write_wavefield);
 	SCOREP_USER_REGION_END(r_write_wavefield);
@@ -230,6 +230,36 @@ protected:
 			logError() << "Error in the POSIX checkpoint module:"
 				<< target << "bytes expected;" << ret << "bytes gotten";
 	}
+
+	/**
+	 * Writes a buffer at a given offset, retries on partial writes
+	 */
+	static void pwriteAll(int file, const char* buffer, unsigned long size, off64_t offset)
+	{
+		while (size > 0) {
+			ssize_t written = pwrite64(file, buffer, size, offset);
+			if (written <= 0)
+				checkErr(written, size);
+			buffer += written;
+			offset += written;
+			size -= written;
+		}
+	}
+
+	/**
+	 * Reads a buffer from a given offset, retries on partial reads
+	 */
+	static void preadAll(int file, char* buffer, unsigned long size, off64_t offset)
+	{
+		while (size > 0) {
+			ssize_t readSize = pread64(file, buffer, size, offset);
+			if (readSize <= 0)
+				checkErr(readSize, size);
+			buffer += readSize;
+			offset += readSize;
+			size -= readSize;
+		}
+	}
 };
 
 }
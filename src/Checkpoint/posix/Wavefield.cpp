@@ -37,12 +37,59 @@
  * @section DESCRIPTION
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif // USE_ZLIB
+
+#include "utils/env.h"
+
 #include "Wavefield.h"
 
 bool seissol::checkpoint::posix::Wavefield::init(real* dofs, unsigned int numDofs)
 {
 	seissol::checkpoint::Wavefield::init(dofs, numDofs);
 
+	initPacking();
+
+	m_compression = utils::Env::get<int>("SEISSOL_CHECKPOINT_COMPRESSION", 0);
+#ifdef USE_ZLIB
+	if (m_compression < 0 || m_compression > 9) {
+		logWarning(rank()) << "Invalid checkpoint compression level" << m_compression << ", disabling compression";
+		m_compression = 0;
+	}
+	if (m_compression > 0)
+		logInfo(rank()) << "Compressing checkpoints with zlib level" << m_compression;
+#else // USE_ZLIB
+	if (m_compression != 0) {
+		logWarning(rank()) << "SeisSol was compiled without zlib, disabling checkpoint compression";
+		m_compression = 0;
+	}
+#endif // USE_ZLIB
+
+	// Block size in bytes, blocks contain complete cells
+	unsigned long blockSize = utils::Env::get<unsigned long>("SEISSOL_CHECKPOINT_CHUNK_SIZE", 1ul << 22);
+	unsigned long blockCells = std::max(blockSize / (NUMBER_OF_ALIGNED_DOFS * sizeof(real)), 1ul);
+	m_blockSize = blockCells * NUMBER_OF_ALIGNED_DOFS;
+	m_numBlocks = (numDofs + m_blockSize - 1) / m_blockSize;
+
+	// Compressed blocks store their size in front of the data
+	m_fileBlockSize = blockCells * fileDofsPerCell() * sizeof(real);
+	if (m_compression > 0)
+		m_fileBlockSize += sizeof(unsigned long);
+
+	m_incrementalInterval = utils::Env::get<int>("SEISSOL_CHECKPOINT_INCREMENTAL", 0);
+	m_threshold = utils::Env::get<double>("SEISSOL_CHECKPOINT_INCREMENTAL_THRESHOLD", 0.);
+	if (m_incrementalInterval > 0) {
+		logInfo(rank()) << "Writing incremental checkpoints, full checkpoint every"
+			<< (m_incrementalInterval+1) << "checkpoints per file";
+		for (unsigned int i = 0; i < 2; i++)
+			m_blockHashes[i].resize(m_numBlocks);
+	}
+
 	return exists();
 }
 
@@ -63,18 +110,9 @@ void seissol::checkpoint::posix::Wavefield::load(double &time, int &timestepWave
 	checkErr(read(file, &timestepWaveField, sizeof(timestepWaveField)),
 			sizeof(timestepWaveField));
 
-	// Convert to char* to do pointer arithmetic
-	char* buffer = reinterpret_cast<char*>(dofs());
-	unsigned long left = numDofs()*sizeof(real);
-
 	// Read dofs
-	while (left > 0) {
-		unsigned long readSize = read(file, buffer, left);
-		if (readSize <= 0)
-			checkErr(readSize, left);
-		buffer += readSize;
-		left -= readSize;
-	}
+	for (unsigned int i = 0; i < numBlocks(); i++)
+		readBlock(file, i, dofs() + i*blockSize());
 
 	// Close the file
 	checkErr(::close(file));
@@ -87,46 +125,192 @@ void seissol::checkpoint::posix::Wavefield::write(double time, int timestepWaveF
 
 	logInfo(rank()) << "Writing check point.";
 
-	// Skip identifier
-	checkErr(lseek64(file(), sizeof(unsigned long), SEEK_SET));
-
 	// Write the header
+	writeHeader(time, timestepWaveField);
+
+	// Save data
+	EPIK_USER_REG(r_write_wavefield, "checkpoint_write_wavefield");
+	SCOREP_USER_REGION_DEFINE(r_write_wavefield);
+	EPIK_USER_START(r_write_wavefield);
+	SCOREP_USER_REGION_BEGIN(r_write_wavefield, "checkpoint_write_wavefield", SCOREP_USER_REGION_TYPE_COMMON);
+
+	bool full = beginCheckpoint(odd());
+
+	// Find the modified blocks
+	std::vector<char> changed(numBlocks());
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static)
+#endif // _OPENMP
+	for (unsigned int i = 0; i < numBlocks(); i++)
+		changed[i] = blockChanged(odd(), i, dofs() + i*blockSize(), full);
+
+	unsigned int numWritten = 0;
+	for (unsigned int i = 0; i < numBlocks(); i++) {
+		if (!changed[i])
+			continue;
+
+		addBytesWritten(writeBlock(file(), i, dofs() + i*blockSize()));
+		numWritten++;
+	}
+
+	if (!full)
+		logInfo(rank()) << "Incremental check point:" << numWritten << "of" << numBlocks() << "blocks written.";
+
+	EPIK_USER_END(r_write_wavefield);
+	SCOREP_USER_REGION_END(r_write_wavefield);
+
+	// Finalize the checkpoint
+	finalizeCheckpoint();
+
+	logInfo(rank()) << "Writing check point. Done.";
+}
+
+void seissol::checkpoint::posix::Wavefield::writeHeader(double time, int timestepWaveField)
+{
 	EPIK_USER_REG(r_write_header, "checkpoint_write_header");
 	SCOREP_USER_REGION_DEFINE(r_write_header);
 	EPIK_USER_START(r_write_header);
 	SCOREP_USER_REGION_BEGIN(r_write_header, "checkpoint_write_header", SCOREP_USER_REGION_TYPE_COMMON);
 
+	// Skip identifier
+	checkErr(lseek64(file(), sizeof(unsigned long), SEEK_SET));
+
 	checkErr(::write(file(), &time, sizeof(time)), sizeof(time));
 	checkErr(::write(file(), &timestepWaveField, sizeof(timestepWaveField)),
 			sizeof(timestepWaveField));
+	int fileFormat = format();
+	checkErr(::write(file(), &fileFormat, sizeof(fileFormat)), sizeof(fileFormat));
+	unsigned int cells = blockCells();
+	checkErr(::write(file(), &cells, sizeof(cells)), sizeof(cells));
 
 	EPIK_USER_END(r_write_header);
 	SCOREP_USER_REGION_END(r_write_header);
+}
 
-	// Save data
-	EPIK_USER_REG(r_write_wavefield, "checkpoint_write_wavefield");
-	SCOREP_USER_REGION_DEFINE(r_write_wavefield);
-	EPIK_USER_START(r_write_wavefield);
-	SCOREP_USER_REGION_BEGIN(r_write_wavefield, "checkpoint_write_wavefield", SCOREP_USER_REGION_TYPE_COMMON);
+bool seissol::checkpoint::posix::Wavefield::beginCheckpoint(int odd)
+{
+	int &count = m_incrementalCount[odd];
+	bool full = (count < 0 || count >= m_incrementalInterval);
+	count = (full ? 0 : count+1);
 
-	// Convert to char* to do pointer arithmetic
-	const char* buffer = reinterpret_cast<const char*>(dofs());
-	unsigned long left = numDofs()*sizeof(real);
-	while (left > 0) {
-		unsigned long written = ::write(file(), buffer, left);
-		if (written <= 0)
-			checkErr(written, left);
-		buffer += written;
-		left -= written;
+	return full;
+}
+
+bool seissol::checkpoint::posix::Wavefield::blockChanged(int odd, unsigned int block, const real* data, bool full)
+{
+	if (m_incrementalInterval <= 0)
+		return true;
+
+	// FNV-1a hash of the (quantized) values
+	unsigned long hash = 0xcbf29ce484222325ul;
+	unsigned int size = blockDofs(block);
+	if (m_threshold > 0) {
+		const double invThreshold = 1. / m_threshold;
+		for (unsigned int i = 0; i < size; i++) {
+			long value = static_cast<long>(std::floor(data[i] * invThreshold + 0.5));
+			hash = (hash ^ static_cast<unsigned long>(value)) * 0x100000001b3ul;
+		}
+	} else {
+		for (unsigned int i = 0; i < size; i++) {
+			unsigned long value = 0;
+			memcpy(&value, &data[i], sizeof(real));
+			hash = (hash ^ value) * 0x100000001b3ul;
+		}
 	}
 
-	EPIK_USER_END(r_write_wavefield);
-	SCOREP_USER_REGION_END(r_write_wavefield);
+	bool changed = full || hash != m_blockHashes[odd][block];
+	m_blockHashes[odd][block] = hash;
+	return changed;
+}
 
-	// Finalize the checkpoint
-	finalizeCheckpoint();
+unsigned long seissol::checkpoint::posix::Wavefield::writeBlock(int file, unsigned int block, const real* data) const
+{
+	const unsigned int numCells = blockDofs(block) / NUMBER_OF_ALIGNED_DOFS;
+	const unsigned long size = numCells * fileDofsPerCell() * sizeof(real);
+	const off64_t offset = headerSize() + static_cast<off64_t>(block)*m_fileBlockSize;
 
-	logInfo(rank()) << "Writing check point. Done.";
+	if (!packed() && m_compression == 0) {
+		pwriteAll(file, reinterpret_cast<const char*>(data), size, offset);
+		return size;
+	}
+
+	std::vector<real> fileData(numCells * fileDofsPerCell());
+	packCells(data, &fileData[0], numCells);
+
+#ifdef USE_ZLIB
+	if (m_compression > 0) {
+		// Shuffle the bytes, this groups the exponents of the values
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&fileData[0]);
+		const unsigned int numValues = fileData.size();
+		std::vector<unsigned char> shuffled(size);
+		for (unsigned int i = 0; i < numValues; i++)
+			for (unsigned int j = 0; j < sizeof(real); j++)
+				shuffled[j*numValues + i] = bytes[i*sizeof(real) + j];
+
+		std::vector<char> buffer(sizeof(unsigned long) + size);
+		uLongf compressedSize = size;
+		if (compress2(reinterpret_cast<Bytef*>(&buffer[sizeof(unsigned long)]), &compressedSize,
+				&shuffled[0], size, m_compression) != Z_OK)
+			// Not compressible, store the shuffled data
+			compressedSize = size;
+		if (compressedSize == size)
+			memcpy(&buffer[sizeof(unsigned long)], &shuffled[0], size);
+
+		unsigned long storedSize = compressedSize;
+		memcpy(&buffer[0], &storedSize, sizeof(storedSize));
+		pwriteAll(file, &buffer[0], sizeof(unsigned long) + compressedSize, offset);
+		return sizeof(unsigned long) + compressedSize;
+	}
+#endif // USE_ZLIB
+
+	pwriteAll(file, reinterpret_cast<const char*>(&fileData[0]), size, offset);
+	return size;
+}
+
+void seissol::checkpoint::posix::Wavefield::readBlock(int file, unsigned int block, real* data) const
+{
+	const unsigned int numCells = blockDofs(block) / NUMBER_OF_ALIGNED_DOFS;
+	const unsigned long size = numCells * fileDofsPerCell() * sizeof(real);
+	const off64_t offset = headerSize() + static_cast<off64_t>(block)*m_fileBlockSize;
+
+	if (!packed() && m_compression == 0) {
+		preadAll(file, reinterpret_cast<char*>(data), size, offset);
+		return;
+	}
+
+	std::vector<real> fileData(numCells * fileDofsPerCell());
+
+#ifdef USE_ZLIB
+	if (m_compression > 0) {
+		unsigned long storedSize;
+		preadAll(file, reinterpret_cast<char*>(&storedSize), sizeof(storedSize), offset);
+		if (storedSize > size)
+			logError() << "Corrupt block in checkpoint";
+
+		std::vector<unsigned char> shuffled(size);
+		if (storedSize == size) {
+			preadAll(file, reinterpret_cast<char*>(&shuffled[0]), size, offset + sizeof(unsigned long));
+		} else {
+			std::vector<char> buffer(storedSize);
+			preadAll(file, &buffer[0], storedSize, offset + sizeof(unsigned long));
+			uLongf uncompressedSize = size;
+			if (uncompress(&shuffled[0], &uncompressedSize,
+					reinterpret_cast<const Bytef*>(&buffer[0]), storedSize) != Z_OK
+					|| uncompressedSize != size)
+				logError() << "Could not decompress block in checkpoint";
+		}
+
+		// Unshuffle the bytes
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(&fileData[0]);
+		const unsigned int numValues = fileData.size();
+		for (unsigned int i = 0; i < numValues; i++)
+			for (unsigned int j = 0; j < sizeof(real); j++)
+				bytes[i*sizeof(real) + j] = shuffled[j*numValues + i];
+	} else
+#endif // USE_ZLIB
+		preadAll(file, reinterpret_cast<char*>(&fileData[0]), size, offset);
+
+	unpackCells(&fileData[0], data, numCells);
 }
 
 bool seissol::checkpoint::posix::Wavefield::validate(int file) const
@@ -143,5 +327,26 @@ bool seissol::checkpoint::posix::Wavefield::validate(int file) const
 		return false;
 	}
 
+	int fileFormat;
+	unsigned int cells;
+	if (lseek64(file, headerSize() - sizeof(fileFormat) - sizeof(cells), SEEK_SET) < 0
+			|| read(file, &fileFormat, sizeof(fileFormat)) < static_cast<ssize_t>(sizeof(fileFormat))
+			|| read(file, &cells, sizeof(cells)) < static_cast<ssize_t>(sizeof(cells))) {
+		logWarning() << "Could not read checkpoint format";
+		return false;
+	}
+
+	if (fileFormat != format()) {
+		logWarning() << "Checkpoint format (alignment padding or compression) does not match";
+		return false;
+	}
+
+	// The position of compressed blocks depends on the block size
+	if (m_compression > 0 && cells != blockCells()) {
+		logWarning() << "Checkpoint has" << cells << "cells per block, SEISSOL_CHECKPOINT_CHUNK_SIZE requires"
+			<< blockCells();
+		return false;
+	}
+
 	return true;
 }
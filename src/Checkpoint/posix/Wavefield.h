@@ -40,6 +40,9 @@
 #ifndef CHECKPOINT_POSIX_WAVEFIELD_H
 #define CHECKPOINT_POSIX_WAVEFIELD_H
 
+#include <algorithm>
+#include <vector>
+
 #include "CheckPoint.h"
 #include "Checkpoint/Wavefield.h"
 
@@ -52,12 +55,58 @@ namespace checkpoint
 namespace posix
 {
 
+/**
+ * Writes the wave field to one file per rank.
+ *
+ * The DOFs are written in blocks of complete cells. In incremental mode,
+ * only blocks that changed since the last checkpoint in the same (even/odd)
+ * file are rewritten. Each file always contains a complete checkpoint.
+ *
+ * With compression enabled, each block is byte-shuffled and compressed
+ * with zlib. Every block keeps a fixed slot in the file, so single blocks
+ * can still be updated in place. The slot size depends on the block size,
+ * which is therefore stored in the header.
+ */
 class Wavefield : public CheckPoint, virtual public seissol::checkpoint::Wavefield
 {
+private:
+	/** Number of DOFs in one block */
+	unsigned int m_blockSize;
+
+	/** Size of one block in the file (in bytes) */
+	unsigned long m_fileBlockSize;
+
+	/** Compression level for the blocks (0: no compression) */
+	int m_compression;
+
+	/** Number of blocks */
+	unsigned int m_numBlocks;
+
+	/**
+	 * Number of incremental checkpoints between two full checkpoints
+	 * in the same file (0: incremental checkpoints disabled)
+	 */
+	int m_incrementalInterval;
+
+	/** DOF changes below this threshold do not change the block hash */
+	double m_threshold;
+
+	/** The hash of each block in the even/odd file */
+	std::vector<unsigned long> m_blockHashes[2];
+
+	/**
+	 * Number of incremental checkpoints since the last full checkpoint
+	 * in the even/odd file (-1 if the content of the file is unknown)
+	 */
+	int m_incrementalCount[2];
+
 public:
 	Wavefield()
-		: CheckPoint(0x7A56F)
+		: CheckPoint(0x7A570),
+		  m_blockSize(0), m_fileBlockSize(0), m_compression(0), m_numBlocks(0),
+		  m_incrementalInterval(0), m_threshold(0)
 	{
+		m_incrementalCount[0] = m_incrementalCount[1] = -1;
 	}
 
 	bool init(real* dofs, unsigned int numDofs);
@@ -76,6 +125,79 @@ protected:
 	 * @param timestepWaveField
 	 */
 	void writeHeader(double time, int timestepWaveField);
+
+	/**
+	 * @return The size of the header (identifier, time, time step, format
+	 *  and cells per block)
+	 */
+	static unsigned long headerSize()
+	{
+		return sizeof(unsigned long) + sizeof(double) + 2*sizeof(int) + sizeof(unsigned int);
+	}
+
+	/**
+	 * @return The file format (alignment padding and compression)
+	 */
+	int format() const
+	{
+		return (packed() ? 1 : 0) | (m_compression > 0 ? 2 : 0);
+	}
+
+	unsigned int blockSize() const
+	{
+		return m_blockSize;
+	}
+
+	/**
+	 * @return Number of cells in a block
+	 */
+	unsigned int blockCells() const
+	{
+		return m_blockSize / NUMBER_OF_ALIGNED_DOFS;
+	}
+
+	unsigned int numBlocks() const
+	{
+		return m_numBlocks;
+	}
+
+	/**
+	 * @return Number of DOFs in a block (the last block may be smaller)
+	 */
+	unsigned int blockDofs(unsigned int block) const
+	{
+		return std::min(m_blockSize, numDofs() - block*m_blockSize);
+	}
+
+	/**
+	 * Starts a new checkpoint in a file
+	 *
+	 * @param odd The file that is written
+	 * @return True if all blocks have to be written
+	 */
+	bool beginCheckpoint(int odd);
+
+	/**
+	 * Checks if a block has to be written and updates the hash of the block.
+	 * Has to be called for all blocks of a checkpoint.
+	 *
+	 * @param odd The file that is written
+	 * @param data The DOFs of the block
+	 * @param full True if all blocks are written
+	 */
+	bool blockChanged(int odd, unsigned int block, const real* data, bool full);
+
+	/**
+	 * Writes a block of the DOFs to a file
+	 *
+	 * @return The number of bytes written
+	 */
+	unsigned long writeBlock(int file, unsigned int block, const real* data) const;
+
+	/**
+	 * Reads a block of the DOFs from a file
+	 */
+	void readBlock(int file, unsigned int block, real* data) const;
 };
 
 }
@@ -0,0 +1,196 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (sebastian.rettenberger AT tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ */
+
+#include <cstring>
+
+#include "WavefieldAsync.h"
+#include "Checkpoint/Telemetry.h"
+
+bool seissol::checkpoint::posix::WavefieldAsync::init(real* dofs, unsigned int numDofs)
+{
+	bool exists = Wavefield::init(dofs, numDofs);
+
+	// Chunks are the blocks of the checkpoint
+	m_chunkStates.assign(numBlocks(), CHUNK_DONE);
+	m_chunkCopies.assign(numBlocks(), 0L);
+
+	pthread_mutex_init(&m_mutex, 0L);
+	pthread_cond_init(&m_condition, 0L);
+	if (pthread_create(&m_thread, 0L, runIOThread, this) != 0)
+		logError() << "Could not create the checkpoint thread";
+
+	return exists;
+}
+
+void seissol::checkpoint::posix::WavefieldAsync::writePrepare(double time, int timestepWaveField)
+{
+	EPIK_TRACER("CheckPoint_writePrepare");
+	SCOREP_USER_REGION("CheckPoint_writePrepare", SCOREP_USER_REGION_TYPE_FUNCTION);
+
+	// Write the header
+	writeHeader(time, timestepWaveField);
+
+	// Hand over all chunks to the I/O thread
+	pthread_mutex_lock(&m_mutex);
+	for (unsigned int i = 0; i < numBlocks(); i++)
+		m_chunkStates[i] = CHUNK_PENDING;
+	m_nextChunk = 0;
+	m_jobFile = file();
+	m_jobOdd = odd();
+	m_jobFull = beginCheckpoint(odd());
+	m_jobActive = true;
+	pthread_cond_broadcast(&m_condition);
+	pthread_mutex_unlock(&m_mutex);
+
+	m_started = true;
+}
+
+void seissol::checkpoint::posix::WavefieldAsync::write(double time, int timestepWaveField)
+{
+	EPIK_TRACER("CheckPoint_write");
+	SCOREP_USER_REGION("CheckPoint_write", SCOREP_USER_REGION_TYPE_FUNCTION);
+
+	logInfo(rank()) << "Writing check point.";
+
+	if (m_started) {
+		// Wait for the I/O thread (includes the flush)
+		pthread_mutex_lock(&m_mutex);
+		while (m_jobActive)
+			pthread_cond_wait(&m_condition, &m_mutex);
+		pthread_mutex_unlock(&m_mutex);
+
+		m_started = false;
+	} else {
+		// Finalize the checkpoint
+		finalizeCheckpoint();
+	}
+
+	logInfo(rank()) << "Writing check point. Done.";
+}
+
+void seissol::checkpoint::posix::WavefieldAsync::prepareUpdate(const real* dofs, unsigned int numDofs)
+{
+	if (!m_started || numDofs == 0)
+		return;
+
+	if (dofs < this->dofs() || dofs + numDofs > this->dofs() + this->numDofs())
+		logError() << "Updated DOFs are not part of the checkpoint";
+
+	unsigned long offset = dofs - this->dofs();
+	unsigned int firstChunk = offset / blockSize();
+	unsigned int lastChunk = (offset + numDofs - 1) / blockSize();
+
+	// Waiting for the I/O thread and copying blocks the solver
+	double start = Telemetry::wallTime();
+
+	pthread_mutex_lock(&m_mutex);
+	for (unsigned int i = firstChunk; i <= lastChunk; i++) {
+		// The I/O thread is reading the original DOFs
+		while (m_chunkStates[i] == CHUNK_WRITING && m_chunkCopies[i] == 0L)
+			pthread_cond_wait(&m_condition, &m_mutex);
+
+		if (m_chunkStates[i] == CHUNK_PENDING) {
+			unsigned int size = blockDofs(i);
+			m_chunkCopies[i] = new real[size];
+			memcpy(m_chunkCopies[i], this->dofs() + i*blockSize(), size*sizeof(real));
+			m_chunkStates[i] = CHUNK_COPIED;
+		}
+	}
+	pthread_mutex_unlock(&m_mutex);
+
+	addBlockedTime(Telemetry::wallTime() - start);
+}
+
+void seissol::checkpoint::posix::WavefieldAsync::close()
+{
+	// Finalize last checkpoint
+	write(0, 0); // Time does not matter
+
+	pthread_mutex_lock(&m_mutex);
+	m_shutdown = true;
+	pthread_cond_broadcast(&m_condition);
+	pthread_mutex_unlock(&m_mutex);
+
+	pthread_join(m_thread, 0L);
+	pthread_cond_destroy(&m_condition);
+	pthread_mutex_destroy(&m_mutex);
+
+	Wavefield::close();
+}
+
+void seissol::checkpoint::posix::WavefieldAsync::ioThread()
+{
+	pthread_mutex_lock(&m_mutex);
+	while (true) {
+		while (!m_jobActive && !m_shutdown)
+			pthread_cond_wait(&m_condition, &m_mutex);
+		if (!m_jobActive)
+			break; // Shutdown and nothing left to write
+
+		if (m_nextChunk < numBlocks()) {
+			unsigned int chunk = m_nextChunk++;
+			const real* buffer = m_chunkCopies[chunk];
+			if (buffer == 0L)
+				buffer = dofs() + chunk*blockSize();
+			m_chunkStates[chunk] = CHUNK_WRITING;
+			pthread_mutex_unlock(&m_mutex);
+
+			unsigned long bytes = 0;
+			if (blockChanged(m_jobOdd, chunk, buffer, m_jobFull))
+				bytes = writeBlock(m_jobFile, chunk, buffer);
+
+			pthread_mutex_lock(&m_mutex);
+			addBytesWritten(bytes);
+			delete [] m_chunkCopies[chunk];
+			m_chunkCopies[chunk] = 0L;
+			m_chunkStates[chunk] = CHUNK_DONE;
+			pthread_cond_broadcast(&m_condition);
+		} else {
+			// All chunks written
+			pthread_mutex_unlock(&m_mutex);
+
+			checkErr(fsync(m_jobFile));
+
+			pthread_mutex_lock(&m_mutex);
+			m_jobActive = false;
+			pthread_cond_broadcast(&m_condition);
+		}
+	}
+	pthread_mutex_unlock(&m_mutex);
+}
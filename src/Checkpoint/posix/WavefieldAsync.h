@@ -0,0 +1,155 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (sebastian.rettenberger AT tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ */
+
+#ifndef CHECKPOINT_POSIX_WAVEFIELD_ASYNC_H
+#define CHECKPOINT_POSIX_WAVEFIELD_ASYNC_H
+
+#include <pthread.h>
+
+#include <vector>
+
+#include "Wavefield.h"
+
+namespace seissol
+{
+
+namespace checkpoint
+{
+
+namespace posix
+{
+
+/**
+ * Writes the wave field in the background directly from the DOF array.
+ *
+ * The blocks of the DOFs are written by an I/O thread while the
+ * simulation continues. Chunks the solver modifies before
+ * they are written are copied first (copy-on-write). Chunks that are
+ * not touched are never copied. Incremental checkpoints skip unchanged
+ * chunks.
+ */
+class WavefieldAsync : public Wavefield
+{
+private:
+	/** State of a chunk in the current checkpoint */
+	enum ChunkState
+	{
+		/** Not yet written, DOFs are unmodified */
+		CHUNK_PENDING,
+		/** Not yet written, a copy was created */
+		CHUNK_COPIED,
+		/** Being written by the I/O thread */
+		CHUNK_WRITING,
+		/** Written to the file */
+		CHUNK_DONE
+	};
+
+	/** The state of each chunk */
+	std::vector<ChunkState> m_chunkStates;
+
+	/** Copies of the modified chunks */
+	std::vector<real*> m_chunkCopies;
+
+	/** The next chunk written by the I/O thread */
+	unsigned int m_nextChunk;
+
+	/** File handle of the checkpoint being written */
+	int m_jobFile;
+
+	/** Even or odd file of the checkpoint being written */
+	int m_jobOdd;
+
+	/** True if all chunks of the checkpoint are written */
+	bool m_jobFull;
+
+	/** True if the I/O thread is writing a checkpoint */
+	bool m_jobActive;
+
+	/** True if a checkpoint was started */
+	bool m_started;
+
+	/** True if the I/O thread should terminate */
+	bool m_shutdown;
+
+	/** The I/O thread */
+	pthread_t m_thread;
+
+	/** Protects the chunk states */
+	pthread_mutex_t m_mutex;
+
+	/** Signals state changes */
+	pthread_cond_t m_condition;
+
+public:
+	WavefieldAsync()
+		: m_nextChunk(0), m_jobFile(-1), m_jobOdd(0), m_jobFull(true),
+		  m_jobActive(false), m_started(false), m_shutdown(false)
+	{
+	}
+
+	bool init(real* dofs, unsigned int numDofs);
+
+	void writePrepare(double time, int timestepWaveField);
+
+	void write(double time, int timestepWaveField);
+
+	void prepareUpdate(const real* dofs, unsigned int numDofs);
+
+	void close();
+
+private:
+	/**
+	 * Main loop of the I/O thread
+	 */
+	void ioThread();
+
+	static void* runIOThread(void* writer)
+	{
+		static_cast<WavefieldAsync*>(writer)->ioThread();
+		return 0L;
+	}
+};
+
+}
+
+}
+
+}
+
+#endif // CHECKPOINT_POSIX_WAVEFIELD_ASYNC_H
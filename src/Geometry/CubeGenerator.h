@@ -0,0 +1,420 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Generates a structured cube mesh of tetrahedra in memory (proxy-app mode)
+ **/
+
+#ifndef CUBE_GENERATOR_H
+#define CUBE_GENERATOR_H
+
+#include "MeshReader.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "utils/logger.h"
+
+/**
+ * Creates the local partition of a cube, which is split into hexahedra and
+ * each hexahedron into 6 tetrahedra (Kuhn triangulation).
+ *
+ * The cube is partitioned into boxes of hexahedra. Each rank generates its own box only,
+ * no file access or communication is required. Vertex coordinates are in
+ * [0,scale_x] x [0,scale_y] x [-scale_z,0].
+ */
+class CubeGenerator : public MeshReader
+{
+private:
+	/** Number of hexahedra in the cube */
+	int m_size[3];
+
+	/** Number of partitions in each dimension */
+	int m_partitions[3];
+
+	/** First hexahedron (inclusive) and last hexahedron (exclusive) of the local partition */
+	int m_start[3];
+	int m_end[3];
+
+public:
+	/**
+	 * @param size Number of hexahedra in x, y and z dimension
+	 * @param partitions Number of partitions in x, y and z dimension, 0 for automatic
+	 * @param scale Extent of the cube in x, y and z dimension
+	 * @param grading Growth factor of the element height from one layer to the next one above,
+	 *  1 for a uniform mesh; varies the time step width to trigger LTS
+	 * @param boundaries Boundary conditions of the faces -x, +x, -y, +y, -z, +z
+	 * @param materialLayer Fraction of the height (from the bottom) which is assigned to material group 2,
+	 *  the rest is assigned to material group 1
+	 */
+	CubeGenerator(int rank, int nProcs, const int size[3], const int partitions[3],
+			const double scale[3], double grading, const int boundaries[6], double materialLayer)
+		: MeshReader(rank)
+	{
+		for (int i = 0; i < 3; i++) {
+			if (size[i] < 1)
+				logError() << "Invalid cube size:" << size[0] << size[1] << size[2];
+			m_size[i] = size[i];
+		}
+		for (int i = 0; i < 6; i++) {
+			if (boundaries[i] == 3 || boundaries[i] == 6)
+				logError() << "Dynamic rupture and periodic boundaries are not supported by the cube generator";
+		}
+		if (grading <= 0)
+			logError() << "Invalid grading of the cube mesh:" << grading;
+
+		if (static_cast<double>(size[0]) * size[1] * size[2] * 6 > INT_MAX
+				|| static_cast<double>(size[0]+1) * (size[1]+1) * (size[2]+1) > INT_MAX)
+			logError() << "Cube mesh with" << size[0] << 'x' << size[1] << 'x' << size[2]
+				<< "hexahedra exceeds the integer range of the global ids";
+
+		computePartitions(nProcs, partitions);
+
+		// Find the local box
+		int p[3] = {rank % m_partitions[0],
+				(rank / m_partitions[0]) % m_partitions[1],
+				rank / (m_partitions[0] * m_partitions[1])};
+		for (int i = 0; i < 3; i++) {
+			m_start[i] = static_cast<int>(static_cast<long long>(p[i]) * m_size[i] / m_partitions[i]);
+			m_end[i] = static_cast<int>(static_cast<long long>(p[i]+1) * m_size[i] / m_partitions[i]);
+		}
+
+		logInfo(rank) << "Generating cube mesh with" << m_size[0] << 'x' << m_size[1] << 'x' << m_size[2]
+			<< "hexahedra and" << m_partitions[0] << 'x' << m_partitions[1] << 'x' << m_partitions[2] << "partitions";
+
+		generateVertices(scale, grading);
+		generateElements(boundaries, scale[2], materialLayer);
+		buildVertexElements();
+
+		sortMPINeighborElements();
+
+		logInfo(rank) << "Finished generating mesh";
+	}
+
+	virtual ~CubeGenerator()
+	{
+	}
+
+private:
+	/**
+	 * Sets the number of partitions in all dimensions with 0 partitions.
+	 * Prime factors of the remaining number of processes are assigned to the dimension
+	 * with the largest number of hexahedra per partition.
+	 */
+	void computePartitions(int nProcs, const int partitions[3])
+	{
+		int remaining = nProcs;
+		for (int i = 0; i < 3; i++) {
+			m_partitions[i] = std::max(partitions[i], 0);
+			if (m_partitions[i] > 0) {
+				if (remaining % m_partitions[i] != 0)
+					logError() << "Number of cube partitions does not match the number of MPI ranks";
+				remaining /= m_partitions[i];
+			}
+		}
+
+		bool automatic = m_partitions[0] == 0 || m_partitions[1] == 0 || m_partitions[2] == 0;
+		for (int i = 0; i < 3; i++) {
+			if (m_partitions[i] == 0)
+				m_partitions[i] = 1;
+		}
+
+		if (automatic) {
+			// Prime factors, largest first
+			std::vector<int> factors;
+			for (int f = 2; f * f <= remaining; f++) {
+				while (remaining % f == 0) {
+					factors.push_back(f);
+					remaining /= f;
+				}
+			}
+			if (remaining > 1)
+				factors.push_back(remaining);
+			std::reverse(factors.begin(), factors.end());
+
+			for (std::vector<int>::const_iterator f = factors.begin(); f != factors.end(); f++) {
+				int dim = -1;
+				for (int i = 0; i < 3; i++) {
+					if (partitions[i] > 0)
+						continue; // Fixed by the user
+					if (dim < 0 || static_cast<double>(m_size[i]) / m_partitions[i]
+							> static_cast<double>(m_size[dim]) / m_partitions[dim])
+						dim = i;
+				}
+				m_partitions[dim] *= *f;
+			}
+		} else if (remaining != 1) {
+			logError() << "Number of cube partitions does not match the number of MPI ranks";
+		}
+
+		for (int i = 0; i < 3; i++) {
+			if (m_partitions[i] > m_size[i])
+				logError() << "Cube mesh has less hexahedra than partitions in dimension" << i;
+		}
+	}
+
+	/**
+	 * Creates the vertices of the local box
+	 */
+	void generateVertices(const double scale[3], double grading)
+	{
+		int localSize[3] = {m_end[0]-m_start[0]+1, m_end[1]-m_start[1]+1, m_end[2]-m_start[2]+1};
+		m_vertices.resize(localSize[0] * localSize[1] * localSize[2]);
+
+		for (int z = 0; z < localSize[2]; z++) {
+			for (int y = 0; y < localSize[1]; y++) {
+				for (int x = 0; x < localSize[0]; x++) {
+					VrtxCoords &coords = m_vertices[(z*localSize[1] + y)*localSize[0] + x].coords;
+					coords[0] = scale[0] * (m_start[0]+x) / m_size[0];
+					coords[1] = scale[1] * (m_start[1]+y) / m_size[1];
+					coords[2] = -scale[2] * (1. - height(m_start[2]+z, grading));
+				}
+			}
+		}
+	}
+
+	/**
+	 * Creates the elements of the local box, including neighbor and boundary information
+	 */
+	void generateElements(const int boundaries[6], double scaleZ, double materialLayer)
+	{
+		int localSize[3] = {m_end[0]-m_start[0], m_end[1]-m_start[1], m_end[2]-m_start[2]};
+		m_elements.resize(localSize[0] * localSize[1] * localSize[2] * 6);
+		m_globalElementIds.resize(m_elements.size());
+		m_hasGlobalElementIds = true;
+
+		for (int z = m_start[2]; z < m_end[2]; z++) {
+			for (int y = m_start[1]; y < m_end[1]; y++) {
+				for (int x = m_start[0]; x < m_end[0]; x++) {
+					int hex[3] = {x, y, z};
+
+					// Material depends on the center of the hexahedron
+					double center = .5 * (m_vertices[localVertex(x, y, z)].coords[2]
+						+ m_vertices[localVertex(x, y, z+1)].coords[2]);
+					ElemMaterial material = (center < -scaleZ * (1. - materialLayer) ? 2 : 1);
+
+					for (int t = 0; t < 6; t++) {
+						Element &element = m_elements[localElement(hex, t)];
+						element.localId = localElement(hex, t);
+						m_globalElementIds[element.localId] = globalElement(hex, t);
+						element.rank = m_rank;
+						element.material = material;
+
+						int corners[4];
+						tetCorners(t, corners);
+						for (int i = 0; i < 4; i++) {
+							element.vertices[i] = localVertex(x + (corners[i] & 1),
+								y + ((corners[i] >> 1) & 1),
+								z + ((corners[i] >> 2) & 1));
+						}
+
+						for (int side = 0; side < 4; side++)
+							findNeighbor(element, hex, t, side, boundaries);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Sets the neighbor information of one side of a local element
+	 */
+	void findNeighbor(Element &element, const int hex[3], int tet, int side, const int boundaries[6])
+	{
+		static const int faces[4][3] = {
+				{0,2,1},
+				{0,1,3},
+				{0,3,2},
+				{1,2,3}
+		};
+
+		int corners[4];
+		tetCorners(tet, corners);
+
+		// Global vertices of this tetrahedron
+		int vertices[4];
+		for (int i = 0; i < 4; i++)
+			vertices[i] = globalVertex(hex, corners[i]);
+
+		// A face lies either inside the hexahedron or on one of its faces
+		int neighborHex[3] = {hex[0], hex[1], hex[2]};
+		for (int d = 0; d < 3; d++) {
+			int bits = 0;
+			for (int i = 0; i < 3; i++)
+				bits += (corners[faces[side][i]] >> d) & 1;
+
+			if (bits == 0 || bits == 3) {
+				neighborHex[d] += (bits == 0 ? -1 : 1);
+
+				if (neighborHex[d] < 0 || neighborHex[d] >= m_size[d]) {
+					// Domain boundary
+					element.neighbors[side] = 0;
+					element.neighborSides[side] = 0;
+					element.sideOrientations[side] = 0;
+					element.boundaries[side] = boundaries[d*2 + (bits == 0 ? 0 : 1)];
+					element.neighborRanks[side] = m_rank;
+					element.mpiIndices[side] = -1;
+					return;
+				}
+				break;
+			}
+		}
+
+		// Find the tetrahedron in the neighboring hexahedron
+		for (int t = 0; t < 6; t++) {
+			if (neighborHex[0] == hex[0] && neighborHex[1] == hex[1] && neighborHex[2] == hex[2]
+					&& t == tet)
+				continue;
+
+			int neighborCorners[4];
+			tetCorners(t, neighborCorners);
+			int neighborVertices[4];
+			for (int i = 0; i < 4; i++)
+				neighborVertices[i] = globalVertex(neighborHex, neighborCorners[i]);
+
+			// Calculate connected side of the neighbor
+			// We use the fact that the sum of the vertices indices = side index + 3
+			int neighborSide = -3;
+			bool found = true;
+			for (int i = 0; i < 3; i++) {
+				int index = std::find(neighborVertices, neighborVertices+4, vertices[faces[side][i]]) - neighborVertices;
+				if (index == 4) {
+					found = false;
+					break;
+				}
+				neighborSide += index;
+			}
+			if (!found)
+				continue;
+
+			element.neighborSides[side] = neighborSide;
+			element.sideOrientations[side] = std::find(faces[neighborSide], faces[neighborSide]+3,
+					std::find(neighborVertices, neighborVertices+4, vertices[faces[side][0]]) - neighborVertices)
+					- faces[neighborSide];
+			element.boundaries[side] = 0;
+
+			int neighborRank = owner(neighborHex);
+			element.neighborRanks[side] = neighborRank;
+			if (neighborRank == m_rank) {
+				element.neighbors[side] = localElement(neighborHex, t);
+				element.mpiIndices[side] = -1;
+			} else {
+				element.neighbors[side] = m_elements.size();
+
+				MPINeighborElement neighbor = {element.localId, side, globalElement(neighborHex, t), neighborSide};
+				m_MPINeighbors[neighborRank].elements.push_back(neighbor);
+			}
+			return;
+		}
+
+		logError() << "Cube generator could not find the neighbor of element" << element.localId << "side" << side;
+	}
+
+	/**
+	 * Relative height of a vertex layer in [0,1]
+	 */
+	double height(int layer, double grading) const
+	{
+		if (std::abs(grading - 1.) < 1e-10)
+			return static_cast<double>(layer) / m_size[2];
+
+		return (std::pow(grading, layer) - 1.) / (std::pow(grading, m_size[2]) - 1.);
+	}
+
+	/**
+	 * Rank of the partition that contains the hexahedron
+	 */
+	int owner(const int hex[3]) const
+	{
+		int p[3];
+		for (int i = 0; i < 3; i++)
+			p[i] = static_cast<int>((static_cast<long long>(hex[i]+1) * m_partitions[i] - 1) / m_size[i]);
+
+		return (p[2]*m_partitions[1] + p[1])*m_partitions[0] + p[0];
+	}
+
+	int localVertex(int x, int y, int z) const
+	{
+		int localSize[2] = {m_end[0]-m_start[0]+1, m_end[1]-m_start[1]+1};
+		return ((z-m_start[2])*localSize[1] + (y-m_start[1]))*localSize[0] + (x-m_start[0]);
+	}
+
+	int globalVertex(const int hex[3], int corner) const
+	{
+		return ((hex[2] + ((corner >> 2) & 1))*(m_size[1]+1) + hex[1] + ((corner >> 1) & 1))*(m_size[0]+1)
+				+ hex[0] + (corner & 1);
+	}
+
+	int localElement(const int hex[3], int tet) const
+	{
+		int localSize[2] = {m_end[0]-m_start[0], m_end[1]-m_start[1]};
+		return (((hex[2]-m_start[2])*localSize[1] + (hex[1]-m_start[1]))*localSize[0] + (hex[0]-m_start[0]))*6 + tet;
+	}
+
+	/**
+	 * Global element id, the local order of the elements matches the global order
+	 */
+	int globalElement(const int hex[3], int tet) const
+	{
+		return ((hex[2]*m_size[1] + hex[1])*m_size[0] + hex[0])*6 + tet;
+	}
+
+	/**
+	 * Gets the corners (bit 0: x, bit 1: y, bit 2: z) of a tetrahedron in the hexahedron.
+	 * The tetrahedra follow the paths from corner 0 to corner 7 along the edges;
+	 * vertices of odd permutations are swapped to get positively oriented tetrahedra.
+	 */
+	static void tetCorners(int tet, int corners[4])
+	{
+		static const int permutations[6][3] = {
+				{0,1,2},
+				{1,2,0},
+				{2,0,1},
+				{0,2,1},
+				{2,1,0},
+				{1,0,2}
+		};
+
+		corners[0] = 0;
+		corners[1] = 1 << permutations[tet][0];
+		corners[2] = corners[1] | (1 << permutations[tet][1]);
+		corners[3] = 7;
+
+		if (tet >= 3)
+			std::swap(corners[1], corners[2]);
+	}
+};
+
+#endif // CUBE_GENERATOR_H
@@ -46,7 +46,6 @@
 #endif
 
 #include "MeshReader.h"
-#include "vectors.h"
 
 #include "utils/stringutils.h"
 #include "utils/logger.h"
@@ -129,11 +128,11 @@ public:
 			abort();
 
 		// Count size of the local partition
-		int l = 0;
+		m_hasGlobalElementIds = true;
 		for (int i = 0; i < m_nGlobElements; i++) {
 			int elementRank = nextRank();
 			if (elementRank == rank)
-				m_g2lElements[i] = l++;
+				m_globalElementIds.push_back(i);
 		}
 
 		// Find the seek positions for all sections, read local elements and find local vertices
@@ -159,18 +158,19 @@ public:
 			m_mesh >> std::ws; // Skip white spaces
 		}
 
+		// Find global to local mapping of vertices
+		findLocalVertices();
+		buildVertexElements();
+
 		// Find neighbor MPI ranks
 		parseMPINeighborElements();
 
 		// Find local neighbor elements
 		parseLocalNeighborElements();
 
-		// Find global to local mapping of vertices
+		// Read coordinates of the local vertices
 		parseLocalCoordinates();
 
-		// Translate global vertices to local
-		translateG2LVertices();
-
 		// Sort neighbor lists
 		sortMPINeighborElements();
 	}
@@ -188,7 +188,7 @@ private:
 #endif // PARALLEL
 		// Do not seek the mesh file, we should be at the correct position
 
-		m_elements.resize(m_g2lElements.size());
+		m_elements.resize(m_globalElementIds.size());
 		int k = 0;
 		for (int i = 0; i < m_nGlobElements; i++) {
 			std::string line;
@@ -210,20 +210,6 @@ private:
 					m_mesh >> m_elements[k].vertices[j];
 					m_elements[k].vertices[j]--;
 
-					if (m_g2lVertices.find(m_elements[k].vertices[j]) == m_g2lVertices.end()) {
-						// First time we see this vertex
-						// put it in the g2l map and resize the vertex list
-						int nextVertex = m_g2lVertices.size();
-						m_g2lVertices[m_elements[k].vertices[j]] = nextVertex;
-
-						assert(m_vertices.size() == m_g2lVertices.size() - 1);
-
-						m_vertices.resize(m_g2lVertices.size());
-					}
-
-					// Add this element to the vertex list
-					m_vertices[m_g2lVertices[m_elements[k].vertices[j]]].elements.push_back(k);
-
 					m_elements[k].rank = m_rank;
 					m_elements[k].neighbors[j] = -1;
 					m_elements[k].boundaries[j] = 0;
@@ -270,9 +256,9 @@ private:
 			m_mesh >> n; // Element number
 			n--;
 
-			std::map<int, int>::const_iterator e = m_g2lElements.find(n);
+			int e = g2lElement(n);
 
-			if (e != m_g2lElements.end()) {
+			if (e >= 0) {
 				int t;
 				m_mesh >> t; // Element type
 				if (t != 6)
@@ -285,9 +271,9 @@ private:
 				if (boundaryCondition != 3)
 					// We still need to find the neighboring element
 					// for DR boundaries
-					m_elements[e->second].neighbors[s] = 0; // 0: at least a valid value for periodic boundaries
-				m_elements[e->second].neighborRanks[s] = m_rank;
-				m_elements[e->second].boundaries[s] = boundaryCondition;
+					m_elements[e].neighbors[s] = 0; // 0: at least a valid value for periodic boundaries
+				m_elements[e].neighborRanks[s] = m_rank;
+				m_elements[e].boundaries[s] = boundaryCondition;
 
 				m_mesh >> std::ws; // Skip rest of the line
 			} else {
@@ -322,8 +308,9 @@ private:
 		for (int i = 0; i < groupSize; i++) {
 			int element;
 			m_mesh >> element;
-			if (m_g2lElements.find(element-1) != m_g2lElements.end())
-				m_elements[m_g2lElements[element-1]].material = groupId;
+			int e = g2lElement(element-1);
+			if (e >= 0)
+				m_elements[e].material = groupId;
 		}
 
 		m_mesh >> std::ws;
@@ -359,9 +346,9 @@ private:
 				int commonVertices = 0;
 				for (int j = 0; j < 4; j++) {
 					m_mesh >> element.vertices[j];
-					element.vertices[j]--;
+					element.vertices[j] = g2lVertex(element.vertices[j]-1);
 
-					if (m_g2lVertices.find(element.vertices[j]) != m_g2lVertices.end())
+					if (element.vertices[j] >= 0)
 						commonVertices++;
 
 					// Set neighbor rank to -1, otherwise findAndUpdateNeighbors will skip the side
@@ -409,16 +396,16 @@ private:
 		m_mesh.clear();
 		m_mesh.seekg(m_seekVertices);
 
-		std::map<int, int>::iterator iter = m_g2lVertices.begin();
+		unsigned int v = 0;
 		for (int i = 0; i < m_nGlobVertices; i++) {
-			if (iter != m_g2lVertices.end() && i == iter->first) {
+			if (v < m_globalVertexIds.size() && i == m_globalVertexIds[v]) {
 				int n;
 
 				m_mesh >> n;	// Vertex number
 				for (int j = 0; j < 3; j++)
-					m_mesh >> m_vertices[iter->second].coords[j];
+					m_mesh >> m_vertices[v].coords[j];
 
-				iter++;
+				v++;
 
 				m_mesh >> std::ws; // Skip rest of the line
 			} else {
@@ -436,167 +423,6 @@ private:
 			abort();
 	}
 
-	void translateG2LVertices()
-	{
-		for (std::vector<Element>::iterator i = m_elements.begin();
-				i != m_elements.end(); i++) {
-			for (int j = 0; j < 4; j++)
-				i->vertices[j] = m_g2lVertices[i->vertices[j]];
-		}
-	}
-
-	void sortMPINeighborElements()
-	{
-		std::map<int, MPINeighbor>::iterator iter = m_MPINeighbors.begin();
-		for (unsigned int i = 0; i < m_MPINeighbors.size(); i++) {
-			iter->second.localID = i;
-
-			if (iter->first > m_rank)
-				std::sort(iter->second.elements.begin(), iter->second.elements.end(), compareLocalMPINeighbor);
-			else
-				std::sort(iter->second.elements.begin(), iter->second.elements.end(), compareRemoteMPINeighbor);
-
-			// Set the MPI number of all elements
-			for (unsigned int j = 0; j < iter->second.elements.size(); j++) {
-				m_elements[iter->second.elements[j].localElement].mpiIndices[iter->second.elements[j].localSide]
-				    = j;
-			}
-
-			iter++;
-		}
-	}
-
-	/**
-	 *
-	 */
-	void findAndUpdateNeighbors(Element &element)
-	{
-		// Find all elements that share one vertices with element
-		std::map<int, int>::iterator potNeighbors[4];
-		for (int i = 0; i < 4; i++) {
-				potNeighbors[i] = m_g2lVertices.find(element.vertices[i]);
-		}
-
-		if (!(potNeighbors[0] == m_g2lVertices.end()
-			|| potNeighbors[1] == m_g2lVertices.end()
-			|| potNeighbors[2] == m_g2lVertices.end()
-			|| element.neighbors[0] >= 0)) {
-			// Find face 0 neighbor
-
-			std::vector<int>& n0 = m_vertices[potNeighbors[0]->second].elements;
-			std::vector<int>& n1 = m_vertices[potNeighbors[1]->second].elements;
-			std::vector<int>& n2 = m_vertices[potNeighbors[2]->second].elements;
-
-			std::vector<int>::const_iterator neighbor = n0.begin();
-			intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end() && &element == &m_elements[*neighbor])
-				// Found same element -> search for next
-				intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end()) {
-				updateNeighbor(element, m_elements[*neighbor], 0);
-			}
-		}
-
-		if (!(potNeighbors[0] == m_g2lVertices.end()
-			|| potNeighbors[1] == m_g2lVertices.end()
-			|| potNeighbors[3] == m_g2lVertices.end()
-			|| element.neighbors[1] >= 0)) {
-			// Find face 1 neighbor
-
-			std::vector<int>& n0 = m_vertices[potNeighbors[0]->second].elements;
-			std::vector<int>& n1 = m_vertices[potNeighbors[1]->second].elements;
-			std::vector<int>& n2 = m_vertices[potNeighbors[3]->second].elements;
-
-			std::vector<int>::const_iterator neighbor = n0.begin();
-			intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end() && &element == &m_elements[*neighbor])
-				// Found same element -> search for next
-				intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end()) {
-				updateNeighbor(element, m_elements[*neighbor], 1);
-			}
-		}
-
-		if (!(potNeighbors[0] == m_g2lVertices.end()
-			|| potNeighbors[2] == m_g2lVertices.end()
-			|| potNeighbors[3] == m_g2lVertices.end()
-			|| element.neighbors[2] >= 0)) {
-			// Find face 2 neighbor
-
-			std::vector<int>& n0 = m_vertices[potNeighbors[0]->second].elements;
-			std::vector<int>& n1 = m_vertices[potNeighbors[2]->second].elements;
-			std::vector<int>& n2 = m_vertices[potNeighbors[3]->second].elements;
-
-			std::vector<int>::const_iterator neighbor = n0.begin();
-			intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end() && &element == &m_elements[*neighbor])
-				// Found same element -> search for next
-				intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end()) {
-				updateNeighbor(element, m_elements[*neighbor], 2);
-			}
-		}
-
-		if (!(potNeighbors[1] == m_g2lVertices.end()
-			|| potNeighbors[2] == m_g2lVertices.end()
-			|| potNeighbors[3] == m_g2lVertices.end()
-			|| element.neighbors[3] >= 0)) {
-			// Find face 3 neighbor
-
-			std::vector<int>& n0 = m_vertices[potNeighbors[1]->second].elements;
-			std::vector<int>& n1 = m_vertices[potNeighbors[2]->second].elements;
-			std::vector<int>& n2 = m_vertices[potNeighbors[3]->second].elements;
-
-			std::vector<int>::const_iterator neighbor = n0.begin();
-			intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end() && &element == &m_elements[*neighbor])
-				// Found same element -> search for next
-				intersection(neighbor, n0.end(), n1, n2);
-
-			if (neighbor != n0.end()) {
-				updateNeighbor(element, m_elements[*neighbor], 3);
-			}
-		}
-	}
-
-	void updateNeighbor(Element &elem1, Element &elem2, int side1)
-	{
-		static const int faces[4][3] = {
-				{0,2,1},
-				{0,1,3},
-				{0,3,2},
-				{1,2,3}
-		};
-
-		// Calculate connected side of element 2
-		// We use the fact that the sum of the vertices indices = side index + 3
-		int side2 = -3;
-		for (int i = 0; i < 3; i++) {
-			side2 += std::find(elem2.vertices, elem2.vertices+4, elem1.vertices[faces[side1][i]]) - elem2.vertices;
-		}
-
-		elem1.neighbors[side1] = elem2.localId;
-		elem1.neighborSides[side1] = side2;
-		elem1.sideOrientations[side1] = std::find(faces[side2], faces[side2]+3,
-				std::find(elem2.vertices, elem2.vertices+4, elem1.vertices[faces[side1][0]]) - elem2.vertices)
-				- faces[side2];
-		elem1.neighborRanks[side1] = elem2.rank;
-
-		elem2.neighbors[side2] = elem1.localId;
-		elem2.neighborSides[side2] = side1;
-		elem2.sideOrientations[side2] = std::find(faces[side1], faces[side1]+3,
-				std::find(elem1.vertices, elem1.vertices+4, elem2.vertices[faces[side2][0]]) - elem1.vertices)
-				- faces[side1];
-		elem2.neighborRanks[side2] = elem1.rank;
-	}
-
 	/**
 	 * @return The next rank from the partition file or 0 if MPI not compiled with MPI
 	 */
@@ -611,7 +437,8 @@ private:
 		return rank;
 	}
 
-private:
+public:
+	// Identifiers of the file and the sections (also used by the parallel reader)
 	static const char* GAMBIT_FILE_ID;
 	static const char* ENDSECTION;
 	static const char* NODAL_COORDINATES;
@@ -73,8 +73,32 @@ typedef double VrtxCoords[3];
 
 struct Vertex {
 	VrtxCoords coords;
-	/** Elements sharing this neighbor */
-	std::vector<int> elements;
+};
+
+/** Local elements sharing a vertex (view into the vertex-element adjacency of the mesh) */
+struct VertexElements {
+	const int* first;
+	const int* last;
+
+	unsigned int size() const
+	{
+		return last - first;
+	}
+
+	int operator[](unsigned int i) const
+	{
+		return first[i];
+	}
+
+	const int* begin() const
+	{
+		return first;
+	}
+
+	const int* end() const
+	{
+		return last;
+	}
 };
 
 struct MPINeighborElement {
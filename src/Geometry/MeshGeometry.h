@@ -0,0 +1,189 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (rettenbs AT in.tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger,_M.Sc.)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Compact, read-only copy of the local mesh geometry
+ **/
+
+#ifndef MESH_GEOMETRY_H
+#define MESH_GEOMETRY_H
+
+#include <vector>
+
+#include "MeshReader.h"
+
+/**
+ * Stores the vertex coordinates and the element connectivity of the
+ * local mesh partition.
+ *
+ * The mesh reader holds neighbor, MPI and fault information that is only
+ * required during the initialization. This class keeps the part of the mesh
+ * that output modules (wave field and free surface output) need, so they can
+ * be initialized after the mesh reader was freed.
+ *
+ * Besides the connectivity only the free surface faces are stored
+ * (as a bit mask per element), since the surface output and the wave field
+ * output region depend on them. Coordinates can optionally be stored
+ * in single precision.
+ */
+class MeshGeometry
+{
+protected:
+	/** Vertex ids of each element (4 per element) */
+	std::vector<int> m_cells;
+
+	/** Vertex coordinates in double precision (3 per vertex) */
+	std::vector<double> m_coords;
+
+	/** Vertex coordinates in single precision (only if enabled) */
+	std::vector<float> m_coordsSingle;
+
+	/** Free surface faces of each element: bit i is set if face i is a free surface */
+	std::vector<unsigned char> m_freeSurfaces;
+
+protected:
+	MeshGeometry()
+	{
+	}
+
+public:
+	/**
+	 * @param singlePrecision Store the coordinates in single precision
+	 */
+	MeshGeometry(const MeshReader &meshReader, bool singlePrecision = false)
+	{
+		const std::vector<Element> &elements = meshReader.getElements();
+		const std::vector<Vertex> &vertices = meshReader.getVertices();
+
+		m_cells.resize(elements.size() * 4);
+		m_freeSurfaces.resize(elements.size());
+		for (unsigned int i = 0; i < elements.size(); i++) {
+			unsigned char freeSurface = 0;
+			for (unsigned int j = 0; j < 4; j++) {
+				m_cells[i*4 + j] = elements[i].vertices[j];
+				if (elements[i].boundaries[j] == 1)
+					freeSurface |= 1 << j;
+			}
+			m_freeSurfaces[i] = freeSurface;
+		}
+
+		if (singlePrecision) {
+			m_coordsSingle.resize(vertices.size() * 3);
+			for (unsigned int i = 0; i < vertices.size(); i++) {
+				for (unsigned int j = 0; j < 3; j++)
+					m_coordsSingle[i*3 + j] = vertices[i].coords[j];
+			}
+		} else {
+			m_coords.resize(vertices.size() * 3);
+			for (unsigned int i = 0; i < vertices.size(); i++) {
+				for (unsigned int j = 0; j < 3; j++)
+					m_coords[i*3 + j] = vertices[i].coords[j];
+			}
+		}
+	}
+
+	unsigned int nElements() const
+	{
+		return m_freeSurfaces.size();
+	}
+
+	unsigned int nVertices() const
+	{
+		return (m_coords.size() + m_coordsSingle.size()) / 3;
+	}
+
+	/**
+	 * @return The vertex ids of an element
+	 */
+	const int* cell(unsigned int element) const
+	{
+		return &m_cells[element*4];
+	}
+
+	/**
+	 * @return True if a face of an element is a free surface
+	 */
+	bool isFreeSurface(unsigned int element, unsigned int face) const
+	{
+		return (m_freeSurfaces[element] >> face) & 1;
+	}
+
+	/**
+	 * Get the coordinates of a vertex
+	 */
+	void vertex(unsigned int vertex, VrtxCoords coords) const
+	{
+		if (m_coordsSingle.empty()) {
+			for (unsigned int i = 0; i < 3; i++)
+				coords[i] = m_coords[vertex*3 + i];
+		} else {
+			for (unsigned int i = 0; i < 3; i++)
+				coords[i] = m_coordsSingle[vertex*3 + i];
+		}
+	}
+
+	/**
+	 * Computes the barycenter of an element
+	 */
+	void center(unsigned int element, VrtxCoords center) const
+	{
+		center[0] = center[1] = center[2] = 0;
+		for (unsigned int i = 0; i < 4; i++) {
+			VrtxCoords coords;
+			vertex(m_cells[element*4 + i], coords);
+			for (unsigned int j = 0; j < 3; j++)
+				center[j] += .25 * coords[j];
+		}
+	}
+
+	bool isSinglePrecision() const
+	{
+		return !m_coordsSingle.empty();
+	}
+
+	/**
+	 * @return The number of bytes used by the geometry
+	 */
+	unsigned long memoryUsage() const
+	{
+		return m_cells.size() * sizeof(int)
+			+ m_coords.size() * sizeof(double)
+			+ m_coordsSingle.size() * sizeof(float)
+			+ m_freeSurfaces.size() * sizeof(unsigned char);
+	}
+};
+
+#endif // MESH_GEOMETRY_H
@@ -58,11 +58,23 @@ protected:
 
 	std::vector<Vertex> m_vertices;
 
-	/** Convert global element index to local */
-	std::map<int, int> m_g2lElements;
+	/** Offsets into m_vertexElements for each vertex (and the total size) */
+	std::vector<int> m_vertexElementOffsets;
 
-	/** Convert global vertex index to local */
-	std::map<int, int> m_g2lVertices;
+	/** Local elements sharing a vertex, for all vertices */
+	std::vector<int> m_vertexElements;
+
+	/** Global id of each local element (empty if the reader has no global ids) */
+	std::vector<int> m_globalElementIds;
+
+	/** True if the reader provides global element ids (even for an empty partition) */
+	bool m_hasGlobalElementIds;
+
+	/**
+	 * Global id of each local vertex (sorted, only used by readers that
+	 * translate global vertex ids)
+	 */
+	std::vector<int> m_globalVertexIds;
 
 	/** Number of MPI neighbors */
 	std::map<int, MPINeighbor> m_MPINeighbors;
@@ -78,7 +90,7 @@ protected:
 
 protected:
 	MeshReader(int rank)
-		: m_rank(rank), m_hasPlusFault(false)
+		: m_rank(rank), m_hasGlobalElementIds(false), m_hasPlusFault(false)
 	{}
 
 public:
@@ -96,6 +108,45 @@ public:
 		return m_vertices;
 	}
 
+	/**
+	 * @return The local elements sharing a vertex, sorted by their local id
+	 */
+	VertexElements getVertexElements(int vertex) const
+	{
+		VertexElements elements = {&m_vertexElements[0] + m_vertexElementOffsets[vertex],
+			&m_vertexElements[0] + m_vertexElementOffsets[vertex+1]};
+		return elements;
+	}
+
+	/**
+	 * @return The maximum number of elements sharing one vertex
+	 */
+	unsigned int getMaxVertexElements() const
+	{
+		unsigned int maxElements = 0;
+		for (unsigned int i = 0; i < m_vertices.size(); i++)
+			maxElements = std::max(maxElements, getVertexElements(i).size());
+		return maxElements;
+	}
+
+	/**
+	 * @return The global id of each local element or an empty vector if
+	 *  the global ids are not known (e.g. for pre-partitioned meshes)
+	 */
+	const std::vector<int>& getGlobalElementIds() const
+	{
+		return m_globalElementIds;
+	}
+
+	/**
+	 * @return True if the reader provides global element ids. Partitions
+	 *  without elements still return true.
+	 */
+	bool hasGlobalElementIds() const
+	{
+		return m_hasGlobalElementIds;
+	}
+
 	const std::map<int, MPINeighbor>& getMPINeighbors() const
 	{
 		return m_MPINeighbors;
@@ -116,6 +167,25 @@ public:
 		return m_hasPlusFault;
 	}
 
+	/**
+	 * @return The (approximate) number of bytes used by the mesh data
+	 */
+	unsigned long memoryUsage() const
+	{
+		unsigned long usage = m_elements.size() * sizeof(Element)
+			+ m_vertices.size() * sizeof(Vertex)
+			+ (m_vertexElementOffsets.size() + m_vertexElements.size()
+				+ m_globalElementIds.size() + m_globalVertexIds.size()) * sizeof(int)
+			+ m_fault.size() * sizeof(Fault);
+		for (std::map<int, MPINeighbor>::const_iterator i = m_MPINeighbors.begin();
+				i != m_MPINeighbors.end(); i++)
+			usage += i->second.elements.size() * sizeof(MPINeighborElement);
+		for (std::map<int, std::vector<MPINeighborElement> >::const_iterator i = m_MPIFaultNeighbors.begin();
+				i != m_MPIFaultNeighbors.end(); i++)
+			usage += i->second.size() * sizeof(MPINeighborElement);
+		return usage;
+	}
+
 	/**
 	 * Reconstruct the fault information from the boundary conditions
 	 */
@@ -240,6 +310,201 @@ public:
 	}
 
 protected:
+	/**
+	 * Collects the vertices of all local elements and translates
+	 * the global vertex ids of the elements to local ids.
+	 *
+	 * The local vertices are sorted by their global id.
+	 */
+	void findLocalVertices()
+	{
+		m_globalVertexIds.resize(m_elements.size() * 4);
+		for (unsigned int i = 0; i < m_elements.size(); i++)
+			std::copy(m_elements[i].vertices, m_elements[i].vertices+4, &m_globalVertexIds[i*4]);
+
+		std::sort(m_globalVertexIds.begin(), m_globalVertexIds.end());
+		m_globalVertexIds.erase(std::unique(m_globalVertexIds.begin(), m_globalVertexIds.end()),
+			m_globalVertexIds.end());
+		// Release the unused memory
+		std::vector<int>(m_globalVertexIds).swap(m_globalVertexIds);
+
+		for (std::vector<Element>::iterator i = m_elements.begin();
+				i != m_elements.end(); i++) {
+			for (int j = 0; j < 4; j++)
+				i->vertices[j] = g2lVertex(i->vertices[j]);
+		}
+
+		m_vertices.resize(m_globalVertexIds.size());
+	}
+
+	/**
+	 * Computes the elements sharing each vertex
+	 *
+	 * The elements of each vertex are sorted by their local id.
+	 */
+	void buildVertexElements()
+	{
+		m_vertexElementOffsets.assign(m_vertices.size() + 1, 0);
+		for (std::vector<Element>::const_iterator i = m_elements.begin();
+				i != m_elements.end(); i++) {
+			for (int j = 0; j < 4; j++)
+				m_vertexElementOffsets[i->vertices[j] + 1]++;
+		}
+		for (unsigned int i = 1; i < m_vertexElementOffsets.size(); i++)
+			m_vertexElementOffsets[i] += m_vertexElementOffsets[i-1];
+
+		m_vertexElements.resize(m_elements.size() * 4);
+		std::vector<int> fill(m_vertexElementOffsets.begin(), m_vertexElementOffsets.end()-1);
+		for (std::vector<Element>::const_iterator i = m_elements.begin();
+				i != m_elements.end(); i++) {
+			for (int j = 0; j < 4; j++)
+				m_vertexElements[fill[i->vertices[j]]++] = i->localId;
+		}
+	}
+
+	/**
+	 * @return The local id of a global element or -1 if the element is not local
+	 */
+	int g2lElement(int globalId) const
+	{
+		return findId(m_globalElementIds, globalId);
+	}
+
+	/**
+	 * @return The local id of a global vertex or -1 if the vertex is not local
+	 */
+	int g2lVertex(int globalId) const
+	{
+		return findId(m_globalVertexIds, globalId);
+	}
+
+	/**
+	 * Finds the local neighbors of an element and updates both elements.
+	 *
+	 * The vertices of the element must be local ids (or -1 for vertices
+	 * not in the local domain).
+	 */
+	void findAndUpdateNeighbors(Element &element)
+	{
+		// Vertices of the faces (in the order of the sides)
+		static const int faces[4][3] = {
+				{0,1,2},
+				{0,1,3},
+				{0,2,3},
+				{1,2,3}
+		};
+
+		for (int i = 0; i < 4; i++) {
+			if (element.neighbors[i] >= 0)
+				continue;
+
+			const int v0 = element.vertices[faces[i][0]];
+			const int v1 = element.vertices[faces[i][1]];
+			const int v2 = element.vertices[faces[i][2]];
+			if (v0 < 0 || v1 < 0 || v2 < 0)
+				continue;
+
+			// Find all elements that share the vertices of the face
+			VertexElements n0 = getVertexElements(v0);
+			VertexElements n1 = getVertexElements(v1);
+			VertexElements n2 = getVertexElements(v2);
+
+			const int* neighbor = intersection(n0.begin(), n0.end(), n1, n2);
+
+			if (neighbor != n0.end() && &element == &m_elements[*neighbor])
+				// Found same element -> search for next
+				neighbor = intersection(neighbor+1, n0.end(), n1, n2);
+
+			if (neighbor != n0.end())
+				updateNeighbor(element, m_elements[*neighbor], i);
+		}
+	}
+
+	void updateNeighbor(Element &elem1, Element &elem2, int side1)
+	{
+		static const int faces[4][3] = {
+				{0,2,1},
+				{0,1,3},
+				{0,3,2},
+				{1,2,3}
+		};
+
+		// Calculate connected side of element 2
+		// We use the fact that the sum of the vertices indices = side index + 3
+		int side2 = -3;
+		for (int i = 0; i < 3; i++) {
+			side2 += std::find(elem2.vertices, elem2.vertices+4, elem1.vertices[faces[side1][i]]) - elem2.vertices;
+		}
+
+		elem1.neighbors[side1] = elem2.localId;
+		elem1.neighborSides[side1] = side2;
+		elem1.sideOrientations[side1] = std::find(faces[side2], faces[side2]+3,
+				std::find(elem2.vertices, elem2.vertices+4, elem1.vertices[faces[side1][0]]) - elem2.vertices)
+				- faces[side2];
+		elem1.neighborRanks[side1] = elem2.rank;
+
+		elem2.neighbors[side2] = elem1.localId;
+		elem2.neighborSides[side2] = side1;
+		elem2.sideOrientations[side2] = std::find(faces[side1], faces[side1]+3,
+				std::find(elem1.vertices, elem1.vertices+4, elem2.vertices[faces[side2][0]]) - elem1.vertices)
+				- faces[side1];
+		elem2.neighborRanks[side2] = elem1.rank;
+	}
+
+	/**
+	 * Sorts the elements of all MPI neighbors and sets the MPI indices of the elements.
+	 *
+	 * Requires that the local element order matches the global element order and
+	 * that the neighbor element ids of the MPI neighbor elements are global ids.
+	 */
+	void sortMPINeighborElements()
+	{
+		std::map<int, MPINeighbor>::iterator iter = m_MPINeighbors.begin();
+		for (unsigned int i = 0; i < m_MPINeighbors.size(); i++) {
+			iter->second.localID = i;
+
+			if (iter->first > m_rank)
+				std::sort(iter->second.elements.begin(), iter->second.elements.end(), compareLocalMPINeighbor);
+			else
+				std::sort(iter->second.elements.begin(), iter->second.elements.end(), compareRemoteMPINeighbor);
+
+			// Set the MPI number of all elements
+			for (unsigned int j = 0; j < iter->second.elements.size(); j++) {
+				m_elements[iter->second.elements[j].localElement].mpiIndices[iter->second.elements[j].localSide]
+				    = j;
+			}
+
+			iter++;
+		}
+	}
+
+	/**
+	 * @return The first element in [first, last) which is also part of v2 and v3
+	 *  or last if there is no such element
+	 */
+	static const int* intersection(const int* first, const int* last,
+		const VertexElements &v2, const VertexElements &v3)
+	{
+		for (; first != last; first++) {
+			if (std::find(v2.begin(), v2.end(), *first) != v2.end()
+					&& std::find(v3.begin(), v3.end(), *first) != v3.end())
+				return first;
+		}
+
+		return last;
+	}
+
+	/**
+	 * @return The position of id in the sorted vector ids or -1 if id is not found
+	 */
+	static int findId(const std::vector<int> &ids, int id)
+	{
+		std::vector<int>::const_iterator i = std::lower_bound(ids.begin(), ids.end(), id);
+		if (i == ids.end() || *i != id)
+			return -1;
+		return i - ids.begin();
+	}
+
 	static bool compareLocalMPINeighbor(const MPINeighborElement &elem1, const MPINeighborElement &elem2)
 	{
 		return (elem1.localElement < elem2.localElement)
@@ -75,6 +75,21 @@ module MeshReaderCBinding
             character( kind=c_char ), dimension(*), intent(in) :: meshfile
             logical( kind=c_bool ), value                      :: hasFault
         end subroutine
+
+        subroutine read_mesh_cube_c(rank, nprocs, cubeSize, partitions, scale, grading, boundaries, materialLayer, hasFault) \
+                bind(C, name="read_mesh_cube_c")
+            use, intrinsic :: iso_c_binding
+
+            integer( kind=c_int ), value                       :: rank
+            integer( kind=c_int ), value                       :: nprocs
+            integer( kind=c_int ), dimension(*), intent(in)    :: cubeSize
+            integer( kind=c_int ), dimension(*), intent(in)    :: partitions
+            real( kind=c_double ), dimension(*), intent(in)    :: scale
+            real( kind=c_double ), value                       :: grading
+            integer( kind=c_int ), dimension(*), intent(in)    :: boundaries
+            real( kind=c_double ), value                       :: materialLayer
+            logical( kind=c_bool ), value                      :: hasFault
+        end subroutine
     end interface
 
 contains
@@ -116,6 +131,15 @@ contains
 #else
             call read_mesh_netcdf_c(0, 1, trim(io%MeshFile) // c_null_char, hasFault)
 #endif
+        elseif (io%meshgenerator .eq. 'CubeGenerator') then
+#ifdef PARALLEL
+            call read_mesh_cube_c(mpi%myRank, mpi%nCPU, &
+#else
+            call read_mesh_cube_c(0, 1, &
+#endif
+                int(io%cube%size, c_int), int(io%cube%partitions, c_int), real(io%cube%scale, c_double), &
+                real(io%cube%grading, c_double), int(io%cube%boundaries, c_int), &
+                real(io%cube%materialLayer, c_double), hasFault)
         else
             logError(*) 'Unknown mesh reader'
             stop
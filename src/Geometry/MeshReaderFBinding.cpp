@@ -37,6 +37,8 @@
 
 #include "MeshReaderFBinding.h"
 #include "GambitReader.h"
+#include "ParallelGambitReader.h"
+#include "CubeGenerator.h"
 #ifdef USE_NETCDF
 #include "NetcdfReader.h"
 #endif // USE_NETCDF
@@ -58,10 +60,7 @@ void read_mesh(int rank, MeshReader &meshReader, bool hasFault)
 	const std::map<int, MPINeighbor>& mpiNeighbors = meshReader.getMPINeighbors();
 
 	// Compute maximum element for one vertex
-	size_t maxElements = 0;
-	for (std::vector<Vertex>::const_iterator i = vertices.begin();
-			i != vertices.end(); i++)
-		maxElements = std::max(maxElements, i->elements.size());
+	size_t maxElements = meshReader.getMaxVertexElements();
 
 	allocelements(elements.size());
 	allocvertices(vertices.size(), maxElements);
@@ -80,10 +79,11 @@ void read_mesh(int rank, MeshReader &meshReader, bool hasFault)
 			verticesXY[i*3+j] = vertices[i].coords[j];
 		}
 
-		verticesNElements[i] = vertices[i].elements.size();
+		VertexElements vertexElements = meshReader.getVertexElements(i);
+		verticesNElements[i] = vertexElements.size();
 
-		for (unsigned int j = 0; j < vertices[i].elements.size(); j++) {
-			verticesElements[i+j*vertices.size()] = vertices[i].elements[j] + 1;
+		for (unsigned int j = 0; j < vertexElements.size(); j++) {
+			verticesElements[i+j*vertices.size()] = vertexElements[j] + 1;
 		}
 	}
 
@@ -234,7 +234,11 @@ void read_mesh_gambitfast_c(int rank, const char* meshfile, const char* partitio
 	logInfo(rank) << "Reading Gambit mesh using fast reader";
 	logInfo(rank) << "Parsing mesh and partition file:" << meshfile << ';' << partitionfile;
 
+#ifdef USE_MPI
+	seissol::SeisSol::main.setMeshReader(new ParallelGambitReader(rank, meshfile, partitionfile));
+#else // USE_MPI
 	seissol::SeisSol::main.setMeshReader(new GambitReader(rank, meshfile, partitionfile));
+#endif // USE_MPI
 
 	read_mesh(rank, seissol::SeisSol::main.meshReader(), hasFault);
 }
@@ -252,4 +256,15 @@ void read_mesh_netcdf_c(int rank, int nProcs, const char* meshfile, bool hasFaul
 #endif // USE_NETCDF
 }
 
+void read_mesh_cube_c(int rank, int nProcs, const int* size, const int* partitions, const double* scale,
+		double grading, const int* boundaries, double materialLayer, bool hasFault)
+{
+	logInfo(rank) << "Generating cube mesh";
+
+	seissol::SeisSol::main.setMeshReader(new CubeGenerator(rank, nProcs, size, partitions, scale,
+		grading, boundaries, materialLayer));
+
+	read_mesh(rank, seissol::SeisSol::main.meshReader(), hasFault);
+}
+
 }
@@ -0,0 +1,111 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * A subset of the elements of a mesh, e.g. for output of a region
+ **/
+
+#ifndef MESH_SUBSET_H
+#define MESH_SUBSET_H
+
+#include <vector>
+
+#include "MeshGeometry.h"
+
+/**
+ * Contains the selected elements of another mesh geometry and the vertices
+ * used by them. Coordinates keep the precision of the original geometry.
+ */
+class MeshSubset : public MeshGeometry
+{
+private:
+	/** Element ids in the original mesh */
+	std::vector<unsigned int> m_originalIds;
+
+public:
+	/**
+	 * @param selected True for each element of the original mesh that should be included
+	 */
+	MeshSubset(const MeshGeometry &mesh, const std::vector<bool> &selected)
+	{
+		std::vector<int> vertexIds(mesh.nVertices(), -1);
+		std::vector<unsigned int> usedVertices;
+
+		for (unsigned int i = 0; i < mesh.nElements(); i++) {
+			if (!selected[i])
+				continue;
+
+			unsigned char freeSurface = 0;
+			for (unsigned int j = 0; j < 4; j++) {
+				int &vertex = vertexIds[mesh.cell(i)[j]];
+				if (vertex < 0) {
+					vertex = usedVertices.size();
+					usedVertices.push_back(mesh.cell(i)[j]);
+				}
+
+				m_cells.push_back(vertex);
+				if (mesh.isFreeSurface(i, j))
+					freeSurface |= 1 << j;
+			}
+
+			m_freeSurfaces.push_back(freeSurface);
+			m_originalIds.push_back(i);
+		}
+
+		if (mesh.isSinglePrecision())
+			m_coordsSingle.resize(usedVertices.size() * 3);
+		else
+			m_coords.resize(usedVertices.size() * 3);
+		for (unsigned int i = 0; i < usedVertices.size(); i++) {
+			VrtxCoords coords;
+			mesh.vertex(usedVertices[i], coords);
+			for (unsigned int j = 0; j < 3; j++) {
+				if (mesh.isSinglePrecision())
+					m_coordsSingle[i*3 + j] = coords[j];
+				else
+					m_coords[i*3 + j] = coords[j];
+			}
+		}
+	}
+
+	/**
+	 * @return The ids of the elements in the original mesh
+	 */
+	const std::vector<unsigned int>& originalIds() const
+	{
+		return m_originalIds;
+	}
+};
+
+#endif // MESH_SUBSET_H
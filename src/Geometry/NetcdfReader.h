@@ -161,66 +161,53 @@ public:
 
 		logInfo(rank) << "Start reading mesh from netCDF file";
 
+#ifdef USE_MPI
+		double startTime = MPI_Wtime();
+#endif // USE_MPI
+		unsigned long bytesRead = 0;
+
 		// Elements
 		size_t start[3] = {rank, 0, 0};
 		int size;
 		checkNcError(nc_get_var1_int(ncFile, ncVarElemSize, start, &size));
 
-		ElemVertices* elemVertices = new ElemVertices[size];
-		ElemNeighbors* elemNeighbors = new ElemNeighbors[size];
-		ElemNeighborSides* elemNeighborSides = new ElemNeighborSides[size];
-		ElemSideOrientations* elemSideOrientations = new ElemSideOrientations[size];
-		ElemBoundaries* elemBoundaries = new ElemBoundaries[size];
-		ElemNeighborRanks* elemNeighborRanks = new ElemNeighborRanks[size];
-		ElemMPIIndices* elemMPIIndices = new ElemMPIIndices[size];
-		ElemMaterial* elemMaterial = new ElemMaterial[size];
-
 		m_elements.resize(size);
+		for (int i = 0; i < size; i++)
+			m_elements[i].localId = i;
+
+		// All element variables are read into the same buffer and
+		// copied to the elements immediately
+		int* elemBuffer = new int[size*4];
 
 		EPIK_USER_REG(r_read_elements, "read_elements");
 		SCOREP_USER_REGION_DEFINE( r_read_elements )
 		EPIK_USER_START(r_read_elements);
 		SCOREP_USER_REGION_BEGIN( r_read_elements, "read_elements", SCOREP_USER_REGION_TYPE_COMMON )
-		// Read element buffers from netcdf
+		// Read element variables from netcdf
 		size_t count[3] = {1, size, 4};
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemVertices, start, count, reinterpret_cast<int*>(elemVertices)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemNeighbors, start, count, reinterpret_cast<int*>(elemNeighbors)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemNeighborSides, start, count, reinterpret_cast<int*>(elemNeighborSides)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemSideOrientations, start, count, reinterpret_cast<int*>(elemSideOrientations)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemBoundaries, start, count, reinterpret_cast<int*>(elemBoundaries)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemNeighborRanks, start, count, reinterpret_cast<int*>(elemNeighborRanks)));
-		checkNcError(nc_get_vara_int(ncFile, ncVarElemMPIIndices, start, count, reinterpret_cast<int*>(elemMPIIndices)));
-		if (hasGroup)
-			checkNcError(nc_get_vara_int(ncFile, ncVarElemGroup, start, count, reinterpret_cast<int*>(elemMaterial)));
+		bytesRead += readElementVariable(ncFile, ncVarElemVertices, start, count, elemBuffer, &Element::vertices);
+		bytesRead += readElementVariable(ncFile, ncVarElemNeighbors, start, count, elemBuffer, &Element::neighbors);
+		bytesRead += readElementVariable(ncFile, ncVarElemNeighborSides, start, count, elemBuffer, &Element::neighborSides);
+		bytesRead += readElementVariable(ncFile, ncVarElemSideOrientations, start, count, elemBuffer, &Element::sideOrientations);
+		bytesRead += readElementVariable(ncFile, ncVarElemBoundaries, start, count, elemBuffer, &Element::boundaries);
+		bytesRead += readElementVariable(ncFile, ncVarElemNeighborRanks, start, count, elemBuffer, &Element::neighborRanks);
+		bytesRead += readElementVariable(ncFile, ncVarElemMPIIndices, start, count, elemBuffer, &Element::mpiIndices);
+		if (hasGroup) {
+			checkNcError(nc_get_vara_int(ncFile, ncVarElemGroup, start, count, elemBuffer));
+			for (int i = 0; i < size; i++)
+				m_elements[i].material = elemBuffer[i];
+			bytesRead += size * sizeof(int);
+		}
 		EPIK_USER_END(r_read_elements);
 		SCOREP_USER_REGION_END( r_read_elements )
 
-		// Copy buffers to elements
-		for (int i = 0; i < size; i++) {
-			m_elements[i].localId = i;
-
-			memcpy(m_elements[i].vertices, &elemVertices[i], sizeof(ElemVertices));
-			memcpy(m_elements[i].neighbors, &elemNeighbors[i], sizeof(ElemNeighbors));
-			memcpy(m_elements[i].neighborSides, &elemNeighborSides[i], sizeof(ElemNeighborSides));
-			memcpy(m_elements[i].sideOrientations, &elemSideOrientations[i], sizeof(ElemSideOrientations));
-			memcpy(m_elements[i].boundaries, &elemBoundaries[i], sizeof(ElemBoundaries));
-			memcpy(m_elements[i].neighborRanks, &elemNeighborRanks[i], sizeof(ElemNeighborRanks));
-			memcpy(m_elements[i].mpiIndices, &elemMPIIndices[i], sizeof(ElemMPIIndices));
-			m_elements[i].material = elemMaterial[i];
-		}
-
-		delete [] elemVertices;
-		delete [] elemNeighbors;
-		delete [] elemNeighborSides;
-		delete [] elemSideOrientations;
-		delete [] elemBoundaries;
-		delete [] elemNeighborRanks;
-		delete [] elemMPIIndices;
+		delete [] elemBuffer;
 
 		// Vertices
 		checkNcError(nc_get_var1_int(ncFile, ncVarVrtxSize, start, &size));
 
 		VrtxCoords* vrtxCoords = new VrtxCoords[size];
+		bytesRead += size * sizeof(VrtxCoords);
 
 		m_vertices.resize(size);
 
@@ -278,6 +265,7 @@ public:
 			// Read local element ids from netcdf
 			size_t bndCount[3] = {1, 1, bndElemSize};
 			checkNcError(nc_get_vara_int(ncFile, ncVarBndElemLocalIds, bndStart, bndCount, bndElemLocalIds));
+			bytesRead += bndElemSize * sizeof(int);
 
 			if (i < size) {
 				// Copy buffer to boundary
@@ -298,31 +286,42 @@ public:
 		EPIK_USER_END(r_read_boundaries);
 		SCOREP_USER_REGION_END( r_read_boundaries )
 
+#ifdef USE_MPI
+		double time = MPI_Wtime() - startTime;
+		unsigned long totalBytesRead = bytesRead;
+		MPI_Reduce(&bytesRead, &totalBytesRead, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+		logInfo(rank) << "Finished reading mesh in" << time << "seconds ("
+			<< (totalBytesRead / (1024.*1024.) / time) << "MiB/s)";
+#else // USE_MPI
 		logInfo(rank) << "Finished reading mesh";
+#endif // USE_MPI
 
 		// Close netcdf file
 		checkNcError(nc_close(ncFile));
 
 		// Recompute additional information
-		findElementsPerVertex();
+		buildVertexElements();
 	}
 
 private:
 	/**
-	 * Finds all locals elements for each vertex
+	 * Reads a variable with 4 values per element and copies it to the elements
+	 *
+	 * @param buffer A buffer that can hold all values
+	 * @param field The destination in the elements
+	 * @return The number of bytes read
 	 */
-	void findElementsPerVertex()
+	unsigned long readElementVariable(int ncFile, int ncVar, const size_t* start, const size_t* count,
+		int* buffer, int (Element::*field)[4])
 	{
-		for (std::vector<Element>::const_iterator i = m_elements.begin();
-				i != m_elements.end(); i++) {
-			for (int j = 0; j < 4; j++) {
-				assert(i->vertices[j] < m_vertices.size());
-				m_vertices[i->vertices[j]].elements.push_back(i->localId);
-			}
-		}
+		checkNcError(nc_get_vara_int(ncFile, ncVar, start, count, buffer));
+
+		for (unsigned int i = 0; i < m_elements.size(); i++)
+			memcpy(m_elements[i].*field, &buffer[i*4], sizeof(int)*4);
+
+		return m_elements.size() * 4 * sizeof(int);
 	}
 
-private:
 	/**
 	 * Switch to collective access for a netCDf variable
 	 */
@@ -0,0 +1,1010 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (rettenbs AT in.tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger,_M.Sc.)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Read Gambit Mesh and Metis Partition in parallel
+ **/
+
+#ifndef PARALLEL_GAMBIT_READER_H
+#define PARALLEL_GAMBIT_READER_H
+
+#ifdef USE_MPI
+
+#include <mpi.h>
+
+#include "GambitReader.h"
+#include "MeshReader.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Reads a Gambit mesh and a Metis partition with all ranks.
+ *
+ * Each rank reads and parses a contiguous byte range of both files.
+ * Elements, vertices, groups, boundaries and partition entries are sent
+ * to the rank responsible for their global id (block distribution) and
+ * from there to the rank owning the element according to the partition.
+ */
+class ParallelGambitReader : public MeshReader
+{
+private:
+	/** Section types */
+	enum SectionType {
+		END_SECTION,
+		NODAL_SECTION,
+		ELEMENT_SECTION,
+		GROUP_SECTION,
+		BOUNDARY_SECTION
+	};
+
+	/** A line starting a section (or ending it) */
+	struct Marker {
+		/** Offset of the line */
+		unsigned long offset;
+		/** Offset of the next line */
+		unsigned long next;
+		int type;
+	};
+
+	/** The data part of a section */
+	struct Section {
+		int type;
+		/** Offset of the first data line */
+		unsigned long begin;
+		/** Offset of the ENDOFSECTION line */
+		unsigned long end;
+		/** Group id or boundary condition */
+		int value;
+	};
+
+	struct VertexRecord {
+		int id;
+		VrtxCoords coords;
+	};
+
+	struct ElementRecord {
+		int id;
+		ElemVertices vertices;
+	};
+
+	struct PartitionRecord {
+		int element;
+		int rank;
+	};
+
+	struct GroupRecord {
+		int element;
+		int group;
+		/** Section index (later sections overwrite earlier ones) */
+		int order;
+	};
+
+	struct BoundaryRecord {
+		int element;
+		int side;
+		int condition;
+		/** Section index (later sections overwrite earlier ones) */
+		int order;
+	};
+
+	/** All information the owner of an element requires */
+	struct LocalElementRecord {
+		int id;
+		ElemVertices vertices;
+		ElemMaterial material;
+		ElemBoundaries boundaries;
+		/** Bit mask of the sides with a boundary condition */
+		int boundaryMask;
+	};
+
+	struct VertexInfo {
+		VrtxCoords coords;
+		/** Number of ranks with elements containing this vertex */
+		int numRanks;
+	};
+
+	/** Number of bytes read at once to complete the last line of a slice */
+	static const unsigned long READ_AHEAD = 4096;
+
+	int m_nProcs;
+
+	int m_nGlobElements;
+	int m_nGlobVertices;
+
+	/** Number of bytes read by this rank */
+	unsigned long m_bytesRead;
+
+public:
+	ParallelGambitReader(int rank, const char* meshFile, const char* partitionFile)
+		: MeshReader(rank), m_nGlobElements(0), m_nGlobVertices(0), m_bytesRead(0)
+	{
+		MPI_Comm_size(MPI_COMM_WORLD, &m_nProcs);
+
+		double startTime = MPI_Wtime();
+
+		// Header, file sizes
+		unsigned long meshSize, partitionSize, headerEnd;
+		readHeader(meshFile, partitionFile, meshSize, partitionSize, headerEnd);
+
+		// Read and parse the local slice of the mesh file
+		std::vector<char> buffer;
+		unsigned long offset = readSlice(meshFile, meshSize, buffer);
+
+		std::vector<Section> sections;
+		findSections(meshFile, buffer, offset, headerEnd, sections);
+
+		std::vector<std::vector<VertexRecord> > vertices(m_nProcs);
+		std::vector<std::vector<ElementRecord> > elements(m_nProcs);
+		std::vector<std::vector<GroupRecord> > groups(m_nProcs);
+		std::vector<std::vector<BoundaryRecord> > boundaries(m_nProcs);
+		parseSlice(buffer, offset, sections, vertices, elements, groups, boundaries);
+		std::vector<char>().swap(buffer);
+
+		// Read and parse the local slice of the partition file
+		std::vector<std::vector<PartitionRecord> > partitions(m_nProcs);
+		readPartition(partitionFile, partitionSize, partitions);
+
+		// Send everything to the block owners
+		std::vector<VertexRecord> blockVertices = exchange(vertices);
+		vertices.clear();
+		std::vector<ElementRecord> blockElements = exchange(elements);
+		elements.clear();
+		std::vector<PartitionRecord> blockPartitions = exchange(partitions);
+		partitions.clear();
+		std::vector<GroupRecord> blockGroups = exchange(groups);
+		groups.clear();
+		std::vector<BoundaryRecord> blockBoundaries = exchange(boundaries);
+		boundaries.clear();
+
+		std::vector<LocalElementRecord> localElements = distributeElements(
+			blockElements, blockPartitions, blockGroups, blockBoundaries);
+
+		// Setup local elements and vertices
+		setupLocalElements(localElements);
+		localElements.clear();
+
+		findLocalVertices();
+		buildVertexElements();
+
+		std::vector<int> vertexRankOffsets;
+		std::vector<int> vertexRanks;
+		setupLocalVertices(blockVertices, vertexRankOffsets, vertexRanks);
+		blockVertices.clear();
+
+		// Find neighbor MPI ranks
+		findMPINeighborElements(vertexRankOffsets, vertexRanks);
+
+		// Find local neighbor elements
+		for (unsigned int i = 0; i < m_elements.size(); i++)
+			findAndUpdateNeighbors(m_elements[i]);
+
+		// Sort neighbor lists
+		sortMPINeighborElements();
+
+		unsigned long bytesRead = m_bytesRead;
+		MPI_Reduce(&m_bytesRead, &bytesRead, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+		double time = MPI_Wtime() - startTime;
+		logInfo(rank) << "Read Gambit mesh in" << time << "seconds ("
+			<< (bytesRead / (1024.*1024.) / time) << "MiB/s)";
+	}
+
+	virtual ~ParallelGambitReader()
+	{
+	}
+
+private:
+	/**
+	 * Reads the header on rank 0 and broadcasts the information
+	 */
+	void readHeader(const char* meshFile, const char* partitionFile,
+		unsigned long &meshSize, unsigned long &partitionSize, unsigned long &headerEnd)
+	{
+		unsigned long header[5];
+
+		if (m_rank == 0) {
+			std::ifstream mesh(meshFile);
+			if (!mesh)
+				logError() << "Could not open mesh file" << meshFile;
+
+			std::string line;
+			getline(mesh, line); // First line contains version
+			line.clear();
+			getline(mesh, line);
+			utils::StringUtils::trim(line);
+			if (line != GambitReader::GAMBIT_FILE_ID)
+				logError() << "Not a Gambit mesh file:" << meshFile;
+
+			getline(mesh, line); // Internal name
+			getline(mesh, line); // PROGRAM: Gambit VERSION: x.y.z
+			getline(mesh, line); // Date
+			getline(mesh, line); // Problem size names
+
+			int groups, boundaries, dimensions;
+			int nGlobVertices, nGlobElements;
+			mesh >> nGlobVertices;
+			mesh >> nGlobElements;
+			mesh >> groups;
+			mesh >> boundaries;
+			mesh >> dimensions;
+			getline(mesh, line); // Skip rest of the line
+			if (dimensions != 3)
+				logError() << "Gambit file does not contain a 3 dimensional mesh";
+
+			getline(mesh, line);
+			utils::StringUtils::trim(line);
+			if (line != GambitReader::ENDSECTION)
+				logError() << "Invalid header in Gambit file" << meshFile;
+
+			header[0] = nGlobVertices;
+			header[1] = nGlobElements;
+			header[2] = mesh.tellg();
+
+			mesh.seekg(0, std::ios::end);
+			header[3] = mesh.tellg();
+
+			std::ifstream partition(partitionFile);
+			if (!partition)
+				logError() << "Could not open partition file" << partitionFile;
+			partition.seekg(0, std::ios::end);
+			header[4] = partition.tellg();
+		}
+
+		MPI_Bcast(header, 5, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+		m_nGlobVertices = header[0];
+		m_nGlobElements = header[1];
+		headerEnd = header[2];
+		meshSize = header[3];
+		partitionSize = header[4];
+	}
+
+	/**
+	 * Reads all lines starting in the byte range of this rank
+	 *
+	 * @param buffer The lines, followed by a terminating zero
+	 * @return The offset of the first line in the file
+	 */
+	unsigned long readSlice(const char* filename, unsigned long fileSize, std::vector<char> &buffer)
+	{
+		const unsigned long sliceSize = (fileSize + m_nProcs - 1) / m_nProcs;
+		const unsigned long begin = std::min(sliceSize * m_rank, fileSize);
+		const unsigned long end = std::min(begin + sliceSize, fileSize);
+
+		buffer.clear();
+
+		if (begin < end) {
+			std::ifstream file(filename, std::ios::binary);
+			if (!file)
+				logError() << "Could not open" << filename;
+
+			// Read the previous byte as well to detect if a line starts at the beginning
+			const unsigned long readBegin = (begin > 0 ? begin-1 : 0);
+			buffer.resize(end - readBegin);
+			file.seekg(readBegin);
+			file.read(&buffer[0], buffer.size());
+
+			// Find the first line starting in our slice
+			unsigned long first = 0;
+			if (begin > 0) {
+				void* newLine = memchr(&buffer[0], '\n', buffer.size()-1);
+				first = (newLine ? static_cast<char*>(newLine) - &buffer[0] + 1 : buffer.size());
+			}
+
+			if (first < buffer.size()) {
+				// Complete the last line
+				while (buffer.back() != '\n' && readBegin + buffer.size() < fileSize) {
+					const unsigned long oldSize = buffer.size();
+					const unsigned long remaining = fileSize - readBegin - oldSize;
+					const unsigned long chunk = (remaining < READ_AHEAD ? remaining : READ_AHEAD);
+					buffer.resize(oldSize + chunk);
+					file.read(&buffer[oldSize], chunk);
+
+					void* newLine = memchr(&buffer[oldSize], '\n', chunk);
+					if (newLine)
+						buffer.resize(static_cast<char*>(newLine) - &buffer[0] + 1);
+				}
+
+				if (!file)
+					logError() << "Could not read" << filename;
+			}
+
+			m_bytesRead += buffer.size();
+			buffer.erase(buffer.begin(), buffer.begin() + first);
+
+			buffer.push_back('\0');
+			return readBegin + first;
+		}
+
+		buffer.push_back('\0');
+		return end;
+	}
+
+	/**
+	 * Finds the sections in the mesh file
+	 *
+	 * Each rank searches for the section markers in its slice. Rank 0 reads
+	 * the headers of the group and boundary sections.
+	 */
+	void findSections(const char* meshFile, const std::vector<char> &buffer, unsigned long offset,
+		unsigned long headerEnd, std::vector<Section> &sections)
+	{
+		std::vector<Marker> localMarkers;
+
+		const char* data = &buffer[0];
+		const unsigned long size = buffer.size()-1;
+		for (unsigned long pos = 0; pos < size; ) {
+			unsigned long next = nextLine(data, pos, size);
+
+			const char* p = data + pos;
+			while (*p == ' ' || *p == '\t')
+				p++;
+
+			if (isalpha(*p) && offset + pos >= headerEnd) {
+				int type = markerType(p);
+				if (type >= 0) {
+					Marker marker = {offset + pos, offset + next, type};
+					localMarkers.push_back(marker);
+				}
+			}
+
+			pos = next;
+		}
+
+		// Collect markers from all ranks
+		int localSize = localMarkers.size() * sizeof(Marker);
+		std::vector<int> recvSizes(m_nProcs);
+		MPI_Allgather(&localSize, 1, MPI_INT, &recvSizes[0], 1, MPI_INT, MPI_COMM_WORLD);
+
+		std::vector<int> displs(m_nProcs);
+		int totalSize = 0;
+		for (int i = 0; i < m_nProcs; i++) {
+			displs[i] = totalSize;
+			totalSize += recvSizes[i];
+		}
+
+		std::vector<Marker> markers(totalSize / sizeof(Marker));
+		MPI_Allgatherv(localMarkers.empty() ? 0L : &localMarkers[0], localSize, MPI_BYTE,
+			markers.empty() ? 0L : &markers[0], &recvSizes[0], &displs[0], MPI_BYTE,
+			MPI_COMM_WORLD);
+
+		// Each section must be closed before the next starts
+		for (unsigned int i = 0; i < markers.size(); i += 2) {
+			if (markers[i].type == END_SECTION || i+1 >= markers.size()
+					|| markers[i+1].type != END_SECTION)
+				logError() << "Invalid section structure in Gambit file" << meshFile;
+
+			Section section = {markers[i].type, markers[i].next, markers[i+1].offset, 0};
+			sections.push_back(section);
+		}
+
+		// Read the headers of group and boundary sections
+		std::vector<unsigned long> headers(sections.size() * 2);
+		if (m_rank == 0) {
+			std::ifstream mesh(meshFile);
+
+			for (unsigned int i = 0; i < sections.size(); i++) {
+				mesh.clear();
+				mesh.seekg(sections[i].begin);
+
+				std::string line;
+				if (sections[i].type == GROUP_SECTION) {
+					std::string text; // unimportant text
+					mesh >> text;
+					int groupId;
+					mesh >> groupId;
+					headers[i*2] = groupId;
+
+					getline(mesh, line); // Skip rest of the line
+					getline(mesh, line); // Skip group name
+					getline(mesh, line); // Skip whatever ...
+				} else if (sections[i].type == BOUNDARY_SECTION) {
+					int boundaryCondition;
+					mesh >> boundaryCondition; // Boundary type
+					headers[i*2] = boundaryCondition - 100;
+
+					getline(mesh, line); // Skip rest of the line
+				}
+
+				headers[i*2+1] = mesh.tellg();
+			}
+
+			if (!mesh)
+				logError() << "Could not read section headers from" << meshFile;
+		}
+
+		if (!headers.empty())
+			MPI_Bcast(&headers[0], headers.size(), MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+		int nodalSections = 0;
+		int elementSections = 0;
+		for (unsigned int i = 0; i < sections.size(); i++) {
+			sections[i].value = static_cast<int>(headers[i*2]);
+			sections[i].begin = headers[i*2+1];
+
+			if (sections[i].type == NODAL_SECTION)
+				nodalSections++;
+			else if (sections[i].type == ELEMENT_SECTION)
+				elementSections++;
+		}
+
+		if (nodalSections != 1 || elementSections != 1)
+			logError() << "Gambit file requires exactly one coordinate and one element section";
+	}
+
+	/**
+	 * Parses all data lines of the slice
+	 */
+	void parseSlice(const std::vector<char> &buffer, unsigned long offset,
+		const std::vector<Section> &sections,
+		std::vector<std::vector<VertexRecord> > &vertices,
+		std::vector<std::vector<ElementRecord> > &elements,
+		std::vector<std::vector<GroupRecord> > &groups,
+		std::vector<std::vector<BoundaryRecord> > &boundaries) const
+	{
+		static const int faceG2S[4] = {0, 1, 3, 2};
+
+		const int vertexBlock = blockSize(m_nGlobVertices);
+		const int elementBlock = blockSize(m_nGlobElements);
+
+		const char* data = &buffer[0];
+		const unsigned long size = buffer.size()-1;
+		unsigned int s = 0;
+		for (unsigned long pos = 0; pos < size; ) {
+			unsigned long next = nextLine(data, pos, size);
+
+			// Find the section of this line
+			while (s < sections.size() && sections[s].end <= offset + pos)
+				s++;
+
+			if (s < sections.size() && offset + pos >= sections[s].begin) {
+				const char* p = data + pos;
+				const char* end = data + next;
+
+				switch (sections[s].type) {
+				case NODAL_SECTION:
+					{
+						VertexRecord vertex;
+						if (parseInt(p, end, vertex.id)) {
+							vertex.id--;
+							for (int i = 0; i < 3; i++) {
+								if (!parseDouble(p, end, vertex.coords[i]))
+									logError() << "Could not parse vertex" << (vertex.id+1);
+							}
+							checkId(vertex.id, m_nGlobVertices, "vertex");
+
+							vertices[vertex.id / vertexBlock].push_back(vertex);
+						}
+					}
+					break;
+				case ELEMENT_SECTION:
+					{
+						ElementRecord element;
+						int t, n;
+						if (parseInt(p, end, element.id)) {
+							element.id--;
+							if (!parseInt(p, end, t) || !parseInt(p, end, n))
+								logError() << "Could not parse element" << (element.id+1);
+							if (t != 6 || n != 4)
+								logError() << "Element" << (element.id+1) << "is not a tetrahedron";
+							for (int i = 0; i < 4; i++) {
+								if (!parseInt(p, end, element.vertices[i]))
+									logError() << "Could not parse element" << (element.id+1);
+								element.vertices[i]--;
+								checkId(element.vertices[i], m_nGlobVertices, "vertex");
+							}
+							checkId(element.id, m_nGlobElements, "element");
+
+							elements[element.id / elementBlock].push_back(element);
+						}
+					}
+					break;
+				case GROUP_SECTION:
+					{
+						GroupRecord group;
+						group.group = sections[s].value;
+						group.order = s;
+						while (parseInt(p, end, group.element)) {
+							group.element--;
+							checkId(group.element, m_nGlobElements, "element");
+
+							groups[group.element / elementBlock].push_back(group);
+						}
+					}
+					break;
+				case BOUNDARY_SECTION:
+					{
+						BoundaryRecord boundary;
+						int t;
+						if (parseInt(p, end, boundary.element)) {
+							boundary.element--;
+							if (!parseInt(p, end, t) || !parseInt(p, end, boundary.side))
+								logError() << "Could not parse boundary of element" << (boundary.element+1);
+							if (t != 6)
+								logError() << "Element" << (boundary.element+1) << "is not a tetrahedron";
+							if (boundary.side < 1 || boundary.side > 4)
+								logError() << "Invalid side for boundary of element" << (boundary.element+1);
+							boundary.side = faceG2S[boundary.side-1];
+							boundary.condition = sections[s].value;
+							boundary.order = s;
+							checkId(boundary.element, m_nGlobElements, "element");
+
+							boundaries[boundary.element / elementBlock].push_back(boundary);
+						}
+					}
+					break;
+				}
+			}
+
+			pos = next;
+		}
+	}
+
+	/**
+	 * Reads and parses the local slice of the partition file
+	 */
+	void readPartition(const char* partitionFile, unsigned long partitionSize,
+		std::vector<std::vector<PartitionRecord> > &partitions)
+	{
+		std::vector<char> buffer;
+		readSlice(partitionFile, partitionSize, buffer);
+
+		std::vector<int> ranks;
+		const char* p = &buffer[0];
+		const char* end = p + buffer.size()-1;
+		int r;
+		while (parseInt(p, end, r))
+			ranks.push_back(r);
+
+		// Get the global index of the first entry
+		int numRanks = ranks.size();
+		int first = 0;
+		MPI_Exscan(&numRanks, &first, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+		if (m_rank == 0)
+			first = 0;
+
+		int total;
+		MPI_Allreduce(&numRanks, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+		if (total != m_nGlobElements)
+			logError() << "Partition file" << partitionFile << "does not match the mesh";
+
+		const int elementBlock = blockSize(m_nGlobElements);
+		for (int i = 0; i < numRanks; i++) {
+			if (ranks[i] < 0 || ranks[i] >= m_nProcs)
+				logError() << "Partition file" << partitionFile << "does not match the number of ranks";
+
+			PartitionRecord partition = {first + i, ranks[i]};
+			partitions[partition.element / elementBlock].push_back(partition);
+		}
+	}
+
+	/**
+	 * Combines all information of the elements in the local block
+	 * and sends them to the owner of the element
+	 */
+	std::vector<LocalElementRecord> distributeElements(const std::vector<ElementRecord> &elements,
+		const std::vector<PartitionRecord> &partitions,
+		std::vector<GroupRecord> &groups,
+		std::vector<BoundaryRecord> &boundaries) const
+	{
+		const int elementBlock = blockSize(m_nGlobElements);
+		const int blockBegin = std::min(m_rank * elementBlock, m_nGlobElements);
+		const int blockEnd = std::min(blockBegin + elementBlock, m_nGlobElements);
+
+		std::vector<LocalElementRecord> block(blockEnd - blockBegin);
+		std::vector<int> owner(block.size(), -1);
+		for (unsigned int i = 0; i < block.size(); i++) {
+			block[i].id = blockBegin + i;
+			block[i].vertices[0] = -1;
+			block[i].material = 0;
+			block[i].boundaryMask = 0;
+			for (int j = 0; j < 4; j++)
+				block[i].boundaries[j] = 0;
+		}
+
+		for (std::vector<ElementRecord>::const_iterator i = elements.begin();
+				i != elements.end(); i++)
+			std::copy(i->vertices, i->vertices+4, block[i->id - blockBegin].vertices);
+
+		for (std::vector<PartitionRecord>::const_iterator i = partitions.begin();
+				i != partitions.end(); i++)
+			owner[i->element - blockBegin] = i->rank;
+
+		std::stable_sort(groups.begin(), groups.end(), compareOrder<GroupRecord>);
+		for (std::vector<GroupRecord>::const_iterator i = groups.begin();
+				i != groups.end(); i++)
+			block[i->element - blockBegin].material = i->group;
+
+		std::stable_sort(boundaries.begin(), boundaries.end(), compareOrder<BoundaryRecord>);
+		for (std::vector<BoundaryRecord>::const_iterator i = boundaries.begin();
+				i != boundaries.end(); i++) {
+			LocalElementRecord &element = block[i->element - blockBegin];
+			element.boundaries[i->side] = i->condition;
+			element.boundaryMask |= 1 << i->side;
+		}
+
+		std::vector<std::vector<LocalElementRecord> > send(m_nProcs);
+		for (unsigned int i = 0; i < block.size(); i++) {
+			if (block[i].vertices[0] < 0 || owner[i] < 0)
+				logError() << "Element" << (block[i].id+1) << "is missing in the mesh or partition file";
+
+			send[owner[i]].push_back(block[i]);
+		}
+
+		return exchange(send);
+	}
+
+	/**
+	 * Creates the local elements (with global vertex ids)
+	 */
+	void setupLocalElements(std::vector<LocalElementRecord> &localElements)
+	{
+		std::sort(localElements.begin(), localElements.end(), compareId);
+
+		m_elements.resize(localElements.size());
+		m_globalElementIds.resize(localElements.size());
+		m_hasGlobalElementIds = true;
+
+		for (unsigned int k = 0; k < localElements.size(); k++) {
+			const LocalElementRecord &record = localElements[k];
+			Element &element = m_elements[k];
+
+			m_globalElementIds[k] = record.id;
+
+			element.localId = k;
+			element.rank = m_rank;
+			element.material = record.material;
+
+			for (int j = 0; j < 4; j++) {
+				element.vertices[j] = record.vertices[j];
+				element.neighbors[j] = -1;
+				element.boundaries[j] = 0;
+
+				if (record.boundaryMask & (1 << j)) {
+					if (record.boundaries[j] != 3)
+						// We still need to find the neighboring element
+						// for DR boundaries
+						element.neighbors[j] = 0; // 0: at least a valid value for periodic boundaries
+					element.neighborRanks[j] = m_rank;
+					element.boundaries[j] = record.boundaries[j];
+				}
+			}
+		}
+	}
+
+	/**
+	 * Gets the coordinates of all local vertices and the ranks sharing them
+	 *
+	 * @param vertexRankOffsets Offsets into vertexRanks for each local vertex
+	 * @param vertexRanks All ranks having at least one element containing the vertex
+	 */
+	void setupLocalVertices(const std::vector<VertexRecord> &blockVertices,
+		std::vector<int> &vertexRankOffsets, std::vector<int> &vertexRanks)
+	{
+		const int vertexBlock = blockSize(m_nGlobVertices);
+		const int blockBegin = std::min(m_rank * vertexBlock, m_nGlobVertices);
+		const int blockEnd = std::min(blockBegin + vertexBlock, m_nGlobVertices);
+
+		// Request the vertices from the block owners
+		std::vector<std::vector<int> > requests(m_nProcs);
+		for (std::vector<int>::const_iterator i = m_globalVertexIds.begin();
+				i != m_globalVertexIds.end(); i++)
+			requests[*i / vertexBlock].push_back(*i);
+
+		std::vector<int> requestCounts;
+		std::vector<int> blockRequests = exchange(requests, &requestCounts);
+
+		// Ranks requesting each vertex of the block
+		std::vector<int> rankOffsets(blockEnd - blockBegin + 1, 0);
+		for (std::vector<int>::const_iterator i = blockRequests.begin();
+				i != blockRequests.end(); i++)
+			rankOffsets[*i - blockBegin + 1]++;
+		for (unsigned int i = 1; i < rankOffsets.size(); i++)
+			rankOffsets[i] += rankOffsets[i-1];
+
+		std::vector<int> ranks(blockRequests.size());
+		std::vector<int> fill(rankOffsets.begin(), rankOffsets.end()-1);
+		unsigned int r = 0;
+		for (int i = 0; i < m_nProcs; i++) {
+			for (int j = 0; j < requestCounts[i]; j++, r++)
+				ranks[fill[blockRequests[r] - blockBegin]++] = i;
+		}
+
+		std::vector<const VertexRecord*> coords(blockEnd - blockBegin, 0L);
+		for (std::vector<VertexRecord>::const_iterator i = blockVertices.begin();
+				i != blockVertices.end(); i++)
+			coords[i->id - blockBegin] = &(*i);
+
+		// Answer the requests
+		std::vector<std::vector<VertexInfo> > infos(m_nProcs);
+		std::vector<std::vector<int> > rankLists(m_nProcs);
+		r = 0;
+		for (int i = 0; i < m_nProcs; i++) {
+			for (int j = 0; j < requestCounts[i]; j++, r++) {
+				const int v = blockRequests[r] - blockBegin;
+				if (!coords[v])
+					logError() << "Vertex" << (blockRequests[r]+1) << "is missing in the mesh file";
+
+				VertexInfo info;
+				std::copy(coords[v]->coords, coords[v]->coords+3, info.coords);
+				info.numRanks = rankOffsets[v+1] - rankOffsets[v];
+				infos[i].push_back(info);
+
+				rankLists[i].insert(rankLists[i].end(), ranks.begin() + rankOffsets[v],
+					ranks.begin() + rankOffsets[v+1]);
+			}
+		}
+
+		std::vector<VertexInfo> recvInfos = exchange(infos);
+		std::vector<int> recvRanks = exchange(rankLists);
+
+		// Store the coordinates and the ranks
+		// (local vertices are sorted by global id, i.e. in the same order as the answers)
+		vertexRankOffsets.resize(m_vertices.size() + 1);
+		vertexRankOffsets[0] = 0;
+		for (unsigned int i = 0; i < m_vertices.size(); i++) {
+			std::copy(recvInfos[i].coords, recvInfos[i].coords+3, m_vertices[i].coords);
+			vertexRankOffsets[i+1] = vertexRankOffsets[i] + recvInfos[i].numRanks;
+		}
+
+		vertexRanks.swap(recvRanks);
+	}
+
+	/**
+	 * Sends all elements with at least 3 vertices on another rank to this rank
+	 * and computes the MPI neighbors
+	 */
+	void findMPINeighborElements(const std::vector<int> &vertexRankOffsets,
+		const std::vector<int> &vertexRanks)
+	{
+		std::vector<std::vector<ElementRecord> > send(m_nProcs);
+
+		std::vector<int> candidates;
+		for (unsigned int i = 0; i < m_elements.size(); i++) {
+			candidates.clear();
+			for (int j = 0; j < 4; j++) {
+				const int v = m_elements[i].vertices[j];
+				candidates.insert(candidates.end(), vertexRanks.begin() + vertexRankOffsets[v],
+					vertexRanks.begin() + vertexRankOffsets[v+1]);
+			}
+			std::sort(candidates.begin(), candidates.end());
+
+			for (std::vector<int>::iterator j = candidates.begin();
+					j != candidates.end(); ) {
+				std::vector<int>::iterator next = std::upper_bound(j, candidates.end(), *j);
+				if (*j != m_rank && next - j >= 3) {
+					// 3 or more vertices are in the domain of this rank
+					ElementRecord element;
+					element.id = m_globalElementIds[i];
+					for (int l = 0; l < 4; l++)
+						element.vertices[l] = m_globalVertexIds[m_elements[i].vertices[l]];
+					send[*j].push_back(element);
+				}
+				j = next;
+			}
+		}
+
+		std::vector<int> recvCounts;
+		std::vector<ElementRecord> remoteElements = exchange(send, &recvCounts);
+
+		unsigned int k = 0;
+		for (int i = 0; i < m_nProcs; i++) {
+			for (int j = 0; j < recvCounts[i]; j++, k++) {
+				Element element;
+				element.localId = m_elements.size();
+				element.rank = i;
+				for (int l = 0; l < 4; l++) {
+					element.vertices[l] = g2lVertex(remoteElements[k].vertices[l]);
+					// Set neighbor rank to -1, otherwise findAndUpdateNeighbors will skip the side
+					element.neighbors[l] = -1;
+				}
+
+				findAndUpdateNeighbors(element);
+
+				for (int l = 0; l < 4; l++) {
+					if (element.neighbors[l] >= 0) {
+						// Add MPI neighbor element
+						MPINeighborElement neighbor = {element.neighbors[l], element.neighborSides[l],
+							remoteElements[k].id, l};
+						m_MPINeighbors[element.rank].elements.push_back(neighbor);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @return The number of ids each rank is responsible for
+	 */
+	int blockSize(int n) const
+	{
+		return std::max((n + m_nProcs - 1) / m_nProcs, 1);
+	}
+
+	/**
+	 * Sends the records to the corresponding ranks
+	 *
+	 * @param send The records for each rank
+	 * @param recvCounts If not NULL, the number of records received from each rank
+	 * @return The records received from all ranks (ordered by rank)
+	 */
+	template<typename T>
+	std::vector<T> exchange(const std::vector<std::vector<T> > &send, std::vector<int>* recvCounts = 0L) const
+	{
+		MPI_Datatype type;
+		MPI_Type_contiguous(sizeof(T), MPI_BYTE, &type);
+		MPI_Type_commit(&type);
+
+		std::vector<int> sendCounts(m_nProcs);
+		std::vector<int> sendDispls(m_nProcs);
+		std::vector<T> sendBuffer;
+		unsigned long total = 0;
+		for (int i = 0; i < m_nProcs; i++)
+			total += send[i].size();
+		sendBuffer.reserve(total);
+		for (int i = 0; i < m_nProcs; i++) {
+			sendCounts[i] = send[i].size();
+			sendDispls[i] = sendBuffer.size();
+			sendBuffer.insert(sendBuffer.end(), send[i].begin(), send[i].end());
+		}
+
+		std::vector<int> counts(m_nProcs);
+		MPI_Alltoall(&sendCounts[0], 1, MPI_INT, &counts[0], 1, MPI_INT, MPI_COMM_WORLD);
+
+		std::vector<int> displs(m_nProcs);
+		int recvTotal = 0;
+		for (int i = 0; i < m_nProcs; i++) {
+			displs[i] = recvTotal;
+			recvTotal += counts[i];
+		}
+
+		std::vector<T> recv(recvTotal);
+		MPI_Alltoallv(sendBuffer.empty() ? 0L : &sendBuffer[0], &sendCounts[0], &sendDispls[0], type,
+			recv.empty() ? 0L : &recv[0], &counts[0], &displs[0], type, MPI_COMM_WORLD);
+
+		MPI_Type_free(&type);
+
+		if (recvCounts)
+			recvCounts->swap(counts);
+
+		return recv;
+	}
+
+	void checkId(int id, int size, const char* name) const
+	{
+		if (id < 0 || id >= size)
+			logError() << "Invalid" << name << "id" << (id+1) << "in Gambit file";
+	}
+
+	/**
+	 * @return The section type of the marker or -1 if the line is not a marker
+	 */
+	static int markerType(const char* line)
+	{
+		if (startsWith(line, GambitReader::ENDSECTION))
+			return END_SECTION;
+		if (startsWith(line, GambitReader::NODAL_COORDINATES))
+			return NODAL_SECTION;
+		if (startsWith(line, GambitReader::ELEMENT_CELLS))
+			return ELEMENT_SECTION;
+		if (startsWith(line, GambitReader::ELEMENT_GROUP))
+			return GROUP_SECTION;
+		if (startsWith(line, GambitReader::BOUNDARY_CONDITIONS))
+			return BOUNDARY_SECTION;
+		return -1;
+	}
+
+	static bool startsWith(const char* line, const char* prefix)
+	{
+		return strncmp(line, prefix, strlen(prefix)) == 0;
+	}
+
+	/**
+	 * @return The position of the line following the line at pos
+	 */
+	static unsigned long nextLine(const char* data, unsigned long pos, unsigned long size)
+	{
+		const void* newLine = memchr(data + pos, '\n', size - pos);
+		return (newLine ? static_cast<const char*>(newLine) - data + 1 : size);
+	}
+
+	/**
+	 * Parses the next integer before end
+	 *
+	 * @return False if no integer was found
+	 */
+	static bool parseInt(const char* &p, const char* end, int &value)
+	{
+		while (p < end && isspace(*p))
+			p++;
+
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = (*p == '-');
+			p++;
+		}
+
+		if (p == end || !isdigit(*p))
+			return false;
+
+		value = 0;
+		for (; p < end && isdigit(*p); p++)
+			value = value*10 + (*p - '0');
+
+		if (negative)
+			value = -value;
+
+		return true;
+	}
+
+	/**
+	 * Parses the next floating point number before end
+	 *
+	 * @return False if no number was found
+	 */
+	static bool parseDouble(const char* &p, const char* end, double &value)
+	{
+		char* numberEnd;
+		value = strtod(p, &numberEnd);
+		if (numberEnd == p || numberEnd > end)
+			return false;
+
+		p = numberEnd;
+		return true;
+	}
+
+	static bool compareId(const LocalElementRecord &elem1, const LocalElementRecord &elem2)
+	{
+		return elem1.id < elem2.id;
+	}
+
+	template<typename T>
+	static bool compareOrder(const T &rec1, const T &rec2)
+	{
+		return rec1.order < rec2.order;
+	}
+};
+
+#endif // USE_MPI
+
+#endif // PARALLEL_GAMBIT_READER_H
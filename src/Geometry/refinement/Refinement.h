@@ -123,7 +123,25 @@ public:
 	virtual void get(const double* idata, const unsigned int* cellMap,
 			int variable, double* odata) const = 0;
 
-	// TODO add getAll to extract all variables if required
+	/**
+	 * Extract (and interpolate) multiple variables with a single pass over the data
+	 *
+	 * Implementations may use aligned non-temporal stores: odata must be aligned
+	 * to 16 bytes and the stride must be a multiple of 2.
+	 *
+	 * @param numVariables Number of variables that should be extracted
+	 * @param variables The variables that should be extracted
+	 * @param odata Pointer to a buffer where the flat data of the refined mesh should be
+	 *  stored. Variable i is stored at odata[i*stride].
+	 * @param stride Distance between two variables in odata
+	 */
+	virtual void getAll(const double* idata, const unsigned int* cellMap,
+			unsigned int numVariables, const int* variables,
+			double* odata, unsigned int stride) const
+	{
+		for (unsigned int i = 0; i < numVariables; i++)
+			get(idata, cellMap, variables[i], &odata[i*stride]);
+	}
 
 protected:
 	/**
@@ -42,62 +42,243 @@
 #ifndef REFINEMENT_TETS_8_H
 #define REFINEMENT_TETS_8_H
 
-#include <set>
+#include <algorithm>
+#include <vector>
 
-#ifdef _OPENMP
-#include "omp.h"
-#endif // _OPENMP
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
 
 #include "Refinement.h"
-#include "Geometry/MeshReader.h"
+#include "Geometry/MeshGeometry.h"
+#include "Numerical_aux/BasisFunction.h"
 
 namespace refinement
 {
 
+/**
+ * Refines each tetrahedron into 8 subtetrahedra and evaluates the
+ * DG polynomial at the barycenter of each subtetrahedron.
+ *
+ * The new vertices are located at the edge midpoints. They are numbered
+ * by edge (after the original vertices), which avoids duplicates without a
+ * vertex map.
+ */
 class Tets8 : public Refinement
 {
 private:
 	/** Number of variables */
 	const unsigned int m_nVariables;
 
-	/** Number of basis functions */
+	/** Number of basis functions (including padding) */
 	const unsigned int m_nBasisFunctions;
 
+	/** Number of basis functions of the polynomial */
+	unsigned int m_nPolyBasisFunctions;
+
+	/** Values of the basis functions at the barycenters of the subtets [8][basis] */
+	std::vector<double> m_basisValues;
+
 public:
-	Tets8(const MeshReader &meshReader, const unsigned int* cellMap,
+	Tets8(const MeshGeometry &geometry,
 			unsigned int numVariables, unsigned int numBasisFunctions)
-		  : Refinement(meshReader.getElements().size() * 8),
-			m_nVariables(numVariables), m_nBasisFunctions(numBasisFunctions)
+		  : Refinement(geometry.nElements() * 8),
+			m_nVariables(numVariables), m_nBasisFunctions(numBasisFunctions),
+			m_basisValues(8 * numBasisFunctions, 0.)
 	{
-		/*
-		int numTasks = 1;
+		// Points of the original tet: vertices (0-3) and edge midpoints (4-9)
+		static const double REF_POINTS[10][3] = {
+			{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+			{.5, 0, 0}, {0, .5, 0}, {0, 0, .5}, {.5, .5, 0}, {.5, 0, .5}, {0, .5, .5}
+		};
+		// Vertices of the edges
+		static const int EDGES[6][2] = {
+			{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}
+		};
+		// Points of the subtets (with positive orientation)
+		static const int SUB_TETS[8][4] = {
+			{0, 4, 5, 6}, {4, 1, 7, 8}, {5, 7, 2, 9}, {6, 8, 9, 3},
+			{4, 5, 6, 8}, {4, 7, 5, 8}, {5, 6, 8, 9}, {5, 8, 7, 9}
+		};
+
+		const int nVertices = geometry.nVertices();
+		const unsigned int nElements = geometry.nElements();
+
+		// Collect the edges of each vertex to a vertex with a higher id
+		// (with duplicates, each edge is listed once per element)
+		std::vector<unsigned int> elementEdgeOffsets(nVertices+1, 0);
+		for (unsigned int i = 0; i < nElements; i++) {
+			const int* cell = geometry.cell(i);
+			for (unsigned int j = 0; j < 6; j++)
+				elementEdgeOffsets[std::min(cell[EDGES[j][0]], cell[EDGES[j][1]]) + 1]++;
+		}
+		for (int i = 0; i < nVertices; i++)
+			elementEdgeOffsets[i+1] += elementEdgeOffsets[i];
+
+		std::vector<int> elementEdges(elementEdgeOffsets[nVertices]);
+		std::vector<unsigned int> fill(elementEdgeOffsets.begin(), elementEdgeOffsets.end()-1);
+		for (unsigned int i = 0; i < nElements; i++) {
+			const int* cell = geometry.cell(i);
+			for (unsigned int j = 0; j < 6; j++) {
+				const int v1 = std::min(cell[EDGES[j][0]], cell[EDGES[j][1]]);
+				const int v2 = std::max(cell[EDGES[j][0]], cell[EDGES[j][1]]);
+				elementEdges[fill[v1]++] = v2;
+			}
+		}
+
+		// Remove the duplicates and count the edges of each vertex
+		std::vector<unsigned int> edgeOffsets(nVertices+1);
+		edgeOffsets[0] = 0;
 #ifdef _OPENMP
-		numTasks = omp_get_max_threads();
+		#pragma omp parallel for schedule(dynamic, 1024)
 #endif // _OPENMP
+		for (int i = 0; i < nVertices; i++) {
+			std::vector<int>::iterator begin = elementEdges.begin() + elementEdgeOffsets[i];
+			std::vector<int>::iterator end = elementEdges.begin() + elementEdgeOffsets[i+1];
+			std::sort(begin, end);
+			edgeOffsets[i+1] = std::unique(begin, end) - begin;
+		}
+		for (int i = 0; i < nVertices; i++)
+			edgeOffsets[i+1] += edgeOffsets[i];
 
-		const std::set<Vertex> *vertexMaps = new std::set<Vertex>[numTasks];
-		// we will generate 8 times as many cells (with 4 vertices per cell)
-		m_cells = new unsigned int[numCells * 8 * 4];
+		// Sorted list of the upper vertices of all edges
+		std::vector<int> edgeVertices(edgeOffsets[nVertices]);
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+#endif // _OPENMP
+		for (int i = 0; i < nVertices; i++) {
+			std::copy(elementEdges.begin() + elementEdgeOffsets[i],
+					elementEdges.begin() + elementEdgeOffsets[i] + (edgeOffsets[i+1] - edgeOffsets[i]),
+					edgeVertices.begin() + edgeOffsets[i]);
+		}
 
-		int taskId;
+		// Original vertices and edge midpoints
+		setNVertices(nVertices + edgeVertices.size());
 #ifdef _OPENMP
-		#pragma omp parallel private(taskId)
-		{
-			taskId = omp_get_thread_num();
-			#pragma omp for
+		#pragma omp parallel for schedule(static)
 #endif // _OPENMP
-			// Create the new cells and a vertex map for each task
-			for (unsigned int i = 0; i < numCells; i++) {
+		for (int i = 0; i < nVertices; i++) {
+			VrtxCoords coords;
+			geometry.vertex(i, coords);
+			setVertex(i, coords);
 
+			for (unsigned int j = edgeOffsets[i]; j < edgeOffsets[i+1]; j++) {
+				VrtxCoords other;
+				geometry.vertex(edgeVertices[j], other);
+				double midpoint[3];
+				for (unsigned int k = 0; k < 3; k++)
+					midpoint[k] = 0.5 * (coords[k] + other[k]);
+				setVertex(nVertices + j, midpoint);
 			}
+		}
+
+		// Subtets
 #ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+#endif // _OPENMP
+		for (unsigned int i = 0; i < nElements; i++) {
+			int points[10];
+			for (unsigned int j = 0; j < 4; j++)
+				points[j] = geometry.cell(i)[j];
+			for (unsigned int j = 0; j < 6; j++) {
+				int v1 = std::min(points[EDGES[j][0]], points[EDGES[j][1]]);
+				int v2 = std::max(points[EDGES[j][0]], points[EDGES[j][1]]);
+				std::vector<int>::const_iterator edge = std::lower_bound(
+						edgeVertices.begin() + edgeOffsets[v1],
+						edgeVertices.begin() + edgeOffsets[v1+1], v2);
+				points[4+j] = nVertices + (edge - edgeVertices.begin());
+			}
 
-			// Combine the vertexMaps to one (only required for OpenMP)
+			for (unsigned int j = 0; j < 8; j++) {
+				int cell[4];
+				for (unsigned int k = 0; k < 4; k++)
+					cell[k] = points[SUB_TETS[j][k]];
+				setCell(i*8 + j, cell);
+			}
 		}
-#endif // _OPENMP
 
-		delete vertexMaps;
-		*/
+		// The DOFs might be padded, use the largest complete polynomial
+		m_nPolyBasisFunctions = seissol::basisFunction::getNumberOfPolynomialBasisFunctions(m_nBasisFunctions);
+
+		// Basis functions at the barycenters (zero for padded basis functions)
+		for (unsigned int i = 0; i < 8; i++) {
+			double center[3] = {0, 0, 0};
+			for (unsigned int j = 0; j < 4; j++) {
+				for (unsigned int k = 0; k < 3; k++)
+					center[k] += 0.25 * REF_POINTS[SUB_TETS[i][j]][k];
+			}
+
+			seissol::basisFunction::evaluateTetra(center, m_nPolyBasisFunctions,
+					&m_basisValues[i*m_nBasisFunctions]);
+		}
+	}
+
+	void get(const double* idata,  const unsigned int* cellMap,
+			int variable, double* odata) const
+	{
+		const unsigned int nOrigCells = nCells() / 8;
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+#endif
+		for (unsigned int i = 0; i < nOrigCells; i++) {
+			const double* dofs = &idata[(cellMap[i] * m_nVariables + variable) * m_nBasisFunctions];
+
+			for (unsigned int j = 0; j < 8; j++) {
+				const double* basis = &m_basisValues[j * m_nBasisFunctions];
+
+				double value = 0;
+				for (unsigned int k = 0; k < m_nPolyBasisFunctions; k++)
+					value += basis[k] * dofs[k];
+				odata[i*8 + j] = value;
+			}
+		}
+	}
+
+	void getAll(const double* idata, const unsigned int* cellMap,
+			unsigned int numVariables, const int* variables,
+			double* odata, unsigned int stride) const
+	{
+		const unsigned int nOrigCells = nCells() / 8;
+
+#ifdef _OPENMP
+		#pragma omp parallel
+#endif
+		{
+#ifdef _OPENMP
+			#pragma omp for schedule(static)
+#endif
+			for (unsigned int i = 0; i < nOrigCells; i++) {
+				const double* cellDofs = &idata[cellMap[i] * m_nVariables * m_nBasisFunctions];
+
+				for (unsigned int j = 0; j < numVariables; j++) {
+					const double* dofs = &cellDofs[variables[j] * m_nBasisFunctions];
+
+					double values[8];
+					for (unsigned int k = 0; k < 8; k++) {
+						const double* basis = &m_basisValues[k * m_nBasisFunctions];
+
+						values[k] = 0;
+						for (unsigned int l = 0; l < m_nPolyBasisFunctions; l++)
+							values[k] += basis[l] * dofs[l];
+					}
+
+					// The 8 subcells are always aligned to 16 bytes
+					double* out = &odata[j*stride + i*8];
+#ifdef __SSE2__
+					for (unsigned int k = 0; k < 8; k += 2)
+						_mm_stream_pd(&out[k], _mm_loadu_pd(&values[k]));
+#else // __SSE2__
+					for (unsigned int k = 0; k < 8; k++)
+						out[k] = values[k];
+#endif // __SSE2__
+				}
+			}
+
+#ifdef __SSE2__
+			_mm_sfence();
+#endif // __SSE2__
+		}
 	}
 };
 
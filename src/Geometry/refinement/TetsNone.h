@@ -41,8 +41,12 @@
 #ifndef REFINEMENT_TETS_NONE_H
 #define REFINEMENT_TETS_NONE_H
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
 #include "Refinement.h"
-#include "Geometry/MeshReader.h"
+#include "Geometry/MeshGeometry.h"
 
 namespace refinement
 {
@@ -57,20 +61,21 @@ private:
 	const unsigned int m_nBasisFunctions;
 
 public:
-	TetsNone(const MeshReader &meshReader,
+	TetsNone(const MeshGeometry &geometry,
 			unsigned int numVariables, unsigned int numBasisFunctions)
-		  : Refinement(meshReader.getElements().size()),
+		  : Refinement(geometry.nElements()),
 			m_nVariables(numVariables), m_nBasisFunctions(numBasisFunctions)
 	{
-		setNVertices(meshReader.getVertices().size());
+		setNVertices(geometry.nVertices());
 
-		const std::vector<Vertex> &vertices = meshReader.getVertices();
-		for (unsigned int i = 0; i < vertices.size(); i++)
-			setVertex(i, vertices[i].coords);
+		for (unsigned int i = 0; i < geometry.nVertices(); i++) {
+			VrtxCoords coords;
+			geometry.vertex(i, coords);
+			setVertex(i, coords);
+		}
 
-		const std::vector<Element> &elements = meshReader.getElements();
-		for (unsigned int i = 0; i < elements.size(); i++) {
-			setCell(i, elements[i].vertices);
+		for (unsigned int i = 0; i < geometry.nElements(); i++) {
+			setCell(i, geometry.cell(i));
 		}
 	}
 
@@ -83,6 +88,50 @@ public:
 		for (unsigned int i = 0; i < nCells(); i++)
 			odata[i] = idata[(cellMap[i] * m_nVariables + variable) * m_nBasisFunctions];
 	}
+
+	void getAll(const double* idata, const unsigned int* cellMap,
+			unsigned int numVariables, const int* variables,
+			double* odata, unsigned int stride) const
+	{
+		const unsigned int cellSize = m_nVariables * m_nBasisFunctions;
+
+		// Two cells at once to use aligned streaming stores
+		const unsigned int nPairs = nCells() / 2;
+
+#ifdef _OPENMP
+		#pragma omp parallel
+#endif
+		{
+#ifdef _OPENMP
+			#pragma omp for schedule(static)
+#endif
+			for (unsigned int i = 0; i < nPairs; i++) {
+				const double* cell0 = &idata[cellMap[i*2] * cellSize];
+				const double* cell1 = &idata[cellMap[i*2+1] * cellSize];
+
+				for (unsigned int j = 0; j < numVariables; j++) {
+					const unsigned int offset = variables[j] * m_nBasisFunctions;
+					double* out = &odata[j*stride + i*2];
+#ifdef __SSE2__
+					_mm_stream_pd(out, _mm_set_pd(cell1[offset], cell0[offset]));
+#else // __SSE2__
+					out[0] = cell0[offset];
+					out[1] = cell1[offset];
+#endif // __SSE2__
+				}
+			}
+
+#ifdef __SSE2__
+			_mm_sfence();
+#endif // __SSE2__
+		}
+
+		if (nCells() % 2 != 0) {
+			const unsigned int last = nCells() - 1;
+			for (unsigned int j = 0; j < numVariables; j++)
+				odata[j*stride + last] = idata[cellMap[last] * cellSize + variables[j] * m_nBasisFunctions];
+		}
+	}
 };
 
 }
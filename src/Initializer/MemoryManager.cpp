@@ -40,6 +40,10 @@
 #include "MemoryManager.h"
 #include "InternalState.h"
 
+#include <map>
+
+#include <utils/env.h>
+
 #include <Kernels/common.hpp>
 
 seissol::initializers::MemoryManager::MemoryManager( const seissol::XmlParser &i_matrixReader ) {
@@ -950,6 +954,138 @@ void seissol::initializers::MemoryManager::initializeCells() {
   }
 }
 
+void seissol::initializers::MemoryManager::deriveTimeIntegrationScratch( unsigned int                   i_numberOfCells,
+                                                                         CellLocalInformation          *i_cellInformation,
+                                                                         real                        *(*i_faceNeighbors)[4],
+                                                                         double                         i_machineBalance,
+                                                                         double                        &io_budget,
+                                                                         struct TimeIntegrationScratch &o_scratch ) {
+  // default: scratch is disabled
+  o_scratch.numberOfDerivatives = 0;
+  o_scratch.derivatives         = NULL;
+  o_scratch.gts                 = NULL;
+  o_scratch.timeIntegrated      = NULL;
+  o_scratch.faceNeighbors       = NULL;
+
+  // distinct derivatives and their relation
+  std::map< real*, bool > l_derivatives;
+
+  // number of face-neighboring derivatives integrated in time by the individual cells
+  unsigned int l_numberOfReferences = 0;
+
+  for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
+    for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+      // skip faces without neighboring contribution (see time kernel)
+      if( i_cellInformation[l_cell].faceTypes[l_face] == outflow ||
+          i_cellInformation[l_cell].faceTypes[l_face] == dynamicRupture ) continue;
+
+      if( (i_cellInformation[l_cell].ltsSetup >> l_face) % 2 ) {
+        bool l_gts = (i_cellInformation[l_cell].ltsSetup >> (l_face + 4)) % 2;
+        std::map< real*, bool >::iterator l_derivative = l_derivatives.find( i_faceNeighbors[l_cell][l_face] );
+
+        if( l_derivative == l_derivatives.end() ) {
+          l_derivatives[ i_faceNeighbors[l_cell][l_face] ] = l_gts;
+        }
+        // the expansion point of a derivative is unique with respect to the cluster of the cell
+        else assert( l_derivative->second == l_gts );
+
+        l_numberOfReferences++;
+      }
+    }
+  }
+
+  unsigned int l_numberOfDerivatives = l_derivatives.size();
+  if( l_numberOfDerivatives == 0 ) return;
+
+  /*
+   * Cost model (in bytes transferred from memory, flops are weighted by the machine balance):
+   *   per-face: every reference reads the derivatives and integrates into a thread-local stack buffer.
+   *   shared:   every distinct derivative is read and integrated once (write-allocate of the scratch), every reference reads the scratch.
+   */
+  double l_integrationFlops = 2.0 * NUMBER_OF_ALIGNED_DERS;
+  double l_derivativesBytes = NUMBER_OF_ALIGNED_DERS * sizeof(real);
+  double l_dofsBytes        = NUMBER_OF_ALIGNED_DOFS * sizeof(real);
+
+  double l_perFaceCost = l_numberOfReferences  * ( l_integrationFlops / i_machineBalance + l_derivativesBytes );
+  double l_sharedCost  = l_numberOfDerivatives * ( l_integrationFlops / i_machineBalance + l_derivativesBytes + 2 * l_dofsBytes )
+                       + l_numberOfReferences  * l_dofsBytes;
+
+  double l_memory = l_numberOfDerivatives * ( l_dofsBytes + sizeof(real*) + sizeof(bool) )
+                  + i_numberOfCells       * sizeof( real*[4] );
+
+  if( l_sharedCost >= l_perFaceCost || l_memory > io_budget ) return;
+  io_budget -= l_memory;
+
+  // allocate the scratch
+  o_scratch.numberOfDerivatives = l_numberOfDerivatives;
+  o_scratch.derivatives         = (real**)                           m_memoryAllocator.allocateMemory( l_numberOfDerivatives * sizeof( real* ), 1 );
+  o_scratch.gts                 = (bool*)                            m_memoryAllocator.allocateMemory( l_numberOfDerivatives * sizeof( bool ),  1 );
+  o_scratch.timeIntegrated      = (real(*)[NUMBER_OF_ALIGNED_DOFS]) m_memoryAllocator.allocateMemory( l_numberOfDerivatives * sizeof( real[NUMBER_OF_ALIGNED_DOFS] ),
+                                                                                                      PAGESIZE_HEAP,
+                                                                                                      MEMKIND_TIMEDOFS );
+  o_scratch.faceNeighbors       = (real*(*)[4])                      m_memoryAllocator.allocateMemory( i_numberOfCells * sizeof( real*[4] ), 1, MEMKIND_TIMEDOFS );
+
+  // set up the derivatives and remember their position in the scratch
+  std::map< real*, unsigned int > l_positions;
+  for( std::map< real*, bool >::const_iterator l_derivative = l_derivatives.begin(); l_derivative != l_derivatives.end(); l_derivative++ ) {
+    unsigned int l_position = l_positions.size();
+    o_scratch.derivatives[l_position] = l_derivative->first;
+    o_scratch.gts[l_position]         = l_derivative->second;
+    l_positions[l_derivative->first]  = l_position;
+  }
+
+  // touch the time integrated DOFs
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for( unsigned int l_derivative = 0; l_derivative < l_numberOfDerivatives; l_derivative++ ) {
+    for( unsigned int l_dof = 0; l_dof < NUMBER_OF_ALIGNED_DOFS; l_dof++ ) {
+      o_scratch.timeIntegrated[l_derivative][l_dof] = (real) 0;
+    }
+  }
+
+  // redirect the face neighbors providing derivatives to the scratch
+  for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
+    for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+      o_scratch.faceNeighbors[l_cell][l_face] = i_faceNeighbors[l_cell][l_face];
+
+      if( i_cellInformation[l_cell].faceTypes[l_face] != outflow &&
+          i_cellInformation[l_cell].faceTypes[l_face] != dynamicRupture &&
+          (i_cellInformation[l_cell].ltsSetup >> l_face) % 2 ) {
+        o_scratch.faceNeighbors[l_cell][l_face] = o_scratch.timeIntegrated[ l_positions[ i_faceNeighbors[l_cell][l_face] ] ];
+      }
+    }
+  }
+
+  logDebug() << "enabled shared time integration scratch:" << l_numberOfDerivatives << "derivatives," << l_numberOfReferences << "references,"
+             << "estimated cost" << l_sharedCost << "vs." << l_perFaceCost;
+}
+
+void seissol::initializers::MemoryManager::initializeTimeIntegrationScratch() {
+  // memory budget of the shared scratches in MiB; 0 disables the shared time integration
+  double l_budget         = utils::Env::get<double>( "SEISSOL_TIME_INTEGRATION_SCRATCH", 0 ) * 1024 * 1024;
+  // flops per byte of the machine, used to weigh flops against memory transfers in the cost model
+  double l_machineBalance = utils::Env::get<double>( "SEISSOL_MACHINE_BALANCE", 10 );
+
+  for( unsigned int l_cluster = 0; l_cluster < m_numberOfClusters; l_cluster++ ) {
+#ifdef USE_MPI
+    deriveTimeIntegrationScratch( m_meshStructure[l_cluster].numberOfCopyCells,
+                                  m_copyCellInformation[l_cluster],
+                                  m_cells[l_cluster].copyFaceNeighbors,
+                                  l_machineBalance,
+                                  l_budget,
+                                  m_cells[l_cluster].copyScratch );
+#endif
+
+    deriveTimeIntegrationScratch( m_meshStructure[l_cluster].numberOfInteriorCells,
+                                  m_interiorCellInformation[l_cluster],
+                                  m_cells[l_cluster].interiorFaceNeighbors,
+                                  l_machineBalance,
+                                  l_budget,
+                                  m_cells[l_cluster].interiorScratch );
+  }
+}
+
 void seissol::initializers::MemoryManager::initializeMemoryLayout( struct TimeStepping         &i_timeStepping,
                                                                    struct MeshStructure        *i_meshStructure,
                                                                    struct CellLocalInformation *io_cellLocalInformation ) {
@@ -984,6 +1120,9 @@ void seissol::initializers::MemoryManager::initializeMemoryLayout( struct TimeSt
   // initialize the cells
   initializeCells();
 
+  // initialize the shared time integration scratch
+  initializeTimeIntegrationScratch();
+
 #ifdef USE_MPI
   // initialize the communication structure
   initializeCommunicationStructure();
@@ -314,6 +314,30 @@ class seissol::initializers::MemoryManager {
      **/
     void initializeCells();
 
+    /**
+     * Derives the shared time integration scratch of a layer.
+     *   The scratch is enabled if the estimated cost of integrating every distinct face-neighboring derivative once
+     *   is lower than the per-face integration and the required memory fits into the remaining budget.
+     *
+     * @param i_numberOfCells number of cells in the layer.
+     * @param i_cellInformation cell information of the layer.
+     * @param i_faceNeighbors pointers to the face neighbors' time buffers or derivatives.
+     * @param i_machineBalance flops per byte of the machine, which is used in the cost model.
+     * @param io_budget remaining memory budget in bytes; reduced by the memory of an enabled scratch.
+     * @param o_scratch shared scratch, which is set up.
+     **/
+    void deriveTimeIntegrationScratch( unsigned int                  i_numberOfCells,
+                                       CellLocalInformation         *i_cellInformation,
+                                       real                       *(*i_faceNeighbors)[4],
+                                       double                        i_machineBalance,
+                                       double                       &io_budget,
+                                       struct TimeIntegrationScratch &o_scratch );
+
+    /**
+     * Initializes the shared time integration scratch of all clusters and layers.
+     **/
+    void initializeTimeIntegrationScratch();
+
 #ifdef USE_MPI
     /**
      * Initializes the communication structure.
@@ -199,11 +199,23 @@ CONTAINS
     ! This has to be done before the LTS setup!
     if( io%format .eq. 6 ) then
       call c_interoperability_enableWaveFieldOutput( i_waveFieldInterval = c_loc(io%outInterval%timeInterval), &
-                                                     i_waveFieldFilename = trim(io%OutputFile) // c_null_char )
+                                                     i_waveFieldFilename = trim(io%OutputFile) // c_null_char, &
+                                                     i_waveFieldRefinement = c_loc(io%Refinement), &
+                                                     i_outputMask = merge(1, 0, io%OutputMask(4:12)), &
+                                                     i_outputRegion = c_loc(io%OutputRegion), &
+                                                     i_outputRegionBounds = c_loc(io%OutputRegionBounds), &
+                                                     i_compressionMode = c_loc(io%CompressionMode), &
+                                                     i_compressionTolerance = c_loc(io%CompressionTolerance) )
+    endif
+
+    if( io%SurfaceOutput .eq. 1 ) then
+      call c_interoperability_enableFreeSurfaceOutput( i_freeSurfaceInterval = c_loc(io%SurfaceOutputInterval), &
+                                                       i_freeSurfaceFilename = trim(io%OutputFile) // '-surface' // c_null_char )
     endif
 
     if( io%checkpoint%interval .gt. 0 ) then
         call c_interoperability_enableCheckPointing( i_checkPointInterval = c_loc(io%checkpoint%interval), &
+                                                     i_checkPointMtbf = c_loc(io%checkpoint%mtbf), &
                                                      i_checkPointFilename = trim(io%checkpoint%filename) // c_null_char, &
                                                      i_checkPointBackend = trim(io%checkpoint%backend) // c_null_char )
     endif
@@ -212,7 +224,7 @@ CONTAINS
     ! Start mesh reading/computing section
     EPIK_USER_START(r_read_compute_mesh)
     SCOREP_USER_REGION_BEGIN( r_read_compute_mesh, "read_compute_mesh", SCOREP_USER_REGION_TYPE_COMMON )
-    if (IO%meshgenerator .eq. 'Gambit3D-fast' .or. IO%meshgenerator .eq. 'Netcdf') then
+    if (IO%meshgenerator .eq. 'Gambit3D-fast' .or. IO%meshgenerator .eq. 'Netcdf' .or. IO%meshgenerator .eq. 'CubeGenerator') then
         call read_mesh_fast(IO,EQN,DISC,MESH,BND,MPI)
     else
         CALL read_mesh(IO,EQN,DISC,MESH,BND,MPI)
@@ -248,7 +260,7 @@ CONTAINS
 #ifdef PARALLEL 
 
     ! nothing done for hybrids yet
-    if (IO%meshgenerator .ne. 'Gambit3D-fast' .and. IO%meshgenerator .ne. 'Netcdf') then
+    if (IO%meshgenerator .ne. 'Gambit3D-fast' .and. IO%meshgenerator .ne. 'Netcdf' .and. IO%meshgenerator .ne. 'CubeGenerator') then
         CALL MPIExtractMesh( EQN   = EQN,  &                                       !
                              DISC  = DISC, &                                       !
                              BND   = BND,  &                                       !
@@ -43,10 +43,17 @@
 #endif
 
 #include "utils/logger.h"
+#include "utils/env.h"
 
 #include "LtsLayout.h"
 #include "MultiRate.hpp"
+#include <Kernels/Volume.h>
+#include <Kernels/Boundary.h>
+#include <Kernels/Time.h>
 #include <iterator>
+#include <cmath>
+#include <fstream>
+#include <sstream>
 
 seissol::initializers::time_stepping::LtsLayout::LtsLayout():
  m_cellTimeStepWidths(       NULL ),
@@ -475,11 +482,13 @@ unsigned int seissol::initializers::time_stepping::LtsLayout::enforceSingleBuffe
   return 0;
 }
 
-void seissol::initializers::time_stepping::LtsLayout::normalizeClustering() {
-  // allocate memory for the cluster ids of the ghost layer
-  m_plainGhostCellClusterIds = new unsigned int*[ m_plainNeighboringRanks.size() ];
-  for( unsigned int l_neighbor = 0; l_neighbor < m_plainNeighboringRanks.size(); l_neighbor++ ) {
-    m_plainGhostCellClusterIds[l_neighbor] = new unsigned int[ m_numberOfPlainGhostCells[l_neighbor] ];
+unsigned int seissol::initializers::time_stepping::LtsLayout::normalizeClustering() {
+  // allocate memory for the cluster ids of the ghost layer (reused if the clustering is normalized repeatedly)
+  if( m_plainGhostCellClusterIds == NULL ) {
+    m_plainGhostCellClusterIds = new unsigned int*[ m_plainNeighboringRanks.size() ];
+    for( unsigned int l_neighbor = 0; l_neighbor < m_plainNeighboringRanks.size(); l_neighbor++ ) {
+      m_plainGhostCellClusterIds[l_neighbor] = new unsigned int[ m_numberOfPlainGhostCells[l_neighbor] ];
+    }
   }
 
   // enforce requirements until mesh is valid
@@ -518,8 +527,121 @@ void seissol::initializers::time_stepping::LtsLayout::normalizeClustering() {
 #endif
   }
 
-  logInfo() << "Performed a total of" << l_totalMaximumDifference << "reductions" << "for maximum"
-            << "difference in" << m_cells.size() << "cells.";
+  return l_totalMaximumDifference + l_totalSingleBuffer;
+}
+
+double seissol::initializers::time_stepping::LtsLayout::getPredictedTimeToSolution( double i_communicationWeight ) {
+  // use khan sum
+  // 0: true sum
+  // 1: compensation
+  double l_localCost[2];
+  l_localCost[0] = l_localCost[1] = 0;
+
+  double l_t, l_y;
+
+  // computation: one update per cluster time step
+  for( unsigned int l_cell = 0; l_cell < m_cells.size(); l_cell++ ) {
+    l_y = ( 1.0 / m_globalTimeStepWidths[ m_cellClusterIds[l_cell] ] ) - l_localCost[1];
+    l_t = l_localCost[0] + l_y;
+    l_localCost[1] = (l_t - l_localCost[0]) - l_y;
+    l_localCost[0] = l_t;
+  }
+
+  // communication: copy cells send their data once per cluster time step to every neighboring rank
+  for( unsigned int l_region = 0; l_region < m_plainNeighboringRanks.size(); l_region++ ) {
+    for( unsigned int l_copyCell = 0; l_copyCell < m_plainCopyRegions[l_region].size(); l_copyCell++ ) {
+      unsigned int l_cell = m_plainCopyRegions[l_region][l_copyCell];
+
+      l_y = ( i_communicationWeight / m_globalTimeStepWidths[ m_cellClusterIds[l_cell] ] ) - l_localCost[1];
+      l_t = l_localCost[0] + l_y;
+      l_localCost[1] = (l_t - l_localCost[0]) - l_y;
+      l_localCost[0] = l_t;
+    }
+  }
+
+  // the slowest rank determines the time to solution
+  double l_globalCost = l_localCost[0];
+#ifdef USE_MPI
+  MPI_Allreduce( l_localCost, &l_globalCost, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+#endif
+
+  return l_globalCost;
+}
+
+unsigned int seissol::initializers::time_stepping::LtsLayout::deriveNormalizedClustering( unsigned int i_clusterRate,
+                                                                                          double       i_offset ) {
+  // free the global clusters of a previous derivation
+  if( m_globalTimeStepWidths != NULL ) delete[] m_globalTimeStepWidths;
+  if( m_globalTimeStepRates  != NULL ) delete[] m_globalTimeStepRates;
+
+  m_clusteringStrategy = ( i_clusterRate == std::numeric_limits<unsigned int>::max() ) ? single : multiRate;
+
+  // derive time stepping clusters and per-cell cluster ids (w/o normalizations)
+  MultiRate::deriveClusterIds( m_cells.size(),
+                               i_clusterRate,
+                               m_cellTimeStepWidths,
+                               m_cellClusterIds,
+                               m_numberOfGlobalClusters,
+                               m_globalTimeStepWidths,
+                               m_globalTimeStepRates,
+                               i_offset );
+
+  // normalize clustering
+  return normalizeClustering();
+}
+
+unsigned int seissol::initializers::time_stepping::LtsLayout::deriveOptimalClustering( unsigned int i_maximumClusterRate ) {
+  // number of shifted cluster boundaries evaluated per rate
+  unsigned int l_numberOfOffsets = utils::Env::get<unsigned int>( "SEISSOL_CLUSTERING_OFFSETS", 4 );
+  // cost of communicating a copy cell relative to the update of a cell
+  double l_communicationWeight = utils::Env::get<double>( "SEISSOL_CLUSTERING_COMMUNICATION_WEIGHT", 0.5 );
+
+  assert( l_numberOfOffsets > 0 );
+
+  // best configuration; GTS is the reference
+  unsigned int l_bestRate = std::numeric_limits<unsigned int>::max();
+  double       l_bestOffset = 1.0;
+  deriveNormalizedClustering( l_bestRate, l_bestOffset );
+  double l_bestTime = getPredictedTimeToSolution( l_communicationWeight );
+  double l_gtsTime  = l_bestTime;
+
+  for( unsigned int l_rate = 2; l_rate <= i_maximumClusterRate; l_rate++ ) {
+    for( unsigned int l_offset = 0; l_offset < l_numberOfOffsets; l_offset++ ) {
+      // shift the cluster boundaries by fractions of the rate
+      double l_scaling = std::pow( (double) l_rate, -( (double) l_offset ) / l_numberOfOffsets );
+
+      unsigned int l_adjustments = deriveNormalizedClustering( l_rate, l_scaling );
+      double l_time = getPredictedTimeToSolution( l_communicationWeight );
+
+      logDebug(m_rank) << "clustering candidate rate / offset:" << l_rate << "/" << l_scaling
+                       << "clusters:" << m_numberOfGlobalClusters << "adjustments:" << l_adjustments
+                       << "predicted speedup:" << l_gtsTime / l_time;
+
+      if( l_time < l_bestTime ) {
+        l_bestTime   = l_time;
+        l_bestRate   = l_rate;
+        l_bestOffset = l_scaling;
+      }
+    }
+  }
+
+  if( l_bestRate == std::numeric_limits<unsigned int>::max() ) {
+    logInfo(m_rank) << "optimal clustering: GTS";
+  }
+  else {
+    logInfo(m_rank) << "optimal clustering: rate" << l_bestRate << "with minimum time step width scaled by" << l_bestOffset
+                    << "predicted speedup (compared to GTS):" << l_gtsTime / l_bestTime;
+  }
+
+  // restore the best clustering
+  unsigned int l_adjustments = deriveNormalizedClustering( l_bestRate, l_bestOffset );
+
+  logInfo(m_rank) << "optimal clustering:" << m_numberOfGlobalClusters << "clusters";
+  for( unsigned int l_cluster = 0; l_cluster < m_numberOfGlobalClusters; l_cluster++ ) {
+    logInfo(m_rank) << "  cluster" << l_cluster << "time step width:" << m_globalTimeStepWidths[l_cluster];
+  }
+
+  return l_adjustments;
 }
 
 void seissol::initializers::time_stepping::LtsLayout::getTheoreticalSpeedup( double &o_perCellTimeStepWidths,
@@ -982,28 +1104,6 @@ void seissol::initializers::time_stepping::LtsLayout::deriveClusteredGhost() {
 
 void seissol::initializers::time_stepping::LtsLayout::deriveLayout( enum TimeClustering i_timeClustering,
                                                                     unsigned int        i_clusterRate ) {
-  m_clusteringStrategy = i_timeClustering;
-
-  // derive time stepping clusters and per-cell cluster ids (w/o normalizations)
-  if( m_clusteringStrategy == single ) {
-    MultiRate::deriveClusterIds( m_cells.size(),
-                                 std::numeric_limits<unsigned int>::max(),
-                                 m_cellTimeStepWidths,
-                                 m_cellClusterIds,
-                                 m_numberOfGlobalClusters,
-                                 m_globalTimeStepWidths,
-                                 m_globalTimeStepRates  );
-  }
-  else if ( m_clusteringStrategy == multiRate ) {
-    MultiRate::deriveClusterIds( m_cells.size(),
-                                 i_clusterRate,
-                                 m_cellTimeStepWidths,
-                                 m_cellClusterIds,
-                                 m_numberOfGlobalClusters,
-                                 m_globalTimeStepWidths,
-                                 m_globalTimeStepRates );
-  }
-
   // derive plain copy and the interior
   derivePlainCopyInterior();
 
@@ -1013,8 +1113,21 @@ void seissol::initializers::time_stepping::LtsLayout::deriveLayout( enum TimeClu
   // normalize mpi indices
   normalizeMpiIndices();
 
-  // normalize clustering
-  normalizeClustering();
+  // derive time stepping clusters and per-cell cluster ids, and normalize the clustering
+  unsigned int l_adjustments = 0;
+  if( i_timeClustering == single ) {
+    l_adjustments = deriveNormalizedClustering( std::numeric_limits<unsigned int>::max(), 1.0 );
+  }
+  else if( i_timeClustering == multiRate ) {
+    l_adjustments = deriveNormalizedClustering( i_clusterRate, 1.0 );
+  }
+  else if( i_timeClustering == optimalMultiRate ) {
+    l_adjustments = deriveOptimalClustering( i_clusterRate );
+  }
+  else logError() << "clustering stategy not supported";
+
+  logInfo() << "Performed a total of" << l_adjustments << "reductions" << "for maximum"
+            << "difference in" << m_cells.size() << "cells.";
 
   // get maximum speedups compared to GTS
   double l_perCellSpeedup, l_clusteringSpeedup;
@@ -1029,6 +1142,96 @@ void seissol::initializers::time_stepping::LtsLayout::deriveLayout( enum TimeClu
 
   // derive the region sizes of the ghost layer
   deriveClusteredGhost();
+
+  // export partition weights for the offline partitioning tools
+  const char* l_weightsPrefix = utils::Env::get<const char*>( "SEISSOL_PARTITION_WEIGHTS", NULL );
+  if( l_weightsPrefix != NULL ) exportPartitionWeights( l_weightsPrefix );
+}
+
+void seissol::initializers::time_stepping::LtsLayout::exportPartitionWeights( const std::string &i_prefix ) {
+  // cost of plasticity per cell update relative to the update of a regular interior cell
+  double l_plasticityCost = utils::Env::get<double>( "SEISSOL_PARTITION_WEIGHT_PLASTICITY", 0 );
+  // resolution of the integer weights
+  const double l_resolution = 10;
+
+  // kernels providing the flop counts
+  seissol::kernels::Time     l_timeKernel;
+  seissol::kernels::Volume   l_volumeKernel;
+  seissol::kernels::Boundary l_boundaryKernel;
+
+  unsigned int l_nonZeroFlops, l_hardwareFlops;
+
+  // element-local flops, identical for all cells
+  unsigned int l_cellFlops = 0;
+  l_nonZeroFlops = l_hardwareFlops = 0;
+  l_timeKernel.flopsAder( l_nonZeroFlops, l_hardwareFlops );
+  l_cellFlops += l_hardwareFlops;
+  l_nonZeroFlops = l_hardwareFlops = 0;
+  l_volumeKernel.flopsIntegral( l_nonZeroFlops, l_hardwareFlops );
+  l_cellFlops += l_hardwareFlops;
+
+  // reference: regular interior cell
+  enum faceType l_regularFaces[4] = { regular, regular, regular, regular };
+  int l_regularIndices[4][2] = { {0, 0}, {0, 0}, {0, 0}, {0, 0} };
+  double l_referenceFlops = l_cellFlops;
+  l_boundaryKernel.flopsLocalIntegral( l_regularFaces, l_nonZeroFlops, l_hardwareFlops );
+  l_referenceFlops += l_hardwareFlops;
+  l_boundaryKernel.flopsNeighborsIntegral( l_regularFaces, l_regularIndices, l_nonZeroFlops, l_hardwareFlops );
+  l_referenceFlops += l_hardwareFlops;
+
+  // per-cell weights
+  std::vector< unsigned int > l_computeWeights( m_cells.size() );
+  std::vector< unsigned int > l_ruptureWeights( m_cells.size() );
+  unsigned int l_localRuptureWeight = 0;
+
+  for( unsigned int l_cell = 0; l_cell < m_cells.size(); l_cell++ ) {
+    enum faceType l_faceTypes[4];
+    int l_neighboringIndices[4][2];
+    unsigned int l_numberOfRuptureFaces = 0;
+
+    for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+      l_faceTypes[l_face] = getFaceType( m_cells[l_cell].boundaries[l_face] );
+      l_neighboringIndices[l_face][0] = m_cells[l_cell].neighborSides[l_face];
+      l_neighboringIndices[l_face][1] = m_cells[l_cell].sideOrientations[l_face];
+
+      if( l_faceTypes[l_face] == dynamicRupture ) l_numberOfRuptureFaces++;
+    }
+
+    double l_flops = l_cellFlops;
+    l_boundaryKernel.flopsLocalIntegral( l_faceTypes, l_nonZeroFlops, l_hardwareFlops );
+    l_flops += l_hardwareFlops;
+    l_boundaryKernel.flopsNeighborsIntegral( l_faceTypes, l_neighboringIndices, l_nonZeroFlops, l_hardwareFlops );
+    l_flops += l_hardwareFlops;
+
+    // number of updates per update of the largest cluster
+    unsigned int l_numberOfUpdates = (unsigned int) ( m_globalTimeStepWidths[m_numberOfGlobalClusters-1] / m_globalTimeStepWidths[ m_cellClusterIds[l_cell] ] + 0.5 );
+
+    l_computeWeights[l_cell] = std::max( 1u, (unsigned int) ( l_numberOfUpdates * ( l_flops / l_referenceFlops + l_plasticityCost ) * l_resolution + 0.5 ) );
+    l_ruptureWeights[l_cell] = l_numberOfUpdates * l_numberOfRuptureFaces;
+    l_localRuptureWeight    += l_ruptureWeights[l_cell];
+  }
+
+  // add the rupture constraint only if present in the global domain (partitioners reject constraints without weight)
+  unsigned int l_globalRuptureWeight = l_localRuptureWeight;
+#ifdef USE_MPI
+  MPI_Allreduce( &l_localRuptureWeight, &l_globalRuptureWeight, 1, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD );
+#endif
+  unsigned int l_numberOfConstraints = (l_globalRuptureWeight > 0) ? 2 : 1;
+
+  std::ostringstream l_fileName;
+  l_fileName << i_prefix << "." << m_rank;
+
+  std::ofstream l_file( l_fileName.str().c_str() );
+  if( !l_file ) logError() << "could not open partition weights file" << l_fileName.str();
+
+  l_file << m_cells.size() << " " << l_numberOfConstraints << std::endl;
+  for( unsigned int l_cell = 0; l_cell < m_cells.size(); l_cell++ ) {
+    l_file << l_computeWeights[l_cell];
+    if( l_numberOfConstraints > 1 ) l_file << " " << l_ruptureWeights[l_cell];
+    l_file << std::endl;
+  }
+
+  logInfo(m_rank) << "Wrote partition weights with" << l_numberOfConstraints << "constraints to" << i_prefix;
 }
 
 void seissol::initializers::time_stepping::LtsLayout::getCrossClusterTimeStepping( struct TimeStepping &o_timeStepping ) {
@@ -48,6 +48,7 @@
 
 #include <limits>
 #include <cassert>
+#include <string>
 
 namespace seissol {
   namespace initializers {
@@ -263,8 +264,42 @@ class seissol::initializers::time_stepping::LtsLayout {
 
     /**
      * Normalizes the clustering.
+     *
+     * @return total number of performed per-cell adjustments.
+     **/
+    unsigned int normalizeClustering();
+
+    /**
+     * Predicts the time to solution of the current clustering.
+     * The cost of a rank is given by its number of cell updates per unit of simulated time, where each cell
+     * in a plain copy region adds the given weight for the communication of its data.
+     * The predicted time to solution is the maximum cost over all ranks.
+     *
+     * @param i_communicationWeight cost of communicating a copy cell relative to the update of a cell.
+     * @return predicted time to solution (arbitrary units).
+     **/
+    double getPredictedTimeToSolution( double i_communicationWeight );
+
+    /**
+     * Derives the cluster ids of the cells for the given multi-rate configuration and normalizes the clustering.
+     *
+     * @param i_clusterRate rate of the multi-rate scheme; std::numeric_limits<unsigned int>::max() for GTS.
+     * @param i_offset scaling of the global minimum time step width, which shifts the cluster boundaries.
+     * @return total number of performed per-cell adjustments in the normalization.
      **/
-    void normalizeClustering();
+    unsigned int deriveNormalizedClustering( unsigned int i_clusterRate,
+                                             double       i_offset );
+
+    /**
+     * Searches for the multi-rate clustering with the lowest predicted time to solution.
+     * Candidates are GTS and the rates 2 to i_maximumClusterRate, each with shifted cluster boundaries.
+     * Every candidate is normalized before its evaluation, the cost of the normalization is part of the prediction.
+     * The cluster ids of the best candidate are set on return.
+     *
+     * @param i_maximumClusterRate largest rate considered in the search.
+     * @return total number of performed per-cell adjustments in the normalization of the selected clustering.
+     **/
+    unsigned int deriveOptimalClustering( unsigned int i_maximumClusterRate );
 
     /**
      * Gets the maximum possible speedups.
@@ -462,7 +497,7 @@ class seissol::initializers::time_stepping::LtsLayout {
      * Derives the layout of the LTS scheme.
      *
      * @param i_timeClustering clustering strategy.
-     * @param i_clusterRate cluster rate in the case of a multi-rate scheme.
+     * @param i_clusterRate cluster rate in the case of a multi-rate scheme, maximum considered rate for an optimal multi-rate scheme.
      **/
     void deriveLayout( enum TimeClustering i_timeClustering,
                        unsigned int        i_clusterRate = std::numeric_limits<unsigned int>::max() );
@@ -503,6 +538,19 @@ class seissol::initializers::time_stepping::LtsLayout {
                              unsigned int         *&o_ltsToMesh,
                              unsigned int         *&o_copyInteriorToMesh );
 
+    /**
+     * Writes per-cell partition weights of the local domain for the offline partitioning tools.
+     * Each line of the file <i_prefix>.<rank> holds the integer weights of one cell in mesh order, preceded by a header
+     * with the number of cells and constraints:
+     *  1) cost of the cell: number of updates per update of the largest cluster times the cost of an update
+     *     relative to a regular interior cell (ADER, volume and boundary kernels, optional plasticity).
+     *  2) dynamic rupture (only present if the global domain contains rupture faces): number of updates times number
+     *     of dynamic rupture faces.
+     *
+     * @param i_prefix prefix of the weight files.
+     **/
+    void exportPartitionWeights( const std::string &i_prefix );
+
     /**
      * Get the per cluster mesh structure.
      *
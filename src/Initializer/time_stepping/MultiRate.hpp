@@ -135,8 +135,8 @@ class seissol::initializers::time_stepping::MultiRate {
                                unsigned int          i_multiRate,
                                unsigned int          i_numberOfCells,
                                CellLocalInformation *io_cellLocalInformation ) {
-      logInfo() << "Deriving clusters ids for min. time step width / multiRate:" << i_minimumTimeStepWidth << "/"
-                                                                                 << i_multiRate;
+      logDebug() << "Deriving clusters ids for min. time step width / multiRate:" << i_minimumTimeStepWidth << "/"
+                                                                                  << i_multiRate;
       // iterate over all cells
       for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
         double   l_clusterTimeStepWidth;
@@ -164,8 +164,8 @@ class seissol::initializers::time_stepping::MultiRate {
                                      unsigned int  i_numberOfCells,
                                const double       *i_cellTimeStepWidths,
                                      unsigned int *o_cellClusterIds ) {
-      logInfo() << "Deriving clusters ids for min. time step width / multiRate:" << i_minimumTimeStepWidth << "/"
-                                                                                 << i_multiRate;
+      logDebug() << "Deriving clusters ids for min. time step width / multiRate:" << i_minimumTimeStepWidth << "/"
+                                                                                  << i_multiRate;
       // iterate over all cells
       for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
         double l_clusterTimeStepWidth;
@@ -231,6 +231,7 @@ class seissol::initializers::time_stepping::MultiRate {
      * @param o_numberOfGlobalClusters set to number of global clusters.
      * @param o_globalTimeStepWidths set to time step widths of the global clusters.
      * @param o_globalTimeStepRates set to the time step rates of the global clusters.
+     * @param i_offset scaling (0, 1] of the global minimum time step width, which shifts the cluster boundaries.
      **/
     static void deriveClusterIds( unsigned int   i_numberOfCells,
                                   unsigned int   i_multiRate,
@@ -238,7 +239,10 @@ class seissol::initializers::time_stepping::MultiRate {
                                   unsigned int  *o_cellClusterIds,
                                   unsigned int  &o_numberOfGlobalClusters,
                                   double       *&o_globalTimeStepWidths,
-                                  unsigned int *&o_globalTimeStepRates ) {
+                                  unsigned int *&o_globalTimeStepRates,
+                                  double         i_offset = 1.0 ) {
+      assert( i_offset > 0 && i_offset <= 1 );
+
       double l_minimumTimeStepWidth, l_maximumTimeStepWidth;
 
       // derive global minimum and maximum
@@ -247,6 +251,9 @@ class seissol::initializers::time_stepping::MultiRate {
                                  l_minimumTimeStepWidth,
                                  l_maximumTimeStepWidth );
 
+      // shift the boundaries of the clusters
+      l_minimumTimeStepWidth *= i_offset;
+
       // derive the number and time step widths of the global clusters
       deriveGlobalClusters( l_minimumTimeStepWidth,
                             l_maximumTimeStepWidth,
@@ -70,7 +70,9 @@ enum TimeClustering {
   // online clustering resulting in a multi-rate scheme
   multiRate = 2,
   // online clustering aiming at LTS for slithers only
-  slithers  = 3
+  slithers  = 3,
+  // online clustering searching for the multi-rate scheme with the lowest predicted time to solution
+  optimalMultiRate = 4
 };
 
 // face types
@@ -410,6 +412,39 @@ struct InternalState {
 
 };
 
+/**
+ * Shared scratch of the time integrated DOFs of face neighbors, which provide derivatives.
+ *   Every distinct derivative referenced by the cells of a layer is integrated once per time step.
+ *   The result is reused by all cells (up to four) referencing the derivative.
+ **/
+struct TimeIntegrationScratch {
+  /*
+   * Number of distinct face-neighboring derivatives (0 if the scratch is disabled for the layer).
+   */
+  unsigned int numberOfDerivatives;
+
+  /*
+   * Face-neighboring derivatives, which are integrated in time.
+   */
+  real **derivatives;
+
+  /*
+   * true if the derivatives have a GTS relation (expansion point at the start of the time step),
+   * false for a LTS relation (expansion point at the common point zero).
+   */
+  bool *gts;
+
+  /*
+   * Time integrated DOFs of the derivatives.
+   */
+  real (*timeIntegrated)[NUMBER_OF_ALIGNED_DOFS];
+
+  /*
+   * Pointers to the face neighbors' time buffers or the time integrated DOFs in the scratch (replacing derivatives).
+   */
+  real *(*faceNeighbors)[4];
+};
+
 /**
  * Structure of the cells.
  **/
@@ -434,6 +469,11 @@ struct Cells {
    * Pointers to the either the time buffers or time derivatives of the face neighbors in the copy layer.
    */
   real *(*copyFaceNeighbors)[4];
+
+  /*
+   * Shared scratch of the time integrated face-neighboring derivatives in the copy layer.
+   */
+  struct TimeIntegrationScratch copyScratch;
 #endif
 
   /*
@@ -455,6 +495,11 @@ struct Cells {
    * Pointers to the either the time buffers or time derivatives of the face neighbors in the interior.
    */
   real *(*interiorFaceNeighbors)[4];
+
+  /*
+   * Shared scratch of the time integrated face-neighboring derivatives in the interior.
+   */
+  struct TimeIntegrationScratch interiorScratch;
 };
 
 /** A piecewise linear function.
@@ -37,16 +37,16 @@
  * @section DESCRIPTION
  * Counts the floating point operations in SeisSol.
  **/
-#ifndef NDEBUG
-
 #ifdef USE_MPI
 #include <mpi.h>
 #endif
 
 #include "FlopCounter.hpp"
 
+#ifndef NDEBUG
   // Define the FLOP counter.
   long long libxsmm_num_total_flops = 0;
+#endif
 
   long long g_SeisSolNonZeroFlopsLocal = 0;
   long long g_SeisSolHardwareFlopsLocal = 0;
@@ -60,7 +60,9 @@
      */
     void printFlops() {
 #ifdef USE_MPI
+#ifndef NDEBUG
       MPI_Allreduce(MPI_IN_PLACE, &libxsmm_num_total_flops, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
       MPI_Allreduce(MPI_IN_PLACE, &g_SeisSolNonZeroFlopsLocal, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
       MPI_Allreduce(MPI_IN_PLACE, &g_SeisSolHardwareFlopsLocal, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
       MPI_Allreduce(MPI_IN_PLACE, &g_SeisSolNonZeroFlopsNeighbor, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
@@ -70,7 +72,9 @@
 #else
       int rank = 0;
 #endif
+#ifndef NDEBUG
       logInfo(rank) << "Total   measured HW-GFLOP: " << ((double)libxsmm_num_total_flops)/1e9;
+#endif
       logInfo(rank) << "Total calculated HW-GFLOP: " << ((double)(g_SeisSolHardwareFlopsLocal+g_SeisSolHardwareFlopsNeighbor))/1e9;
       logInfo(rank) << "Total calculated NZ-GFLOP: " << ((double)(g_SeisSolNonZeroFlopsLocal+g_SeisSolNonZeroFlopsNeighbor))/1e9;
       logInfo(rank) << "Local calculated HW-GFLOP: " << ((double)g_SeisSolHardwareFlopsLocal)/1e9;
@@ -79,4 +83,3 @@
       logInfo(rank) << "Neigh calculated NZ-GFLOP: " << ((double)g_SeisSolNonZeroFlopsNeighbor)/1e9;
     }
   }
-#endif
@@ -41,15 +41,16 @@
 #ifndef FLOPCOUNTER_HPP
 #define FLOPCOUNTER_HPP
 
-#ifndef NDEBUG
-
 #include <utils/logger.h>
 
+#ifndef NDEBUG
   //! floating point operations performed in the matrix kernels.
   //!   Remark: This variable is updated by the matrix kernels.
   extern long long libxsmm_num_total_flops;
+#endif
 
   // global variables for summing-up SeisSol internal counters
+  //   Remark: These variables are updated from precomputed per-cluster counts after every update of a layer.
   extern long long g_SeisSolNonZeroFlopsLocal;
   extern long long g_SeisSolHardwareFlopsLocal;
   extern long long g_SeisSolNonZeroFlopsNeighbor;
@@ -60,5 +61,3 @@
   }
 
 #endif
-
-#endif
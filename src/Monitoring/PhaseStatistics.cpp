@@ -0,0 +1,210 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Per-phase timing, load imbalance and performance statistics of the time clusters.
+ **/
+
+#include "PhaseStatistics.hpp"
+
+#include <utils/logger.h>
+
+#include <sstream>
+#include <iomanip>
+
+namespace seissol {
+  namespace monitoring {
+    //! names of the phases in the report
+    static const char* const g_phaseNames[numberOfPhases] = { "local copy", "local interior", "neigh. copy", "neigh. interior",
+                                                              "receivers", "sources", "dyn. rupture" };
+
+    /**
+     * Formats the max/avg ratios of all phases of a quantity.
+     *
+     * @param i_maximum per-phase maxima.
+     * @param i_sum per-phase sums.
+     * @param i_numberOfRanks number of ranks.
+     **/
+    static std::string formatRatios( const double *i_maximum,
+                                     const double *i_sum,
+                                     int           i_numberOfRanks ) {
+      std::ostringstream l_stream;
+      l_stream << std::fixed << std::setprecision(2);
+
+      for( unsigned int l_phase = 0; l_phase < numberOfPhases; l_phase++ ) {
+        if( i_maximum[l_phase] > 0 ) {
+          l_stream << " " << g_phaseNames[l_phase] << ": " << i_maximum[l_phase]
+                   << " (" << i_maximum[l_phase] / ( i_sum[l_phase] / i_numberOfRanks ) << ")";
+        }
+      }
+
+      return l_stream.str();
+    }
+  }
+}
+
+void seissol::monitoring::reportImbalance( unsigned int                                 i_numberOfGlobalClusters,
+                                           const std::vector< unsigned int >           &i_globalClusterIds,
+                                           const std::vector< const PhaseStatistics* > &i_statistics ) {
+  assert( i_globalClusterIds.size() == i_statistics.size() );
+
+  // quantities per cluster and phase: 0: wall time, 1: wait time, 2: cell updates
+  // last entry holds the per-rank totals
+  const unsigned int l_stride = 3 * numberOfPhases;
+  std::vector< double > l_local( (i_numberOfGlobalClusters+1) * l_stride, 0 );
+
+  for( unsigned int l_cluster = 0; l_cluster < i_statistics.size(); l_cluster++ ) {
+    double *l_clusterData = &l_local[ i_globalClusterIds[l_cluster] * l_stride ];
+    double *l_rankData    = &l_local[ i_numberOfGlobalClusters      * l_stride ];
+
+    for( unsigned int l_phase = 0; l_phase < numberOfPhases; l_phase++ ) {
+      l_clusterData[                   l_phase] += i_statistics[l_cluster]->m_wallTime[l_phase];
+      l_clusterData[  numberOfPhases + l_phase] += i_statistics[l_cluster]->m_waitTime[l_phase];
+      l_clusterData[2*numberOfPhases + l_phase] += i_statistics[l_cluster]->m_cellUpdates[l_phase];
+
+      l_rankData[                   l_phase] += i_statistics[l_cluster]->m_wallTime[l_phase];
+      l_rankData[  numberOfPhases + l_phase] += i_statistics[l_cluster]->m_waitTime[l_phase];
+      l_rankData[2*numberOfPhases + l_phase] += i_statistics[l_cluster]->m_cellUpdates[l_phase];
+    }
+  }
+
+  std::vector< double > l_maximum( l_local );
+  std::vector< double > l_sum(     l_local );
+  int l_rank = 0;
+  int l_numberOfRanks = 1;
+
+#ifdef USE_MPI
+  MPI_Comm_rank( MPI_COMM_WORLD, &l_rank );
+  MPI_Comm_size( MPI_COMM_WORLD, &l_numberOfRanks );
+
+  MPI_Reduce( &l_local[0], &l_maximum[0], l_local.size(), MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+  MPI_Reduce( &l_local[0], &l_sum[0],     l_local.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+#endif
+
+  if( l_rank != 0 ) return;
+
+  logInfo() << "Load imbalance since the last synchronization, maximum over all ranks (max/avg):";
+  for( unsigned int l_cluster = 0; l_cluster <= i_numberOfGlobalClusters; l_cluster++ ) {
+    const double *l_maximumData = &l_maximum[ l_cluster * l_stride ];
+    const double *l_sumData     = &l_sum[     l_cluster * l_stride ];
+
+    std::ostringstream l_name;
+    if( l_cluster < i_numberOfGlobalClusters ) l_name << "cluster " << l_cluster;
+    else                                       l_name << "rank";
+
+    logInfo() << l_name.str() << "wall time [s]:" << formatRatios( l_maximumData,                    l_sumData,                    l_numberOfRanks );
+    logInfo() << l_name.str() << "wait time [s]:" << formatRatios( l_maximumData +   numberOfPhases, l_sumData +   numberOfPhases, l_numberOfRanks );
+    logInfo() << l_name.str() << "updates:"       << formatRatios( l_maximumData + 2*numberOfPhases, l_sumData + 2*numberOfPhases, l_numberOfRanks );
+  }
+}
+
+void seissol::monitoring::reportPerformance( unsigned int                                 i_numberOfGlobalClusters,
+                                             const std::vector< unsigned int >           &i_globalClusterIds,
+                                             const std::vector< const PhaseStatistics* > &i_statistics ) {
+  assert( i_globalClusterIds.size() == i_statistics.size() );
+
+  // per cluster: 0: non-zero flops, 1: hardware flops, 2: bytes, 3: time in the kernels (local and neighboring updates)
+  std::vector< double > l_cluster( i_numberOfGlobalClusters * 4, 0 );
+
+  // per rank: 0: hardware GFLOP/s, 1: GB/s
+  double l_rankRates[2] = { 0, 0 };
+
+  // per rank: 0: non-zero flops, 1: hardware flops, 2: bytes, 3: elapsed time
+  double l_rankTotals[4] = { 0, 0, 0, 0 };
+
+  for( unsigned int l_localCluster = 0; l_localCluster < i_statistics.size(); l_localCluster++ ) {
+    double *l_clusterData = &l_cluster[ i_globalClusterIds[l_localCluster] * 4 ];
+
+    for( unsigned int l_phase = localCopyPhase; l_phase <= neighboringInteriorPhase; l_phase++ ) {
+      l_clusterData[0] += i_statistics[l_localCluster]->m_nonZeroFlops[l_phase];
+      l_clusterData[1] += i_statistics[l_localCluster]->m_hardwareFlops[l_phase];
+      l_clusterData[2] += i_statistics[l_localCluster]->m_bytes[l_phase];
+      l_clusterData[3] += i_statistics[l_localCluster]->m_wallTime[l_phase];
+    }
+
+    for( unsigned int l_entry = 0; l_entry < 3; l_entry++ ) l_rankTotals[l_entry] += l_clusterData[l_entry];
+  }
+
+  // all clusters are reset at the same synchronization point
+  if( i_statistics.size() > 0 ) {
+    l_rankTotals[3] = getWallTime() - i_statistics[0]->m_resetTime;
+    l_rankRates[0]  = l_rankTotals[1] / l_rankTotals[3] * 1E-9;
+    l_rankRates[1]  = l_rankTotals[2] / l_rankTotals[3] * 1E-9;
+  }
+
+  std::vector< double > l_clusterSum( l_cluster );
+  double l_rankMinimum[2] = { l_rankRates[0], l_rankRates[1] };
+  double l_rankMaximum[2] = { l_rankRates[0], l_rankRates[1] };
+  double l_rankSum[2]     = { l_rankRates[0], l_rankRates[1] };
+  double l_totals[4]      = { l_rankTotals[0], l_rankTotals[1], l_rankTotals[2], l_rankTotals[3] };
+  int l_rank = 0;
+  int l_numberOfRanks = 1;
+
+#ifdef USE_MPI
+  MPI_Comm_rank( MPI_COMM_WORLD, &l_rank );
+  MPI_Comm_size( MPI_COMM_WORLD, &l_numberOfRanks );
+
+  MPI_Reduce( &l_cluster[0], &l_clusterSum[0], l_cluster.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+  MPI_Reduce( l_rankRates,   l_rankMinimum,    2,                MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD );
+  MPI_Reduce( l_rankRates,   l_rankMaximum,    2,                MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+  MPI_Reduce( l_rankRates,   l_rankSum,        2,                MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+  MPI_Reduce( l_rankTotals,  l_totals,         3,                MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+  MPI_Reduce( l_rankTotals+3, l_totals+3,      1,                MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+#endif
+
+  if( l_rank != 0 ) return;
+
+  logInfo() << "Performance since the last synchronization:";
+  for( unsigned int l_clusterId = 0; l_clusterId < i_numberOfGlobalClusters; l_clusterId++ ) {
+    const double *l_clusterData = &l_clusterSum[ l_clusterId * 4 ];
+
+    // average time in the kernels over all ranks
+    double l_time = l_clusterData[3] / l_numberOfRanks;
+    if( l_time > 0 ) {
+      logInfo() << "cluster" << l_clusterId << "HW-GFLOP/s:" << l_clusterData[1] / l_time * 1E-9
+                                            << "NZ-GFLOP/s:" << l_clusterData[0] / l_time * 1E-9
+                                            << "GB/s:"       << l_clusterData[2] / l_time * 1E-9
+                                            << "avg. kernel time [s]:" << l_time;
+    }
+  }
+
+  logInfo() << "per rank HW-GFLOP/s (min/avg/max):" << l_rankMinimum[0] << l_rankSum[0] / l_numberOfRanks << l_rankMaximum[0]
+            << "GB/s (min/avg/max):"                << l_rankMinimum[1] << l_rankSum[1] / l_numberOfRanks << l_rankMaximum[1];
+
+  if( l_totals[3] > 0 ) {
+    logInfo() << "total HW-GFLOP/s:" << l_totals[1] / l_totals[3] * 1E-9
+              << "NZ-GFLOP/s:"       << l_totals[0] / l_totals[3] * 1E-9
+              << "GB/s:"             << l_totals[2] / l_totals[3] * 1E-9;
+  }
+}
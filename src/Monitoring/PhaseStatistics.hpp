@@ -0,0 +1,237 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Per-phase timing, load imbalance and performance statistics of the time clusters.
+ **/
+
+#ifndef PHASESTATISTICS_HPP
+#define PHASESTATISTICS_HPP
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <ctime>
+#include <cassert>
+#include <vector>
+
+namespace seissol {
+  namespace monitoring {
+    /**
+     * Monitored phases of a time cluster.
+     **/
+    enum Phase {
+      localCopyPhase           = 0,
+      localInteriorPhase       = 1,
+      neighboringCopyPhase     = 2,
+      neighboringInteriorPhase = 3,
+      receiversPhase           = 4,
+      sourcesPhase             = 5,
+      dynamicRupturePhase      = 6,
+      numberOfPhases           = 7
+    };
+
+    /**
+     * Gets the wall clock time in seconds.
+     **/
+    inline double getWallTime() {
+#ifdef USE_MPI
+      return MPI_Wtime();
+#elif defined(_OPENMP)
+      return omp_get_wtime();
+#else
+      timespec l_time;
+      clock_gettime( CLOCK_MONOTONIC, &l_time );
+      return l_time.tv_sec + 1E-9 * l_time.tv_nsec;
+#endif
+    }
+
+    class PhaseStatistics;
+
+    /**
+     * Reduces the statistics of all ranks and prints the max/avg ratios per global cluster and phase.
+     *
+     * @param i_numberOfGlobalClusters number of global clusters.
+     * @param i_globalClusterIds global cluster ids of the local clusters.
+     * @param i_statistics statistics of the local clusters.
+     **/
+    void reportImbalance( unsigned int                              i_numberOfGlobalClusters,
+                          const std::vector< unsigned int >        &i_globalClusterIds,
+                          const std::vector< const PhaseStatistics* > &i_statistics );
+
+    /**
+     * Reduces the statistics of all ranks and prints the achieved GFLOP/s and GB/s per global cluster and rank.
+     *
+     * @param i_numberOfGlobalClusters number of global clusters.
+     * @param i_globalClusterIds global cluster ids of the local clusters.
+     * @param i_statistics statistics of the local clusters.
+     **/
+    void reportPerformance( unsigned int                                 i_numberOfGlobalClusters,
+                            const std::vector< unsigned int >           &i_globalClusterIds,
+                            const std::vector< const PhaseStatistics* > &i_statistics );
+  }
+}
+
+/**
+ * Wall time, wait time, cell updates, flops and bytes of the phases of a time cluster.
+ * Phases might be nested (e.g. receivers in the local copy phase); the time of an inner phase is not accounted to the outer one.
+ **/
+class seissol::monitoring::PhaseStatistics {
+  //private:
+    //! maximum nesting of phases
+    static const unsigned int m_maximumDepth = 4;
+
+    //! active phases, innermost last
+    Phase m_activePhases[m_maximumDepth];
+
+    //! number of active phases
+    unsigned int m_depth;
+
+    //! start of the currently accounted interval
+    double m_intervalStart;
+
+    //! start of the current wait per phase; negative if not waiting
+    double m_waitStart[numberOfPhases];
+
+  public:
+    //! wall time per phase in seconds
+    double m_wallTime[numberOfPhases];
+
+    //! time spent waiting on communication before a phase could start, in seconds
+    double m_waitTime[numberOfPhases];
+
+    //! number of cell updates (receivers, sources and rupture updates for the respective phases)
+    unsigned long long m_cellUpdates[numberOfPhases];
+
+    //! non-zero floating point operations per phase
+    unsigned long long m_nonZeroFlops[numberOfPhases];
+
+    //! floating point operations in hardware per phase
+    unsigned long long m_hardwareFlops[numberOfPhases];
+
+    //! transferred bytes (memory) per phase
+    unsigned long long m_bytes[numberOfPhases];
+
+    //! point in time of the last reset
+    double m_resetTime;
+
+    PhaseStatistics() {
+      m_depth = 0;
+      m_intervalStart = 0;
+      for( unsigned int l_phase = 0; l_phase < numberOfPhases; l_phase++ ) m_waitStart[l_phase] = -1;
+      reset();
+    }
+
+    /**
+     * Resets the accumulated statistics.
+     **/
+    void reset() {
+      for( unsigned int l_phase = 0; l_phase < numberOfPhases; l_phase++ ) {
+        m_wallTime[l_phase]      = 0;
+        m_waitTime[l_phase]      = 0;
+        m_cellUpdates[l_phase]   = 0;
+        m_nonZeroFlops[l_phase]  = 0;
+        m_hardwareFlops[l_phase] = 0;
+        m_bytes[l_phase]         = 0;
+      }
+      m_resetTime = getWallTime();
+    }
+
+    /**
+     * Starts a phase; an active outer phase is paused.
+     *
+     * @param i_phase phase.
+     **/
+    void start( Phase i_phase ) {
+      assert( m_depth < m_maximumDepth );
+      double l_now = getWallTime();
+
+      if( m_depth > 0 ) m_wallTime[ m_activePhases[m_depth-1] ] += l_now - m_intervalStart;
+
+      m_activePhases[m_depth++] = i_phase;
+      m_intervalStart = l_now;
+    }
+
+    /**
+     * Stops the innermost phase; a paused outer phase is resumed.
+     *
+     * @param i_cellUpdates number of cell updates performed in the phase.
+     * @param i_nonZeroFlops number of non-zero flops performed in the phase.
+     * @param i_hardwareFlops number of flops in hardware performed in the phase.
+     * @param i_bytes number of bytes transferred in the phase.
+     **/
+    void stop( unsigned long long i_cellUpdates   = 0,
+               unsigned long long i_nonZeroFlops  = 0,
+               unsigned long long i_hardwareFlops = 0,
+               unsigned long long i_bytes         = 0 ) {
+      assert( m_depth > 0 );
+      double l_now = getWallTime();
+
+      Phase l_phase = m_activePhases[--m_depth];
+      m_wallTime[l_phase]      += l_now - m_intervalStart;
+      m_cellUpdates[l_phase]   += i_cellUpdates;
+      m_nonZeroFlops[l_phase]  += i_nonZeroFlops;
+      m_hardwareFlops[l_phase] += i_hardwareFlops;
+      m_bytes[l_phase]         += i_bytes;
+      m_intervalStart = l_now;
+    }
+
+    /**
+     * Marks a phase as waiting (communication not finished); repeated calls keep the first point in time.
+     *
+     * @param i_phase phase.
+     **/
+    void wait( Phase i_phase ) {
+      if( m_waitStart[i_phase] < 0 ) m_waitStart[i_phase] = getWallTime();
+    }
+
+    /**
+     * Ends the waiting of a phase (if any).
+     *
+     * @param i_phase phase.
+     **/
+    void proceed( Phase i_phase ) {
+      if( m_waitStart[i_phase] >= 0 ) {
+        m_waitTime[i_phase] += getWallTime() - m_waitStart[i_phase];
+        m_waitStart[i_phase] = -1;
+      }
+    }
+};
+
+#endif
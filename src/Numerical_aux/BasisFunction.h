@@ -0,0 +1,121 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Evaluation of the orthogonal (Dubiner) basis functions on the reference tetrahedron.
+ **/
+
+#ifndef BASISFUNCTION_H_
+#define BASISFUNCTION_H_
+
+#include <cmath>
+
+namespace seissol {
+  namespace basisFunction {
+    /**
+     * Evaluates the Jacobi polynomial P_n^(a,0) at x.
+     **/
+    inline double jacobiP( unsigned int i_n,
+                           unsigned int i_a,
+                           double       i_x ) {
+      if( i_n == 0 ) {
+        return 1;
+      }
+
+      double l_p0 = 1;
+      double l_p1 = 0.5 * ( (i_a+2) * i_x + i_a );
+      for( unsigned int l_i = 2; l_i <= i_n; l_i++ ) {
+        const double l_c = 2*l_i + i_a;
+        const double l_p2 = ( (l_c-1) * (l_c*(l_c-2)*i_x + i_a*i_a) * l_p1 - 2.*(l_i+i_a-1)*(l_i-1)*l_c * l_p0 )
+                          / ( 2.*l_i*(l_i+i_a)*(l_c-2) );
+        l_p0 = l_p1;
+        l_p1 = l_p2;
+      }
+
+      return l_p1;
+    }
+
+    /**
+     * Evaluates the (unnormalized) basis function (i,j,k) at an inner point
+     * (xi, eta, zeta) of the reference tetrahedron.
+     **/
+    inline double tetraDubinerP( unsigned int i_i,
+                                 unsigned int i_j,
+                                 unsigned int i_k,
+                                 const double i_point[3] ) {
+      const double l_sigmaTheta = 1 - i_point[1] - i_point[2];
+      const double l_tau        = 1 - i_point[2];
+
+      return jacobiP( i_i, 0,             (2*i_point[0] - 1 + i_point[1] + i_point[2]) / l_sigmaTheta ) * std::pow( l_sigmaTheta, static_cast<int>(i_i) )
+           * jacobiP( i_j, 2*i_i+1,       (2*i_point[1] - 1 + i_point[2]) / l_tau ) * std::pow( l_tau, static_cast<int>(i_j) )
+           * jacobiP( i_k, 2*i_i+2*i_j+2, 2*i_point[2] - 1 );
+    }
+
+    /**
+     * Returns the number of basis functions of the largest complete polynomial
+     * that fits into a (possibly padded) number of basis functions.
+     **/
+    inline unsigned int getNumberOfPolynomialBasisFunctions( unsigned int i_numberOfBasisFunctions ) {
+      unsigned int l_order = 1;
+      while( (l_order+1)*(l_order+2)*(l_order+3)/6 <= i_numberOfBasisFunctions ) {
+        l_order++;
+      }
+
+      return l_order*(l_order+1)*(l_order+2)/6;
+    }
+
+    /**
+     * Evaluates the basis functions at an inner point of the reference tetrahedron.
+     *
+     * @param i_point point (xi, eta, zeta) in the reference tetrahedron.
+     * @param i_numberOfBasisFunctions number of basis functions (complete polynomial).
+     * @param o_values values of the basis functions in the order of the DOFs.
+     **/
+    inline void evaluateTetra( const double i_point[3],
+                               unsigned int i_numberOfBasisFunctions,
+                               double*      o_values ) {
+      unsigned int l_basis = 0;
+      for( unsigned int l_order = 0; l_basis < i_numberOfBasisFunctions; l_order++ ) {
+        for( unsigned int l_k = 0; l_k <= l_order; l_k++ ) {
+          for( unsigned int l_j = 0; l_j <= l_order-l_k; l_j++ ) {
+            o_values[l_basis] = tetraDubinerP( l_order-l_j-l_k, l_j, l_k, i_point );
+            l_basis++;
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif
@@ -385,7 +385,7 @@ MODULE TypesDef
                                                      !< 4 = rec RK DG
                                                      !< 5 = Nonlinear ADER DG
                                                      !< 6 = local RK-DG, ADD eqn.
-    integer           :: clusteredLts                !< 0 = file, 1 = GTS, 2-n: multi-rate
+    integer           :: clusteredLts                !< 0 = file, 1 = GTS, 2-n: multi-rate, -n: optimal multi-rate up to n
     INTEGER           :: CKMethod                    !< 0 = regular CK
                                                      !< 1 = local space-time DG
                                                      !<
@@ -1215,10 +1215,21 @@ MODULE TypesDef
   !< Check pointing configuration
   type tCheckPoint
      real                                   :: interval                         !< Check point interval (0 = no checkpointing)
+     real                                   :: mtbf                             !< Mean time between failures in wall clock seconds (0 = fixed interval)
      character(len=600)                     :: filename                         !< Check point filename
      character(len=64)                      :: backend                          !< Check point backend
   end type tCheckPoint
 
+  !< Synthetic cube mesh configuration (meshgenerator = 'CubeGenerator')
+  type tCubeGenerator
+     integer                                :: size(3)                          !< Number of hexahedra in x, y and z direction (6 tetrahedra each)
+     integer                                :: partitions(3)                    !< Number of partitions in x, y and z direction (0 = automatic)
+     real                                   :: scale(3)                         !< Extent of the cube in x, y and z direction
+     real                                   :: grading                          !< Growth factor of the element height in z direction (1 = uniform)
+     integer                                :: boundaries(6)                    !< Boundary conditions of the faces -x, +x, -y, +y, -z, +z
+     real                                   :: materialLayer                    !< Fraction of the height (from the bottom) with material group 2
+  end type tCubeGenerator
+
   !<--------------------------------------------------------------------------
   !<
   !<--- Input and Output -----------------------------------------------------
@@ -1346,6 +1357,13 @@ MODULE TypesDef
      INTEGER                                :: Mesh_is_structured_nk            !< Number of elements in k direction
      INTEGER                                :: nrPlotVar                        !< Number of variables for output
      INTEGER                                :: Format                           !< 0=IDL, 1=TECPLOT, 2=IBM Open DX
+     INTEGER                                :: Refinement                       !< Refinement of the XDMF wave field output (0=none, 1=8 subtets)
+     INTEGER                                :: OutputRegion                     !< Region of the XDMF wave field output (0=all, 1=box, 2=free surface cells)
+     REAL                                   :: OutputRegionBounds(6)            !< Bounding box of the XDMF output region (xmin,xmax,ymin,ymax,zmin,zmax)
+     INTEGER                                :: CompressionMode                  !< Lossy compression of the XDMF output (0=none, 1=absolute, 2=relative error)
+     REAL                                   :: CompressionTolerance(9)          !< Error bound of each XDMF output variable
+     INTEGER                                :: SurfaceOutput                    !< 1 if the velocities at the free surface are written
+     REAL                                   :: SurfaceOutputInterval            !< Time interval of the free surface output
      INTEGER                                :: dimension                        !< Dimension for output (OneD,2d,3d)
      LOGICAL                                :: dimensionMask(3)                 !< Mask which Dimension is writen
      INTEGER                                :: dimensionIndex(3)                !< Index which is kept constant
@@ -1426,6 +1444,8 @@ MODULE TypesDef
      TYPE(tUnitNumbers)                     :: UNIT                             !< Structure for unit numbers
      TYPE(tDR)                              :: DR                               !< Fault-based output
      CHARACTER(LEN=600)                     :: FileName_BackgroundStress        !< File name of background stress field heterogeneous
+     INTEGER                                :: BackgroundStressStream           !< Broadcast content of the background stress file
+     INTEGER                                :: FaultFileStream                  !< Broadcast content of Par_file_faults
      REAL                                   :: WallStart                        !< starttime
      REAL                                   :: WallTime_h, WallTime_s           !< wall clock time in hours / seconds
      REAL                                   :: Delay_h, Delay_s                 !<
@@ -1440,6 +1460,7 @@ MODULE TypesDef
 #endif
 
      type(tCheckPoint)                      :: checkpoint                       !< Checkpointing configuration
+     type(tCubeGenerator)                   :: cube                             !< Synthetic cube mesh configuration
   END TYPE tInputOutput
 
   !<--------------------------------------------------------------------------
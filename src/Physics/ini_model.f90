@@ -84,6 +84,7 @@ CONTAINS
     USE TrilinearInterpolation_mod
     USE read_backgroundstress_mod
     USE ini_model_DR_mod
+    USE ParallelIStreamCBinding
 
     !--------------------------------------------------------------------------
     IMPLICIT NONE
@@ -907,6 +908,16 @@ CONTAINS
 
       ENDIF ! EQN%DR.EQ.1
 
+      ! Free the dynamic rupture input files (broadcast to all ranks in readpar)
+      IF (IO%FaultFileStream .GE. 0) THEN
+        CALL closeParallelFile(IO%FaultFileStream)
+        IO%FaultFileStream = -1
+      ENDIF
+      IF (IO%BackgroundStressStream .GE. 0) THEN
+        CALL closeParallelFile(IO%BackgroundStressStream)
+        IO%BackgroundStressStream = -1
+      ENDIF
+
   END SUBROUTINE ini_MODEL
 
 
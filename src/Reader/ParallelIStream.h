@@ -45,27 +45,95 @@
 #include "utils/logger.h"
 
 #include <fstream>
-#include <sstream>
+#include <istream>
+#include <streambuf>
 #include <vector>
 
-class ParallelIStream : public std::wistringstream
+/**
+ * Input stream for (small) files that are required by all ranks.
+ *
+ * The file is only read by rank 0 and the content is broadcast to all other
+ * ranks. The file is read in binary mode and broadcast in chunks of bytes,
+ * so files larger than 2 GiB are supported as well.
+ */
+class ParallelIStream : public std::istream
 {
 private:
+	/** Maximum number of bytes broadcast at once */
+	static const unsigned long CHUNK_SIZE = 1ul << 30;
+
+	/**
+	 * Stream buffer that reads from memory
+	 */
+	class Buffer : public std::streambuf
+	{
+	public:
+		void set(char* data, unsigned long size)
+		{
+			setg(data, data, data + size);
+		}
+
+	protected:
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+				std::ios_base::openmode which = std::ios_base::in)
+		{
+			if (!(which & std::ios_base::in))
+				return pos_type(off_type(-1));
+
+			off_type pos;
+			switch (dir) {
+			case std::ios_base::beg:
+				pos = off;
+				break;
+			case std::ios_base::cur:
+				pos = gptr() - eback() + off;
+				break;
+			default:
+				pos = egptr() - eback() + off;
+			}
+
+			if (pos < 0 || pos > egptr() - eback())
+				return pos_type(off_type(-1));
+
+			setg(eback(), eback() + pos, egptr());
+			return pos_type(pos);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in)
+		{
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+	};
+
+	/** The stream buffer */
+	Buffer m_streamBuffer;
+
 	/** Contains the content of the file */
-	std::vector<wchar_t> m_buffer;
+	std::vector<char> m_buffer;
 
 public:
 	ParallelIStream()
+		: std::istream(0L)
 	{
+		rdbuf(&m_streamBuffer);
 	}
 
 	ParallelIStream(const char* filename)
+		: std::istream(0L)
 	{
+		rdbuf(&m_streamBuffer);
 		open(filename);
 	}
 
+	/**
+	 * Reads the file on rank 0 and broadcasts it to all ranks
+	 *
+	 * This is a collective operation.
+	 */
 	void open(const char* filename)
 	{
+		unsigned long size = 0;
+
 #ifdef PARALLEL
 		int rank;
 		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -75,33 +143,43 @@ public:
 
 			// Open the file and set the buffer
 			// This only done on rank 0 when running in parallel
-			std::wifstream file(filename);
+			std::ifstream file(filename, std::ios::binary);
 			if (!file)
 				logError() << "Could not open file" << filename;
 
 			file.seekg(0, std::ios::end);
-			m_buffer.resize(file.tellg());
+			size = file.tellg();
 			file.seekg(0, std::ios::beg);
 
-			file.read(&m_buffer[0], m_buffer.size());
-
-			rdbuf()->pubsetbuf(&m_buffer[0], m_buffer.size());
+			m_buffer.resize(size);
+			if (size > 0)
+				file.read(&m_buffer[0], size);
+			if (!file)
+				logError() << "Could not read file" << filename;
 
 #ifdef PARALLEL
-			// Broadcast the size and the content of the file
-			unsigned long size = m_buffer.size();
-			MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-			MPI_Bcast(&m_buffer[0], size, MPI_WCHAR, 0, MPI_COMM_WORLD);
-		} else {
-			unsigned long size;
-			MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+		}
 
-			m_buffer.resize(size);
-			MPI_Bcast(&m_buffer[0], size, MPI_WCHAR, 0, MPI_COMM_WORLD);
+		// Broadcast the size and the content of the file
+		MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+		m_buffer.resize(size);
 
-			rdbuf()->pubsetbuf(&m_buffer[0], size);
+		for (unsigned long offset = 0; offset < size; offset += CHUNK_SIZE) {
+			unsigned long chunk = (size - offset < CHUNK_SIZE ? size - offset : CHUNK_SIZE);
+			MPI_Bcast(&m_buffer[offset], chunk, MPI_CHAR, 0, MPI_COMM_WORLD);
 		}
 #endif // PARALLEL
+
+		m_streamBuffer.set((size > 0 ? &m_buffer[0] : 0L), size);
+		clear();
+	}
+
+	/**
+	 * @return The size of the file in bytes
+	 */
+	unsigned long size() const
+	{
+		return m_buffer.size();
 	}
 };
 
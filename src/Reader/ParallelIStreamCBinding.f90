@@ -0,0 +1,258 @@
+!>
+!! @file
+!! This file is part of SeisSol.
+!!
+!! @author Sebastian Rettenberger (rettenbs AT in.tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger,_M.Sc.)
+!!
+!! @section LICENSE
+!! Copyright (c) 2015, SeisSol Group
+!! All rights reserved.
+!! 
+!! Redistribution and use in source and binary forms, with or without
+!! modification, are permitted provided that the following conditions are met:
+!! 
+!! 1. Redistributions of source code must retain the above copyright notice,
+!!    this list of conditions and the following disclaimer.
+!! 
+!! 2. Redistributions in binary form must reproduce the above copyright notice,
+!!    this list of conditions and the following disclaimer in the documentation
+!!    and/or other materials provided with the distribution.
+!! 
+!! 3. Neither the name of the copyright holder nor the names of its
+!!    contributors may be used to endorse or promote products derived from this
+!!    software without specific prior written permission.
+!! 
+!! THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+!! AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+!! IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+!! ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+!! LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+!! CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+!! SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+!! INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+!! CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+!! ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+!! POSSIBILITY OF SUCH DAMAGE.
+!!
+!! @section DESCRIPTION
+!! Fortran interface for files that are read by rank 0 and broadcast to all ranks
+
+#ifdef BG
+#include "../Initializer/preProcessorMacros.fpp"
+#else
+#include "Initializer/preProcessorMacros.fpp"
+#endif
+
+module ParallelIStreamCBinding
+    use TypesDef
+
+    use iso_c_binding
+
+    implicit none
+
+    interface
+        function parallel_istream_open(filename) bind(C, name="parallel_istream_open")
+            use, intrinsic :: iso_c_binding
+
+            character( kind=c_char ), dimension(*), intent(in) :: filename
+            integer( kind=c_int )                              :: parallel_istream_open
+        end function
+
+        subroutine parallel_istream_getline(handle, line, length, status) bind(C, name="parallel_istream_getline")
+            use, intrinsic :: iso_c_binding
+
+            integer( kind=c_int ), value                       :: handle
+            character( kind=c_char ), dimension(*)             :: line
+            integer( kind=c_int ), value                       :: length
+            integer( kind=c_int )                              :: status
+        end subroutine
+
+        subroutine parallel_istream_rewind(handle) bind(C, name="parallel_istream_rewind")
+            use, intrinsic :: iso_c_binding
+
+            integer( kind=c_int ), value                       :: handle
+        end subroutine
+
+        subroutine parallel_istream_close(handle) bind(C, name="parallel_istream_close")
+            use, intrinsic :: iso_c_binding
+
+            integer( kind=c_int ), value                       :: handle
+        end subroutine
+    end interface
+
+contains
+    !> Reads a file on rank 0 and broadcasts the content to all ranks
+    !! (collective operation)
+    !!
+    !! @return A handle for the stream
+    integer function openParallelFile(name)
+        implicit none
+
+        character(len=*), intent(in) :: name
+
+        openParallelFile = parallel_istream_open(trim(name) // c_null_char)
+    end function openParallelFile
+
+    !> Reads the next line of a stream
+    !!
+    !! @param ios 0 on success, negative at the end of the file
+    subroutine readParallelLine(stream, line, ios)
+        implicit none
+
+        integer, intent(in)           :: stream
+        character(len=*), intent(out) :: line
+        integer, intent(out)          :: ios
+
+        integer( kind=c_int )         :: status
+
+        call parallel_istream_getline(stream, line, len(line), status)
+        if (status > 0) then
+            logError(*) 'Line longer than', len(line), 'characters in input file'
+            stop
+        endif
+        ios = status
+    end subroutine readParallelLine
+
+    !> Reads all lines of a stream, e.g. to read namelists from the
+    !! internal file
+    subroutine readParallelLines(stream, lines)
+        implicit none
+
+        integer, intent(in)                          :: stream
+        character(len=*), allocatable, intent(inout) :: lines(:)
+
+        integer                                      :: nLines
+        integer                                      :: ios
+        character(len=len(lines))                    :: line
+
+        call parallel_istream_rewind(stream)
+        nLines = 0
+        do
+            call readParallelLine(stream, line, ios)
+            if (ios /= 0) exit
+            nLines = nLines + 1
+        enddo
+
+        if (allocated(lines)) then
+            deallocate(lines)
+        endif
+        ! Internal files require at least one record
+        allocate(lines(max(nLines, 1)))
+        lines(:) = ''
+
+        call parallel_istream_rewind(stream)
+        do nLines = 1, size(lines)
+            call readParallelLine(stream, lines(nLines), ios)
+        enddo
+    end subroutine readParallelLines
+
+    subroutine rewindParallelFile(stream)
+        implicit none
+
+        integer, intent(in) :: stream
+
+        call parallel_istream_rewind(stream)
+    end subroutine rewindParallelFile
+
+    subroutine closeParallelFile(stream)
+        implicit none
+
+        integer, intent(in) :: stream
+
+        call parallel_istream_close(stream)
+    end subroutine closeParallelFile
+
+    !> Finds the beginning of a namelist group in the lines of a file
+    !!
+    !! Namelists read from internal files always start at the first record.
+    !! This function allows to read several groups with the same name
+    !! one after another.
+    !!
+    !! @param group The name of the group (case insensitive)
+    !! @param start The first line that is checked
+    !! @return The line that contains the beginning of the group or 0
+    !!  if the group was not found
+    integer function findNamelist(lines, group, start)
+        implicit none
+
+        character(len=*), intent(in) :: lines(:)
+        character(len=*), intent(in) :: group
+        integer, intent(in)          :: start
+
+        integer                      :: i
+        character(len=len(lines))    :: line
+
+        do i = start, size(lines)
+            line = adjustl(lines(i))
+            if (line(1:1) /= '&' .and. line(1:1) /= '$') cycle
+            if (len_trim(group)+1 > len(line)) cycle
+            if (.not. equalsIgnoreCase(line(2:len_trim(group)+1), trim(group))) cycle
+            if (len_trim(group)+2 <= len(line)) then
+                if (line(len_trim(group)+2:len_trim(group)+2) /= ' ') cycle
+            endif
+
+            findNamelist = i
+            return
+        enddo
+
+        findNamelist = 0
+    end function findNamelist
+
+    !> Finds the end of a namelist group
+    !!
+    !! @param start The line that contains the beginning of the group
+    !! @return The line that contains the terminating slash or 0 if
+    !!  the group is not terminated
+    integer function findNamelistEnd(lines, start)
+        implicit none
+
+        character(len=*), intent(in) :: lines(:)
+        integer, intent(in)          :: start
+
+        integer                      :: i
+        integer                      :: j
+        character                    :: quote
+
+        quote = ' '
+        do i = start, size(lines)
+            do j = 1, len_trim(lines(i))
+                if (quote /= ' ') then
+                    if (lines(i)(j:j) == quote) quote = ' '
+                elseif (lines(i)(j:j) == '"' .or. lines(i)(j:j) == "'") then
+                    quote = lines(i)(j:j)
+                elseif (lines(i)(j:j) == '!') then
+                    exit
+                elseif (lines(i)(j:j) == '/') then
+                    findNamelistEnd = i
+                    return
+                endif
+            enddo
+        enddo
+
+        findNamelistEnd = 0
+    end function findNamelistEnd
+
+    logical function equalsIgnoreCase(a, b)
+        implicit none
+
+        character(len=*), intent(in) :: a
+        character(len=*), intent(in) :: b
+
+        integer                      :: i
+        integer                      :: ca
+        integer                      :: cb
+
+        equalsIgnoreCase = .false.
+        if (len(a) /= len(b)) return
+
+        do i = 1, len(a)
+            ca = iachar(a(i:i))
+            cb = iachar(b(i:i))
+            if (ca >= iachar('A') .and. ca <= iachar('Z')) ca = ca + 32
+            if (cb >= iachar('A') .and. cb <= iachar('Z')) cb = cb + 32
+            if (ca /= cb) return
+        enddo
+
+        equalsIgnoreCase = .true.
+    end function equalsIgnoreCase
+end module ParallelIStreamCBinding
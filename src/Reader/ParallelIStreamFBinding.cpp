@@ -0,0 +1,128 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @author Sebastian Rettenberger (rettenbs AT in.tum.de, http://www5.in.tum.de/wiki/index.php/Sebastian_Rettenberger,_M.Sc.)
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * C functions for reading broadcast files from Fortran
+ **/
+
+#include "ParallelIStream.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "utils/logger.h"
+
+/** All open streams; the handle is the index in this vector */
+static std::vector<ParallelIStream*> streams;
+
+static ParallelIStream& getStream(int handle)
+{
+	if (handle < 0 || handle >= static_cast<int>(streams.size()) || streams[handle] == 0L)
+		logError() << "Invalid parallel stream handle" << handle;
+
+	return *streams[handle];
+}
+
+extern "C" {
+
+/**
+ * Reads a file on rank 0 and broadcasts it to all ranks (collective)
+ *
+ * @return A handle for the stream
+ */
+int parallel_istream_open(const char* filename)
+{
+	int handle = 0;
+	while (handle < static_cast<int>(streams.size()) && streams[handle] != 0L)
+		handle++;
+	if (handle == static_cast<int>(streams.size()))
+		streams.push_back(0L);
+
+	streams[handle] = new ParallelIStream(filename);
+
+	return handle;
+}
+
+/**
+ * Reads the next line of a stream
+ *
+ * The line is padded with spaces (Fortran string).
+ *
+ * @param status 0 on success, -1 at the end of the stream or 1 if the line
+ *  does not fit into the buffer
+ */
+void parallel_istream_getline(int handle, char* line, int length, int* status)
+{
+	ParallelIStream& stream = getStream(handle);
+
+	std::string buffer;
+	if (!std::getline(stream, buffer)) {
+		*status = -1;
+		return;
+	}
+
+	// Remove carriage return from files with DOS line endings
+	if (!buffer.empty() && buffer[buffer.size()-1] == '\r')
+		buffer.resize(buffer.size()-1);
+
+	if (static_cast<int>(buffer.size()) > length) {
+		*status = 1;
+		return;
+	}
+
+	memcpy(line, buffer.c_str(), buffer.size());
+	memset(line + buffer.size(), ' ', length - buffer.size());
+	*status = 0;
+}
+
+void parallel_istream_rewind(int handle)
+{
+	ParallelIStream& stream = getStream(handle);
+
+	stream.clear();
+	stream.seekg(0);
+}
+
+void parallel_istream_close(int handle)
+{
+	getStream(handle);
+
+	delete streams[handle];
+	streams[handle] = 0L;
+}
+
+}
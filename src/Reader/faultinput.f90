@@ -48,6 +48,7 @@ module faultinput_mod
   use TypesDef
   use DGBasis_mod
   use read_backgroundstress_mod
+  use ParallelIStreamCBinding
   !---------------------------------------------------------------------------!
   implicit none
   private
@@ -56,6 +57,11 @@ module faultinput_mod
   logical :: param_error_thrown = .false.
   logical :: dir_error_thrown = .false.
   logical :: shape_error_thrown = .false.
+
+  ! Content of Par_file_faults (read by rank 0 and broadcast in readpar)
+  character(len=700), allocatable :: faultLines(:)
+  ! Line where the search for the next dist2d namelist starts
+  integer :: nextDistLine
   !---------------------------------------------------------------------------!
   public :: faultinput
   private :: read_specfem3d
@@ -159,10 +165,7 @@ module faultinput_mod
   	geoZ(:) = (/0, 0, 1/)
 
 
-  	open(IO%unit%FileIn_Fault, file="Par_file_faults", status='old', action="read", iostat=ios)
-    if (ios /= 0) then
-        logError(*) 'Error opening the local fault parameter file. File "Par_file_faults" present?'
-    end if
+  	call readParallelLines(IO%FaultFileStream, faultLines)
 
     ! Get total number of heterogeneous distribution blocks
     nSum = cnt_dist(eqn, IO)
@@ -183,7 +186,7 @@ module faultinput_mod
         end if
   	end do
 
-  	close(IO%unit%FileIn_Fault)
+  	deallocate(faultLines)
 
 
   	! Process stress input
@@ -321,11 +324,10 @@ module faultinput_mod
 
 
     ! Read in stress_tensor, init_stress and SWF namelists (each may not be present)
-  	read(IO%unit%FileIn_Fault, nml=stress_tensor, iostat=ios)
+  	read(faultLines, nml=stress_tensor, iostat=ios)
     if (ios > 0) then
         logError(*) 'Error reading in the stress_tensor namelist.'
     end if
-    rewind(IO%unit%FileIn_Fault)
     ! Save constant values
     eqn%IniBulk_xx(:,:)  =  Sigma(global_xx)
     eqn%IniBulk_yy(:,:)  =  Sigma(global_yy)
@@ -334,23 +336,22 @@ module faultinput_mod
     eqn%IniShearYZ(:,:)  =  Sigma(global_yz)
     eqn%IniShearXZ(:,:)  =  Sigma(global_xz)
 
-  	read(IO%unit%FileIn_Fault, nml=init_stress, iostat=ios)
+  	read(faultLines, nml=init_stress, iostat=ios)
     if (ios > 0) then
         logError(*) 'Error reading in the init_stress namelist.'
     end if
-    rewind(IO%unit%FileIn_Fault)
     localStress_0(1) = S1 ! along-strike
     localStress_0(2) = S2 ! along-dip
     localStress_0(3) = S3 ! fault-normal
 
-  	read(IO%unit%FileIn_Fault, nml=SWF, iostat=ios)
+  	read(faultLines, nml=SWF, iostat=ios)
     if (ios > 0) then
         logError(*) 'Error reading in the SWF namelist.'
     end if
     if (ios == 0 .and. eqn%FL /= 2) then
         logError(*) 'Slip weakening parameters set in Par_file_faults, while friction type is not set to linear slip weakening.'
     end if
-    rewind(IO%unit%FileIn_Fault)
+    nextDistLine = 1
     ! Save constant values
     disc%DynRup%Mu_S(:,:) = mus
     disc%DynRup%Mu_D(:,:) = mud
@@ -595,7 +596,7 @@ module faultinput_mod
     ios = 0
     cntDist = 0
 
-    rewind(IO%unit%FileIn_Fault)
+    nextDistLine = 1
 
     do while (ios == 0)
         call read_dist(eqn, IO, tmpDist, ios)
@@ -604,7 +605,7 @@ module faultinput_mod
         end if
     end do
 
-    rewind(IO%unit%FileIn_Fault)
+    nextDistLine = 1
 
     cnt_dist = cntDist
 
@@ -631,6 +632,7 @@ module faultinput_mod
   	real :: l														! Side length of the square
   	real :: lx, ly, lz												! Side lengths of the rectangle, distortion length of the ellipse, height of the cylinders
   	real :: r														! Radius of the circle and ellipse
+    integer :: start                                                ! Line of the namelist
 
   	! Namelist
   	namelist /dist2d/ param, dir, shapeval, val, valh, xc, yc, zc, r, l, lx, ly, lz
@@ -652,10 +654,18 @@ module faultinput_mod
     r = 0.0
 
     ! read in the heterogeneous distribution block
-  	read(IO%UNIT%FileIn_Fault, nml=dist2d, iostat=ios)
+    ! Internal files are always read from the beginning, so we search
+    ! for the next namelist ourselves
+    start = findNamelist(faultLines, 'dist2d', nextDistLine)
+    if (start == 0) then
+        ios = -1
+        return
+    end if
+  	read(faultLines(start:), nml=dist2d, iostat=ios)
     if ( ios /= 0 ) then
         return
     end if
+    nextDistLine = start + 1
 
   	! Copy read-in values into distribution struct
   	dist%val = val
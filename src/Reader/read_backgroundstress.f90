@@ -47,6 +47,7 @@ MODULE read_backgroundstress_mod
   !---------------------------------------------------------------------------!
   USE TypesDef
   USE COMMON_operators_mod
+  USE ParallelIStreamCBinding
   !---------------------------------------------------------------------------!
   IMPLICIT NONE
   PRIVATE
@@ -386,6 +387,8 @@ CONTAINS
     INTEGER, TARGET                 :: nodes_nx, nodes_nz
     INTEGER                         :: intDummy
     REAL                            :: realDummy
+    CHARACTER(LEN=700)              :: line
+    INTEGER                         :: ios
     !-------------------------------------------------------------------------!
     INTENT(INOUT)                   :: IO                                                 
     INTENT(INOUT)                   :: DISC
@@ -393,15 +396,16 @@ CONTAINS
     
     logInfo(*) 'Rupture model read from ', TRIM(IO%FileName_BackgroundStress)
     
-    CALL OpenFile(                                       &                        
-         UnitNr       = IO%UNIT%other01                , &                        
-         Name         = IO%FileName_BackgroundStress   , &
-         create       = .FALSE.                          )    
-        
+    ! The file was already read by rank 0 and broadcast in readpar
+    CALL rewindParallelFile(IO%BackgroundStressStream)
+
     ! Read header
-    READ(IO%UNIT%other01,*) intDummy, intDummy
-    READ(IO%UNIT%other01,*) nodes_nx, nodes_nz, realDummy, realDummy
-    READ(IO%UNIT%other01,*) intDummy, intDummy, realDummy, realDummy, realDummy, realDummy
+    CALL readParallelLine(IO%BackgroundStressStream, line, ios)
+    READ(line,*) intDummy, intDummy
+    CALL readParallelLine(IO%BackgroundStressStream, line, ios)
+    READ(line,*) nodes_nx, nodes_nz, realDummy, realDummy
+    CALL readParallelLine(IO%BackgroundStressStream, line, ios)
+    READ(line,*) intDummy, intDummy, realDummy, realDummy, realDummy, realDummy
     
     DISC%DynRup%bg_stress%nx = nodes_nx+1
     DISC%DynRup%bg_stress%nz = nodes_nz+1
@@ -425,7 +429,12 @@ CONTAINS
     
     ! Read data (14 columns)
     DO i = 1,lines
-        READ(IO%UNIT%other01,*) intDummy, intDummy, &
+        CALL readParallelLine(IO%BackgroundStressStream, line, ios)
+        IF (ios /= 0) THEN
+            logError(*) 'Unexpected end of file ', TRIM(IO%FileName_BackgroundStress)
+            STOP
+        ENDIF
+        READ(line,*) intDummy, intDummy, &
         DISC%DynRup%bg_stress%strike(i), DISC%DynRup%bg_stress%dip(i), &
         DISC%DynRup%bg_stress%fields(1,i), DISC%DynRup%bg_stress%fields(2,i), &
         DISC%DynRup%bg_stress%fields(3,i), realDummy, realDummy, &
@@ -433,7 +442,6 @@ CONTAINS
         DISC%DynRup%bg_stress%fields(7,i), DISC%DynRup%bg_stress%fields(8,i)
     ENDDO ! i lines
   
-    CLOSE(IO%UNIT%other01)
     
     logInfo(*) 'Rupture model read in successfully! '
   
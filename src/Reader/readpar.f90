@@ -44,6 +44,7 @@ MODULE COMMON_readpar_mod
   !----------------------------------------------------------------------------
   USE TypesDef
   USE COMMON_operators_mod
+  USE ParallelIStreamCBinding
   !----------------------------------------------------------------------------
   IMPLICIT NONE
   PRIVATE
@@ -113,6 +114,7 @@ MODULE COMMON_readpar_mod
   !----------------------------------------------------------------------------
 
   LOGICAL :: CalledFromStructCode ! 
+  CHARACTER(LEN=700), ALLOCATABLE :: parameterLines(:) ! Content of the parameter file (read by rank 0 and broadcast)
 
 CONTAINS
 
@@ -136,6 +138,7 @@ CONTAINS
     INTEGER                         :: actual_version_of_readpar
     CHARACTER(LEN=600)              :: Name
     CHARACTER(LEN=801)              :: Name1
+    INTEGER                         :: parameterFile
     !--------------------------------------------------------------------------
     INTENT(IN)                      :: programTitle
     INTENT(OUT)                     :: IC, BND, DISC, SOURCE, ANALYSE,Debug
@@ -145,6 +148,8 @@ CONTAINS
     !--------------------------------------------------------------------------
     !                                                                        !        
     IO%Mesh_is_structured       = .FALSE.                                    ! PostProcessing in default position
+    IO%FaultFileStream          = -1                                         ! Dynamic rupture input files are
+    IO%BackgroundStressStream   = -1                                         ! broadcast later if required
     SOURCE%Type                 = 0                                          ! switch for source terms in deflt pos.
     !                                                                        !   
     IF (PRESENT(usMESH)) THEN                                                !
@@ -163,10 +168,11 @@ CONTAINS
     Name1 = TRIM(IO%ParameterFile)                       !
     Name = Name1(1:600)
     !                                                                        ! 
-    CALL OpenFile(                                                         & !
-         UnitNr       = IO%UNIT%FileIn                                   , & !
-         Name         = name                                             , & !
-         create       = .FALSE.                                            ) !
+    ! Only rank 0 reads the parameter file, namelists are read from the
+    ! broadcast content
+    parameterFile = openParallelFile(name)                                   !
+    CALL readParallelLines(parameterFile, parameterLines)                    !
+    CALL closeParallelFile(parameterFile)                                    !
     !                                                                        ! 
     CALL readpar_header(IO,IC,actual_version_of_readpar,programTitle) !
     !                                                                        !
@@ -192,7 +198,7 @@ CONTAINS
     !                                                                        !        
     CALL readpar_debug(IO,Debug)                                             !   read Debug
     !                                                                        !        
-    CLOSE(IO%UNIT%FileIn,status='keep')                                      !
+    DEALLOCATE(parameterLines)                                               !
     !                                                                        !        
     CALL analyse_readpar(EQN,DISC,usMESH,IC,SOURCE,IO,MPI)                   ! Check parameterfile...
     !                                                                        ! and write restart.par       
@@ -383,7 +389,7 @@ CONTAINS
     RandomField_Flag    = 0
     nMechanisms         = 0
     !
-    READ(IO%UNIT%FileIn, nml = Equations) 
+    READ(parameterLines, nml = Equations) 
     !       
 
     !
@@ -741,7 +747,7 @@ CONTAINS
     NAMELIST                                         /RFFile/ RF_Files
     !------------------------------------------------------------------------
     ALLOCATE(RF_Files(number))
-    READ(IO%UNIT%FileIn, nml = RFFile)      ! Write in namelistfile RF_File(1) = ... and in the next line RF_Files(2) = ...
+    READ(parameterLines, nml = RFFile)      ! Write in namelistfile RF_File(1) = ... and in the next line RF_Files(2) = ...
                                             ! according to the number of Random Fields  
   END SUBROUTINE
     !------------------------------------------------------------------------
@@ -989,7 +995,7 @@ CONTAINS
     amplitude = 0.0
     hwidth(:) = 5.0e3           ! in inputfile you can choose different values for x,y,z
     !
-    READ(IO%UNIT%FileIn, nml = IniCondition)
+    READ(parameterLines, nml = IniCondition)
  
     ! Renaming all variables in the beginning
      IC%cICType = cICType
@@ -1330,7 +1336,7 @@ CONTAINS
     OutputMask(1:3) = 1
     OutputMask(4) = 0
     !
-    READ(IO%UNIT%FileIn, nml = Pickpoint)
+    READ(parameterLines, nml = Pickpoint)
     !                                              
      DISC%DynRup%DynRup_out_atPickpoint%printtimeinterval = printtimeinterval   ! read time interval at which output will be written
      DISC%DynRup%DynRup_out_atPickpoint%OutputMask(1:4) =  OutputMask(1:4)      ! read info of desired output 1/ yes, 0/ no
@@ -1407,7 +1413,7 @@ CONTAINS
     refinement = 2
     BinaryOutput = 0 ! 0/ASCII 1/binary float 2/binary double
     !
-    READ(IO%UNIT%FileIn, nml = Elementwise)
+    READ(parameterLines, nml = Elementwise)
     !
     DISC%DynRup%DynRup_out_elementwise%printtimeinterval = printtimeinterval   ! read time interval at which output will be written
     DISC%DynRup%DynRup_out_elementwise%OutputMask(1:6) =  OutputMask(1:6)      ! read info of desired output 1/ yes, 0/ no
@@ -1474,7 +1480,7 @@ CONTAINS
     BC_of = 0
     BC_pe = 0
     !
-    READ (IO%UNIT%FileIn, nml = Boundaries)
+    READ (parameterLines, nml = Boundaries)
     !
       !    
       BND%NoBndObjects(:) = 0                                                                                        
@@ -1672,11 +1678,15 @@ CONTAINS
     !FileName_BackgroundStress = 'tpv16_input_file.txt'
 
            ! Read-in dynamic rupture parameters
-           READ(IO%UNIT%FileIn, nml = DynamicRupture)
+           READ(parameterLines, nml = DynamicRupture)
            logInfo(*) 'Beginning dynamic rupture initialization. '
            
            ! Read fault parameters from Par_file_faults?
            DISC%DynRup%read_fault_file = read_fault_file
+           IF (read_fault_file == 1) THEN
+             ! Broadcast the file now; faultinput is not called by all ranks
+             IO%FaultFileStream = openParallelFile('Par_file_faults')
+           ENDIF
 
            !FRICTION LAW CHOICE
            EQN%FL = FL
@@ -1698,6 +1708,8 @@ CONTAINS
              DISC%DynRup%cohesion_0 = cohesion_0
            CASE(16,17)
              IO%FileName_BackgroundStress = FileName_BackgroundStress
+             ! Broadcast the file now; it is not read by all ranks
+             IO%BackgroundStressStream = openParallelFile(FileName_BackgroundStress)
              EQN%GPwise = GPwise
              EQN%XRef = XRef
              EQN%YRef = YRef
@@ -1859,7 +1871,7 @@ CONTAINS
     NAMELIST                               /InflowBound/ setvar, char_option, &
                                                          PWFileName
     !------------------------------------------------------------------------
-    READ(IO%UNIT%FileIn, nml = InflowBound)
+    READ(parameterLines, nml = InflowBound)
 
       DO i=1,n4
          j = 1
@@ -1995,7 +2007,7 @@ CONTAINS
     NAMELIST                               /InflowBoundPWFile/ varfield
     !-----------------------------------------------------------------------
     ALLOCATE(varfield(number))
-    READ(IO%UNIT%FileIn, nml = InflowBoundPWFile) ! Write in namelistfile varfield(1) = ... and in the next line varfield(2) = ...
+    READ(parameterLines, nml = InflowBoundPWFile) ! Write in namelistfile varfield(1) = ... and in the next line varfield(2) = ...
                                                   ! and the same for u0_in
   END SUBROUTINE
     !------------------------------------------------------------------------
@@ -2011,7 +2023,7 @@ CONTAINS
     !-----------------------------------------------------------------------
     ALLOCATE(u0_in(EQN%nVar))
     
-    READ(IO%UNIT%FileIn, nml = InflowBounduin) ! Write in namelistfile u0_in(1) = ... and in the next line u0_in(2) = ...
+    READ(parameterLines, nml = InflowBounduin) ! Write in namelistfile u0_in(1) = ... and in the next line u0_in(2) = ...
                                                
   END SUBROUTINE
 
@@ -2061,7 +2073,7 @@ CONTAINS
     ! Setting default values
     Type = 0  
     !
-    READ(IO%UNIT%FileIn, nml = SourceType)
+    READ(parameterLines, nml = SourceType)
     SOURCE%Type = Type  
    SELECT CASE(SOURCE%Type)                                                 !
     
@@ -2656,7 +2668,7 @@ CONTAINS
     NAMELIST                               /Source110/ U0, l1
     !-----------------------------------------------------------------------
         
-    READ(IO%UNIT%FileIn, nml = Source110) ! Write in namelistfile U0(1) = ... and in the next line U0(2) = ...
+    READ(parameterLines, nml = Source110) ! Write in namelistfile U0(1) = ... and in the next line U0(2) = ...
                                                   ! and the same for l1 
   END SUBROUTINE
 
@@ -2677,7 +2689,7 @@ ALLOCATE( SpacePositionx(nDirac), &
           Intensity(nDirac),       &
           EqnNr(nDirac))
 
-    READ(IO%UNIT%FileIn, nml = Source15) ! Write in namelistfile SpacePositionx(1) = ... and in the next line SpacePositionx(2) = ...
+    READ(parameterLines, nml = Source15) ! Write in namelistfile SpacePositionx(1) = ... and in the next line SpacePositionx(2) = ...
                                                   ! and the same for SpacePositiony, SpacePositionz,...
   END SUBROUTINE
 
@@ -2699,7 +2711,7 @@ ALLOCATE( SpacePositionx(nDirac), &
                f(nRicker),               &  
                EqnNr(nRicker))   
  
-    READ(IO%UNIT%FileIn, nml = Source1618) ! Write in namelistfile SpacePositionx(1) = ... and in the next line SpacePositionx(2) = ...
+    READ(parameterLines, nml = Source1618) ! Write in namelistfile SpacePositionx(1) = ... and in the next line SpacePositionx(2) = ...
                                                   ! and the same for SpacePositiony, ... 
   END SUBROUTINE
 
@@ -2717,7 +2729,7 @@ ALLOCATE( SpacePositionx(nDirac), &
              l2(EQN%nVar), &
              T(EQN%nVar))
       
-    READ(IO%UNIT%FileIn, nml = Source17) ! Write in namelistfile U0(1) = ... and in the next line U0(2) = ...
+    READ(parameterLines, nml = Source17) ! Write in namelistfile U0(1) = ... and in the next line U0(2) = ...
                                                   ! and the same for l1, l2, ...
   END SUBROUTINE
 
@@ -2737,7 +2749,7 @@ ALLOCATE( SpacePositionx(nDirac), &
              Width(nPulseSource), &
              A0(nPulseSource))  
 
-    READ(IO%UNIT%FileIn, nml = Source19) ! Write in namelistfile EqnNr(1) = ... and in the next line EqnNr(2) = ...
+    READ(parameterLines, nml = Source19) ! Write in namelistfile EqnNr(1) = ... and in the next line EqnNr(2) = ...
                                                   ! and the same for Spacepositionx, ...
   END SUBROUTINE
   ! 
@@ -2777,7 +2789,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     !Setting default values
     enabled = 0
     !
-    READ (IO%UNIT%FileIn, nml = SpongeLayer) 
+    READ (parameterLines, nml = SpongeLayer) 
     SOURCE%Sponge%enabled = enabled                                               
     
     SELECT CASE(SOURCE%Sponge%enabled)                                       
@@ -2836,7 +2848,7 @@ ALLOCATE( SpacePositionx(nDirac), &
                 SpongePower(nDGSponge), &
                 SigmaMax(nDGSponge))
 
-    READ(IO%UNIT%FileIn, nml = Sponges) ! Write in namelistfile SpongeDelta(1) = ... and in the next line SpongeDelta(2) = ...
+    READ(parameterLines, nml = Sponges) ! Write in namelistfile SpongeDelta(1) = ... and in the next line SpongeDelta(2) = ...
                                                   ! and the same for SpongePower, ...
    END SUBROUTINE  
   !
@@ -2869,9 +2881,13 @@ ALLOCATE( SpacePositionx(nDirac), &
     REAL                             :: ScalingMatrixX(3), ScalingMatrixY(3), ScalingMatrixZ(3), &
                                         displacement(3) 
     CHARACTER(LEN=600)               :: MeshFile, meshgenerator
+    INTEGER                          :: cubeSize(3), cubePartitions(3), cubeBoundaries(6)
+    REAL                             :: cubeScale(3), cubeGrading, cubeMaterialLayer
     NAMELIST                         /MeshNml/ MeshFile, meshgenerator, periodic, &
                                             periodic_direction, displacement, ScalingMatrixX, &
-                                            ScalingMatrixY, ScalingMatrixZ
+                                            ScalingMatrixY, ScalingMatrixZ, &
+                                            cubeSize, cubePartitions, cubeScale, cubeGrading, &
+                                            cubeBoundaries, cubeMaterialLayer
     !------------------------------------------------------------------------                              
     !
     logInfo(*) '<--------------------------------------------------------->'
@@ -2895,8 +2911,22 @@ ALLOCATE( SpacePositionx(nDirac), &
     ScalingMatrixZ(3) = 1.0    
     periodic = 0
     periodic_direction(:) = 0
+    cubeSize(:) = 10
+    cubePartitions(:) = 0
+    cubeScale(:) = 1000.0
+    cubeGrading = 1.0
+    cubeBoundaries(:) = 5                                ! absorbing
+    cubeBoundaries(6) = 1                                ! free surface at the top
+    cubeMaterialLayer = 0.0
     !
-    READ(IO%UNIT%FileIn, nml = MeshNml)
+    READ(parameterLines, nml = MeshNml)
+
+    IO%cube%size = cubeSize
+    IO%cube%partitions = cubePartitions
+    IO%cube%scale = cubeScale
+    IO%cube%grading = cubeGrading
+    IO%cube%boundaries = cubeBoundaries
+    IO%cube%materialLayer = cubeMaterialLayer
 
     IO%MeshFile = MeshFile                               ! mesh input (mesh file name, no_file)
  
@@ -2954,6 +2984,12 @@ ALLOCATE( SpacePositionx(nDirac), &
             logInfo(*) 'Periodic boundary in z-direction. '
           ENDIF
 
+       CASE('CubeGenerator')
+          logInfo(*) 'Generate a cube mesh with ', cubeSize, ' hexahedra'
+          logInfo(*) 'Cube extent:', cubeScale, ', grading:', cubeGrading
+          BND%periodic = 0
+          BND%DirPeriodic(:) = .FALSE.
+
        CASE('ICEMCFD3D-Tetra')
           !
           logInfo(*) 'Read an ICEM CFD 3-D neutral mesh ... '
@@ -2994,7 +3030,8 @@ ALLOCATE( SpacePositionx(nDirac), &
        END SELECT
     ! specify element type (3-d = tetrahedrons)
 
-      IF(IO%meshgenerator.EQ.'Gambit3D-Tetra' .or. IO%meshgenerator.eq.'Gambit3D-fast' .or. IO%meshgenerator.eq.'Netcdf')THEN
+      IF(IO%meshgenerator.EQ.'Gambit3D-Tetra' .or. IO%meshgenerator.eq.'Gambit3D-fast' .or. IO%meshgenerator.eq.'Netcdf' &
+         .or. IO%meshgenerator.eq.'CubeGenerator')THEN
           MESH%GlobalElemType = 4
           MESH%GlobalSideType = 3  
           MESH%GlobalVrtxType = 4
@@ -3064,7 +3101,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     TYPE (tSource)             :: SOURCE
     TYPE (tInputOutput)        :: IO
     ! localVariables
-    INTEGER                    :: intDummy, stat, i
+    INTEGER                    :: intDummy, stat, i, iLine
     CHARACTER(LEN=5)           :: cInput
     CHARACTER(LEN=300)         :: cDummy
 
@@ -3103,7 +3140,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     Material = 1
     FixTimeStep = 5000
     !                                                              ! DGM :
-    READ(IO%UNIT%FileIn, nml = Discretization)
+    READ(parameterLines, nml = Discretization)
     DISC%Galerkin%DGFineOut1D = DGFineOut1D                        ! No. of red-refinements
     !                                                              ! for 2-D fine output
     IF(DISC%Galerkin%DGFineOut1D.GT.0) THEN
@@ -3120,6 +3157,8 @@ ALLOCATE( SpacePositionx(nDirac), &
       logError(*) 'TODO: Using clustered LTS with clustering provided file input'
     case(1)
       logInfo(*) 'Using GTS'
+    case(:-1)
+      logInfo(*) 'Using multi-rate clustered LTS with optimal rate up to:', -disc%galerkin%clusteredLts
     case default
       logInfo(*) 'Using multi-rate clustered LTS:', disc%galerkin%clusteredLts
     endselect
@@ -3202,8 +3241,10 @@ ALLOCATE( SpacePositionx(nDirac), &
            ENDIF
            
            IF(MESH%GlobalElemType.EQ.6) THEN
-                  READ(IO%UNIT%FileIn,*) DISC%Galerkin%nPolyMatOrig 
-                  READ(IO%UNIT%FileIn,*) DISC%Galerkin%nPolyMap
+                  ! The values follow the discretization namelist
+                  iLine = findNamelistEnd(parameterLines, findNamelist(parameterLines, 'Discretization', 1)) + 1
+                  READ(parameterLines(iLine),*) DISC%Galerkin%nPolyMatOrig 
+                  READ(parameterLines(iLine+1),*) DISC%Galerkin%nPolyMap
                   DISC%Galerkin%nPolyMat  = DISC%Galerkin%nPolyMatOrig + DISC%Galerkin%nPolyMap
                   DISC%Galerkin%nDegFrMat = (DISC%Galerkin%nPolyMat+1)*(DISC%Galerkin%nPolyMat+2)*(DISC%Galerkin%nPolyMat+3)/6
                     IF(DISC%Galerkin%nPolyMat.GT.DISC%Galerkin%nPoly) THEN
@@ -3247,15 +3288,21 @@ ALLOCATE( SpacePositionx(nDirac), &
       !------------------------------------------------------------------------
       INTEGER                          :: Rotation, Format, printIntervalCriterion, &
                                           pickDtType, nRecordPoint, PGMFlag, FaultOutputFlag, &
-                                          iOutputMaskMaterial(1:3), nRecordPoints
-      REAL                             :: TimeInterval, pickdt, Interval, checkPointInterval
+                                          iOutputMaskMaterial(1:3), nRecordPoints, Refinement, OutputRegion, &
+                                          SurfaceOutput, CompressionMode
+      REAL                             :: TimeInterval, pickdt, Interval, checkPointInterval, &
+                                          checkPointMTBF, OutputRegionBounds(6), SurfaceOutputInterval, &
+                                          CompressionTolerance(9)
       CHARACTER(LEN=600)               :: OutputFile, RFileName, PGMFile, checkPointFile
       character(LEN=64)                :: checkPointBackend
       NAMELIST                         /Output/ OutputFile, Rotation, iOutputMask, iOutputMaskMaterial, &
                                                 Format, Interval, TimeInterval, printIntervalCriterion, &
                                                 pickdt, pickDtType, RFileName, PGMFlag, &
                                                 PGMFile, FaultOutputFlag, nRecordPoints, &
-                                                checkPointInterval, checkPointFile, checkPointBackend
+                                                checkPointInterval, checkPointFile, checkPointBackend, &
+                                                checkPointMTBF, Refinement, OutputRegion, OutputRegionBounds, &
+                                                SurfaceOutput, SurfaceOutputInterval, &
+                                                CompressionMode, CompressionTolerance
     !------------------------------------------------------------------------  
     !                                                                       
       logInfo(*) '<--------------------------------------------------------->'        
@@ -3267,6 +3314,13 @@ ALLOCATE( SpacePositionx(nDirac), &
       iOutputMaskMaterial(:) =  0
       Rotation = 0
       Format = 1
+      Refinement = 0
+      OutputRegion = 0
+      OutputRegionBounds(:) = 0.0
+      CompressionMode = 0
+      CompressionTolerance(:) = 0.0
+      SurfaceOutput = 0
+      SurfaceOutputInterval = 0.0
       pickdt = 0.1
       pickDtType = 1
       nRecordPoints = 0
@@ -3275,9 +3329,10 @@ ALLOCATE( SpacePositionx(nDirac), &
       PGMFlag = 0
       FaultOutputFlag = 0
       checkPointInterval = 0
+      checkPointMTBF = 0
       checkPointBackend = 'none'
       !
-      READ(IO%UNIT%FileIn, nml = Output)                                                            
+      READ(parameterLines, nml = Output)                                                            
       IO%OutputFile = OutputFile                                                   ! read output field file
                                                                                              
       IO%OutputFile  = TRIM(IO%OutputFile)
@@ -3392,6 +3447,64 @@ ALLOCATE( SpacePositionx(nDirac), &
          STOP
       END SELECT
 
+      IO%Refinement = Refinement
+      SELECT CASE(IO%Refinement)
+      CASE(0)
+      CASE(1)
+         logInfo0(*) 'Refining the XDMF output into 8 subtetrahedra per element'
+      CASE DEFAULT
+         logError(*) 'Refinement must be {0,1}'
+         STOP
+      END SELECT
+
+      IO%OutputRegion = OutputRegion
+      IO%OutputRegionBounds(:) = OutputRegionBounds(:)
+      SELECT CASE(IO%OutputRegion)
+      CASE(0)
+      CASE(1)
+         logInfo0(*) 'XDMF output is restricted to the box', IO%OutputRegionBounds(:)
+      CASE(2)
+         logInfo0(*) 'XDMF output is restricted to cells at the free surface'
+      CASE DEFAULT
+         logError(*) 'OutputRegion must be {0,1,2}'
+         STOP
+      END SELECT
+
+      IO%CompressionMode = CompressionMode
+      IO%CompressionTolerance(:) = CompressionTolerance(:)
+      SELECT CASE(IO%CompressionMode)
+      CASE(0)
+      CASE(1)
+         logInfo0(*) 'XDMF output is compressed with the absolute error bounds', IO%CompressionTolerance(:)
+      CASE(2)
+         logInfo0(*) 'XDMF output is compressed with the relative error bounds', IO%CompressionTolerance(:)
+      CASE DEFAULT
+         logError(*) 'CompressionMode must be {0,1,2}'
+         STOP
+      END SELECT
+      IF (ANY(IO%CompressionTolerance(:).LT.0.0)) THEN
+         logError(*) 'CompressionTolerance must not be negative'
+         STOP
+      ENDIF
+
+      IO%SurfaceOutput = SurfaceOutput
+      IO%SurfaceOutputInterval = SurfaceOutputInterval
+      IF (IO%SurfaceOutput .EQ. 1) THEN
+#if defined(GENERATEDKERNELS) && defined(USE_HDF)
+         IF (IO%SurfaceOutputInterval .LE. 0.0) THEN
+            logError(*) 'SurfaceOutputInterval must be positive'
+            STOP
+         ENDIF
+         logInfo0(*) 'Free surface velocities are written every', IO%SurfaceOutputInterval, 's'
+#else
+         logError(*) 'This version does not support free surface output'
+         STOP
+#endif
+      ELSEIF (IO%SurfaceOutput .NE. 0) THEN
+         logError(*) 'SurfaceOutput must be {0,1}'
+         STOP
+      ENDIF
+
       IO%TitleMask( 1) = TRIM(' "x"')
       IO%TitleMask( 2) = TRIM(' "y"')
       IF(EQN%EQType.EQ.8) THEN
@@ -3653,7 +3766,12 @@ ALLOCATE( SpacePositionx(nDirac), &
         logError(*) 'The interval for checkpoints cannot be negative'
         stop
       endif
+      if (checkPointMTBF .lt. 0) then
+        logError(*) 'The mean time between failures for checkpoints cannot be negative'
+        stop
+      endif
       io%checkpoint%interval = checkPointInterval
+      io%checkpoint%mtbf = checkPointMTBF
       io%checkpoint%filename = checkPointFile
       io%checkpoint%backend = checkPointBackend
 
@@ -3667,6 +3785,8 @@ ALLOCATE( SpacePositionx(nDirac), &
       select case (io%checkpoint%backend)
         case ("posix")
             logInfo(*) 'Using POSIX checkpoint backend'
+        case ("posix_async")
+            logInfo(*) 'Using async POSIX checkpoint backend'
         case ("hdf5")
 #ifndef USE_HDF
             logError(*) 'This version does not support HDF5 checkpoints'
@@ -3728,7 +3848,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     WallTime_h = 1e20
     Delay_h = 0.
                                                 
-   READ(IO%UNIT%FileIn, nml = AbortCriteria)  
+   READ(parameterLines, nml = AbortCriteria)  
 
     DISC%EndTime =  EndTime                                         ! time required
                                                                      
@@ -3781,7 +3901,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     !Setting default values
     typ = 0                                                                   !Read which variables are to be analyzed
     
-   READ(IO%UNIT%FileIn, nml = Analysis)
+   READ(parameterLines, nml = Analysis)
     ANALYSE%typ = typ
     
    ANALYSE%AnalyseDataPerIteration = .FALSE.
@@ -3894,7 +4014,7 @@ ALLOCATE( SpacePositionx(nDirac), &
        ALLOCATE(varfield(setvar), &
                 ampfield(setvar))
 
-    READ(IO%UNIT%FileIn, nml = AnalysisFields) ! Write in namelistfile varfield(1) = ... and in the next line varfield(2) = ...
+    READ(parameterLines, nml = AnalysisFields) ! Write in namelistfile varfield(1) = ... and in the next line varfield(2) = ...
                                                   ! and the same for ampfield, ...
    END SUBROUTINE  
   !
@@ -3923,7 +4043,7 @@ ALLOCATE( SpacePositionx(nDirac), &
     ! Setting default values
     debug_flag = 0                                                                       
     level = 0
-    READ(IO%UNIT%FileIn, nml = Debugging)
+    READ(parameterLines, nml = Debugging)
     DEBUG%enabled = debug_flag                                 
     !                                                                            
     IF (DEBUG%enabled .ne. 0) THEN                                           
@@ -0,0 +1,564 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * XDMF writer with lossy, error-bounded compression
+ */
+
+#ifndef COMPRESSED_XDMF_WRITER_H
+#define COMPRESSED_XDMF_WRITER_H
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif // USE_MPI
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/logger.h"
+#include "utils/path.h"
+
+namespace seissol
+{
+
+/**
+ * Writes tetrahedral cell data as single precision with an absolute or
+ * relative error bound to chunked HDF5 datasets with shuffle and deflate
+ * filters.
+ *
+ * Each rank of the communicator writes its own HDF5 file (filters are not
+ * available for parallel writes). The XDMF file contains a spatial collection
+ * of all parts. Use it with the output aggregation to limit the number of files.
+ */
+class CompressedXdmfWriter
+{
+public:
+	enum Mode
+	{
+		/** Single precision only */
+		NONE = 0,
+		/** Quantization with an absolute error bound */
+		ABSOLUTE = 1,
+		/** Mantissa truncation with a relative error bound */
+		RELATIVE = 2
+	};
+
+private:
+	/** The rank of the process */
+	const int m_rank;
+
+	/** The output prefix for the filename */
+	const std::string m_outputPrefix;
+
+	/** Names of the variables */
+	std::vector<std::string> m_variableNames;
+
+	/** The current time step */
+	unsigned int m_timestep;
+
+#ifdef USE_MPI
+	/** Communicator of all parts */
+	MPI_Comm m_comm;
+#endif // USE_MPI
+
+	/** Part of this rank */
+	int m_part;
+
+	/** Number of parts */
+	int m_numParts;
+
+	/** Number of cells of each part (part 0 only) */
+	std::vector<unsigned long> m_partCells;
+
+	/** Number of vertices of each part (part 0 only) */
+	std::vector<unsigned long> m_partVertices;
+
+	/** The times of all time steps (part 0 only) */
+	std::vector<double> m_times;
+
+	/** Number of local cells */
+	unsigned long m_nCells;
+
+	/** The compression mode */
+	Mode m_mode;
+
+	/** The tolerance for each variable */
+	std::vector<double> m_tolerances;
+
+	/** The HDF5 file */
+	hid_t m_h5file;
+
+	/** The time data set */
+	hid_t m_h5time;
+
+	/** The data set of each variable */
+	std::vector<hid_t> m_h5variables;
+
+	/** Buffer for the compressed data */
+	std::vector<float> m_buffer;
+
+	/** True if the compression should not start OpenMP threads */
+	bool m_serial;
+
+	/** Position of the XDMF footer, new time steps are inserted here (-1 if the file was not written yet) */
+	std::streamoff m_xdmfFooter;
+
+public:
+	/**
+	 * @param timestep The first time step (larger than 0 to append to existing files)
+	 */
+	CompressedXdmfWriter(int rank, const char* outputPrefix,
+			const std::vector<const char*> &variableNames,
+			unsigned int timestep = 0)
+		: m_rank(rank), m_outputPrefix(outputPrefix),
+		  m_variableNames(variableNames.begin(), variableNames.end()),
+		  m_timestep(timestep),
+		  m_part(0), m_numParts(1),
+		  m_nCells(0),
+		  m_mode(NONE), m_tolerances(variableNames.size(), 0.),
+		  m_h5file(-1), m_h5time(-1),
+		  m_serial(false),
+		  m_xdmfFooter(-1)
+	{
+#ifdef USE_MPI
+		m_comm = MPI_COMM_WORLD;
+#endif // USE_MPI
+	}
+
+	virtual ~CompressedXdmfWriter()
+	{
+		close();
+	}
+
+#ifdef USE_MPI
+	/**
+	 * Sets the communicator of all parts (must be called before init)
+	 */
+	void setComm(MPI_Comm comm)
+	{
+		m_comm = comm;
+	}
+#endif // USE_MPI
+
+	/**
+	 * Compress the data with a single thread, e.g. if the writer is called
+	 * from an I/O thread that should not start an OpenMP team
+	 */
+	void setSerial(bool serial)
+	{
+		m_serial = serial;
+	}
+
+	/**
+	 * Sets the compression
+	 *
+	 * @param tolerances The absolute or relative error bound for each variable.
+	 *  Use 0 to store the variable with full single precision.
+	 */
+	void setCompression(Mode mode, const std::vector<double> &tolerances)
+	{
+		m_mode = mode;
+		m_tolerances = tolerances;
+		m_tolerances.resize(m_variableNames.size(), 0.);
+	}
+
+	void init(unsigned int nCells, const unsigned int* cells,
+			unsigned int nVertices, const double* vertices)
+	{
+#ifdef USE_MPI
+		MPI_Comm_rank(m_comm, &m_part);
+		MPI_Comm_size(m_comm, &m_numParts);
+#endif // USE_MPI
+
+		m_nCells = nCells;
+		m_buffer.resize(nCells);
+
+		if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0 || H5Zfilter_avail(H5Z_FILTER_SHUFFLE) <= 0)
+			logError() << "HDF5 does not support the deflate or shuffle filter";
+
+		// Collect the size of all parts for the XDMF file
+		unsigned long localSize[2] = {nCells, nVertices};
+		std::vector<unsigned long> sizes(m_numParts*2);
+#ifdef USE_MPI
+		MPI_Gather(localSize, 2, MPI_UNSIGNED_LONG, &sizes[0], 2, MPI_UNSIGNED_LONG, 0, m_comm);
+#else // USE_MPI
+		sizes[0] = localSize[0];
+		sizes[1] = localSize[1];
+#endif // USE_MPI
+		if (m_part == 0) {
+			m_partCells.resize(m_numParts);
+			m_partVertices.resize(m_numParts);
+			for (int i = 0; i < m_numParts; i++) {
+				m_partCells[i] = sizes[i*2];
+				m_partVertices[i] = sizes[i*2+1];
+			}
+		}
+
+		m_h5variables.resize(m_variableNames.size());
+
+		if (m_timestep == 0) {
+			m_h5file = H5Fcreate(dataFile(m_part).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+			checkH5Err(m_h5file);
+
+			// Mesh
+			hsize_t connectDims[2] = {nCells, 4};
+			writeDataset("connect", H5T_NATIVE_UINT, H5T_STD_U32LE, connectDims, cells);
+			hsize_t geometryDims[2] = {nVertices, 3};
+			writeDataset("geometry", H5T_NATIVE_DOUBLE, H5T_IEEE_F64LE, geometryDims, vertices);
+
+			// Time
+			hsize_t timeDims[1] = {0};
+			hsize_t timeMaxDims[1] = {H5S_UNLIMITED};
+			hsize_t timeChunk[1] = {1024};
+			hid_t h5space = H5Screate_simple(1, timeDims, timeMaxDims);
+			checkH5Err(h5space);
+			hid_t h5plist = H5Pcreate(H5P_DATASET_CREATE);
+			checkH5Err(h5plist);
+			checkH5Err(H5Pset_chunk(h5plist, 1, timeChunk));
+			m_h5time = H5Dcreate(m_h5file, "time", H5T_IEEE_F64LE, h5space,
+					H5P_DEFAULT, h5plist, H5P_DEFAULT);
+			checkH5Err(m_h5time);
+			checkH5Err(H5Pclose(h5plist));
+			checkH5Err(H5Sclose(h5space));
+
+			// Variables (time step x cells)
+			hsize_t dims[2] = {0, nCells};
+			hsize_t maxDims[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
+			// Limit the chunk size to 1 MiB
+			hsize_t chunk[2] = {1, std::max(1ul, std::min(m_nCells, 1ul << 18))};
+			h5space = H5Screate_simple(2, dims, maxDims);
+			checkH5Err(h5space);
+			h5plist = H5Pcreate(H5P_DATASET_CREATE);
+			checkH5Err(h5plist);
+			checkH5Err(H5Pset_chunk(h5plist, 2, chunk));
+			checkH5Err(H5Pset_shuffle(h5plist));
+			checkH5Err(H5Pset_deflate(h5plist, 4));
+			for (unsigned int i = 0; i < m_variableNames.size(); i++) {
+				m_h5variables[i] = H5Dcreate(m_h5file, m_variableNames[i].c_str(), H5T_IEEE_F32LE, h5space,
+						H5P_DEFAULT, h5plist, H5P_DEFAULT);
+				checkH5Err(m_h5variables[i]);
+			}
+			checkH5Err(H5Pclose(h5plist));
+			checkH5Err(H5Sclose(h5space));
+		} else {
+			// Append to the existing files
+			m_h5file = H5Fopen(dataFile(m_part).c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+			checkH5Err(m_h5file);
+
+			m_h5time = H5Dopen(m_h5file, "time", H5P_DEFAULT);
+			checkH5Err(m_h5time);
+			for (unsigned int i = 0; i < m_variableNames.size(); i++) {
+				m_h5variables[i] = H5Dopen(m_h5file, m_variableNames[i].c_str(), H5P_DEFAULT);
+				checkH5Err(m_h5variables[i]);
+			}
+
+			// Drop time steps written after the checkpoint
+			hsize_t timeDims[1] = {m_timestep};
+			checkH5Err(H5Dset_extent(m_h5time, timeDims));
+			hsize_t dims[2] = {m_timestep, m_nCells};
+			for (unsigned int i = 0; i < m_variableNames.size(); i++)
+				checkH5Err(H5Dset_extent(m_h5variables[i], dims));
+
+			if (m_part == 0) {
+				m_times.resize(m_timestep);
+				checkH5Err(H5Dread(m_h5time, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &m_times[0]));
+			}
+		}
+	}
+
+	/**
+	 * @return The current time step
+	 */
+	unsigned int timestep() const
+	{
+		return m_timestep;
+	}
+
+	void addTimeStep(double time)
+	{
+		if (m_part == 0)
+			m_times.push_back(time);
+
+		hsize_t timeDims[1] = {m_timestep+1};
+		checkH5Err(H5Dset_extent(m_h5time, timeDims));
+		hsize_t start[1] = {m_timestep};
+		hsize_t count[1] = {1};
+		writeSlab(m_h5time, 1, start, count, H5T_NATIVE_DOUBLE, &time);
+
+		hsize_t dims[2] = {m_timestep+1, m_nCells};
+		for (unsigned int i = 0; i < m_variableNames.size(); i++)
+			checkH5Err(H5Dset_extent(m_h5variables[i], dims));
+	}
+
+	void writeData(unsigned int id, const double* data)
+	{
+		compress(data, m_tolerances[id], &m_buffer[0]);
+
+		hsize_t start[2] = {m_timestep, 0};
+		hsize_t count[2] = {1, m_nCells};
+		writeSlab(m_h5variables[id], 2, start, count, H5T_NATIVE_FLOAT, &m_buffer[0]);
+	}
+
+	void flush()
+	{
+		m_timestep++;
+
+		checkH5Err(H5Fflush(m_h5file, H5F_SCOPE_LOCAL));
+
+		if (m_part == 0) {
+			if (m_xdmfFooter < 0)
+				writeXdmf();
+			else
+				appendXdmf();
+		}
+	}
+
+	void close()
+	{
+		if (m_h5file < 0)
+			return;
+
+		for (unsigned int i = 0; i < m_h5variables.size(); i++)
+			checkH5Err(H5Dclose(m_h5variables[i]));
+		checkH5Err(H5Dclose(m_h5time));
+		checkH5Err(H5Fclose(m_h5file));
+		m_h5file = -1;
+	}
+
+private:
+	/**
+	 * Converts the data to single precision with the error bound of the variable
+	 */
+	void compress(const double* data, double tolerance, float* out) const
+	{
+		if (m_mode == NONE || tolerance <= 0) {
+#ifdef _OPENMP
+			#pragma omp parallel for schedule(static) if(!m_serial)
+#endif // _OPENMP
+			for (unsigned long i = 0; i < m_nCells; i++)
+				out[i] = data[i];
+			return;
+		}
+
+		if (m_mode == ABSOLUTE) {
+			// Power of 2 step: the quantized values are exact in single precision
+			// as long as they are smaller than 2^24 steps. Larger values are stored
+			// without quantization.
+			const double step = std::pow(2., std::floor(std::log(2*tolerance) / std::log(2.)));
+			const double invStep = 1. / step;
+			const double maxSteps = 1 << 24;
+
+#ifdef _OPENMP
+			#pragma omp parallel for schedule(static) if(!m_serial)
+#endif // _OPENMP
+			for (unsigned long i = 0; i < m_nCells; i++) {
+				const double steps = std::floor(data[i] * invStep + 0.5);
+				if (std::abs(steps) < maxSteps)
+					out[i] = steps * step;
+				else
+					out[i] = data[i];
+			}
+		} else {
+			// Number of mantissa bits required for the relative error
+			const int bits = std::min(23, static_cast<int>(std::ceil(-std::log(tolerance) / std::log(2.))));
+			const unsigned int drop = 23 - std::max(0, bits);
+			if (drop == 0) {
+				compress(data, 0, out);
+				return;
+			}
+			const unsigned int half = 1u << (drop-1);
+			const unsigned int mask = ~((1u << drop) - 1);
+
+#ifdef _OPENMP
+			#pragma omp parallel for schedule(static) if(!m_serial)
+#endif // _OPENMP
+			for (unsigned long i = 0; i < m_nCells; i++) {
+				float value = data[i];
+				unsigned int raw;
+				memcpy(&raw, &value, sizeof(float));
+				raw = (raw + half) & mask;
+				memcpy(&out[i], &raw, sizeof(float));
+			}
+		}
+	}
+
+	/**
+	 * @return The name of the HDF5 file of a part
+	 */
+	std::string dataFile(int part) const
+	{
+		std::ostringstream name;
+		name << m_outputPrefix << "_" << part << ".h5";
+		return name.str();
+	}
+
+	void writeDataset(const char* name, hid_t memType, hid_t fileType,
+			const hsize_t dims[2], const void* data)
+	{
+		hid_t h5space = H5Screate_simple(2, dims, 0L);
+		checkH5Err(h5space);
+		hid_t h5data = H5Dcreate(m_h5file, name, fileType, h5space,
+				H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+		checkH5Err(h5data);
+		if (dims[0] > 0)
+			checkH5Err(H5Dwrite(h5data, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data));
+		checkH5Err(H5Dclose(h5data));
+		checkH5Err(H5Sclose(h5space));
+	}
+
+	static void writeSlab(hid_t h5data, int rank, const hsize_t* start, const hsize_t* count,
+			hid_t memType, const void* data)
+	{
+		for (int i = 0; i < rank; i++) {
+			if (count[i] == 0)
+				return;
+		}
+
+		hid_t h5space = H5Dget_space(h5data);
+		checkH5Err(h5space);
+		checkH5Err(H5Sselect_hyperslab(h5space, H5S_SELECT_SET, start, 0L, count, 0L));
+		hid_t h5memSpace = H5Screate_simple(rank, count, 0L);
+		checkH5Err(h5memSpace);
+		checkH5Err(H5Dwrite(h5data, memType, h5memSpace, h5space, H5P_DEFAULT, data));
+		checkH5Err(H5Sclose(h5memSpace));
+		checkH5Err(H5Sclose(h5space));
+	}
+
+	/**
+	 * Writes the XDMF file for all time steps
+	 */
+	void writeXdmf()
+	{
+		std::string xdmfFile = m_outputPrefix + ".xdmf";
+		std::string tmpFile = xdmfFile + ".tmp";
+
+		std::ofstream xdmf(tmpFile.c_str());
+		xdmf << "<?xml version=\"1.0\" ?>" << std::endl
+			<< "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>" << std::endl
+			<< "<Xdmf Version=\"2.0\">" << std::endl
+			<< " <Domain>" << std::endl
+			<< "  <Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">" << std::endl;
+
+		for (unsigned int i = 0; i < m_times.size(); i++)
+			writeXdmfStep(xdmf, i);
+
+		m_xdmfFooter = xdmf.tellp();
+		writeXdmfFooter(xdmf);
+		xdmf.close();
+
+		if (rename(tmpFile.c_str(), xdmfFile.c_str()) != 0)
+			logWarning(m_rank) << "Could not update the XDMF file" << xdmfFile;
+	}
+
+	/**
+	 * Adds the last time step to the XDMF file
+	 */
+	void appendXdmf()
+	{
+		std::string xdmfFile = m_outputPrefix + ".xdmf";
+
+		std::fstream xdmf(xdmfFile.c_str(), std::ios::in | std::ios::out);
+		if (!xdmf) {
+			logWarning(m_rank) << "Could not update the XDMF file" << xdmfFile;
+			return;
+		}
+
+		xdmf.seekp(m_xdmfFooter);
+		writeXdmfStep(xdmf, m_times.size()-1);
+		m_xdmfFooter = xdmf.tellp();
+		writeXdmfFooter(xdmf);
+	}
+
+	void writeXdmfStep(std::ostream &xdmf, unsigned int step) const
+	{
+		xdmf << "   <Grid Name=\"step_" << step << "\" GridType=\"Collection\" CollectionType=\"Spatial\">" << std::endl
+			<< "    <Time Value=\"" << m_times[step] << "\"/>" << std::endl;
+
+		for (int j = 0; j < m_numParts; j++) {
+			const std::string file = utils::Path(dataFile(j)).basename();
+
+			xdmf << "    <Grid Name=\"part_" << j << "\" GridType=\"Uniform\">" << std::endl
+				<< "     <Topology TopologyType=\"Tetrahedron\" NumberOfElements=\"" << m_partCells[j] << "\">" << std::endl
+				<< "      <DataItem NumberType=\"UInt\" Precision=\"4\" Format=\"HDF\" Dimensions=\""
+				<< m_partCells[j] << " 4\">" << file << ":/connect</DataItem>" << std::endl
+				<< "     </Topology>" << std::endl
+				<< "     <Geometry GeometryType=\"XYZ\">" << std::endl
+				<< "      <DataItem NumberType=\"Float\" Precision=\"8\" Format=\"HDF\" Dimensions=\""
+				<< m_partVertices[j] << " 3\">" << file << ":/geometry</DataItem>" << std::endl
+				<< "     </Geometry>" << std::endl;
+
+			// The data set has (at least) step+1 time steps when this step is written
+			for (unsigned int k = 0; k < m_variableNames.size(); k++) {
+				xdmf << "     <Attribute Name=\"" << m_variableNames[k] << "\" Center=\"Cell\">" << std::endl
+					<< "      <DataItem ItemType=\"HyperSlab\" Dimensions=\"" << m_partCells[j] << "\">" << std::endl
+					<< "       <DataItem NumberType=\"UInt\" Precision=\"4\" Format=\"XML\" Dimensions=\"3 2\">"
+					<< step << " 0 1 1 1 " << m_partCells[j] << "</DataItem>" << std::endl
+					<< "       <DataItem NumberType=\"Float\" Precision=\"4\" Format=\"HDF\" Dimensions=\""
+					<< (step+1) << ' ' << m_partCells[j] << "\">" << file << ":/" << m_variableNames[k] << "</DataItem>" << std::endl
+					<< "      </DataItem>" << std::endl
+					<< "     </Attribute>" << std::endl;
+			}
+
+			xdmf << "    </Grid>" << std::endl;
+		}
+
+		xdmf << "   </Grid>" << std::endl;
+	}
+
+	static void writeXdmfFooter(std::ostream &xdmf)
+	{
+		xdmf << "  </Grid>" << std::endl
+			<< " </Domain>" << std::endl
+			<< "</Xdmf>" << std::endl;
+	}
+
+	template<typename T>
+	static void checkH5Err(T status)
+	{
+		if (status < 0)
+			logError() << "An error in the compressed XDMF writer occurred";
+	}
+};
+
+}
+
+#endif // COMPRESSED_XDMF_WRITER_H
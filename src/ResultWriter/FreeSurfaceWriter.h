@@ -0,0 +1,276 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Writes the velocities at the free surface with a separate (high) output rate
+ */
+
+#ifndef FREE_SURFACE_WRITER_H
+#define FREE_SURFACE_WRITER_H
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif // USE_MPI
+
+#include <string>
+#include <vector>
+
+#include "utils/logger.h"
+
+#include "xdmfwriter/XdmfWriter.h"
+
+#include "Geometry/MeshGeometry.h"
+#include "Geometry/MeshTools.h"
+#include "Numerical_aux/BasisFunction.h"
+
+namespace seissol
+{
+
+/**
+ * Builds a triangle mesh from all free surface faces and writes the
+ * velocities evaluated at the barycenter of the faces.
+ */
+class FreeSurfaceWriter
+{
+private:
+	/** True if free surface output is enabled */
+	bool m_enabled;
+
+	/** The rank of the process */
+	int m_rank;
+
+	/** The output prefix for the filename */
+	std::string m_outputPrefix;
+
+	/** The XMDF Writer used for the free surface */
+	xdmfwriter::XdmfWriter<xdmfwriter::TRIANGLE>* m_xdmfWriter;
+
+	/** Total number of variables in the DOFs */
+	unsigned int m_numVariables;
+
+	/** Number of basis functions in the DOFs (including padding) */
+	unsigned int m_numBasisFunctions;
+
+	/** Number of basis functions of the polynomial */
+	unsigned int m_numPolyBasisFunctions;
+
+	/** Pointer to the degrees of freedom */
+	const double* m_dofs;
+
+	/** DOF index of the cell for each free surface face */
+	std::vector<unsigned int> m_faceCells;
+
+	/** Local side of the cell for each free surface face */
+	std::vector<unsigned int> m_faceSides;
+
+	/** Values of the basis functions at the barycenters of the 4 faces [4][basis] */
+	std::vector<double> m_basisValues;
+
+	/** Buffer for the output data */
+	double* m_outputBuffer;
+
+	/** The velocities in the DOFs */
+	static const unsigned int FIRST_VELOCITY = 6;
+
+	/** Number of variables in the output (u, v, w) */
+	static const unsigned int NUM_OUTPUT_VARIABLES = 3;
+
+public:
+	FreeSurfaceWriter()
+		: m_enabled(false), m_rank(0),
+		  m_xdmfWriter(0L),
+		  m_numVariables(0), m_numBasisFunctions(0), m_numPolyBasisFunctions(0),
+		  m_dofs(0L),
+		  m_outputBuffer(0L)
+	{
+	}
+
+	/**
+	 * Activate the free surface output
+	 */
+	void enable()
+	{
+		m_enabled = true;
+	}
+
+	/**
+	 * @return True if free surface output is enabled, false otherwise
+	 */
+	bool isEnabled() const
+	{
+		return m_enabled;
+	}
+
+	/**
+	 * Set the output prefix for the filename
+	 */
+	void setFilename(const char* outputPrefix)
+	{
+		m_outputPrefix = outputPrefix;
+	}
+
+	/**
+	 * Initialize the free surface output
+	 *
+	 * @param map The mapping from the cell order to dofs order
+	 * @param timestep The first time step (larger than 0 to append to an existing file)
+	 */
+	void init(int numVars, int numBasisFuncs,
+			const MeshGeometry &geometry,
+			const double* dofs, const unsigned int* map,
+			int timestep)
+	{
+		if (!m_enabled)
+			return;
+
+#ifdef USE_MPI
+		MPI_Comm_rank(MPI_COMM_WORLD, &m_rank);
+#endif // USE_MPI
+
+		logInfo(m_rank) << "Initializing free surface output.";
+
+		if (m_xdmfWriter != 0L)
+			logError() << "Free surface writer already initialized";
+
+		if (numVars < static_cast<int>(FIRST_VELOCITY + NUM_OUTPUT_VARIABLES))
+			logError() << "Free surface output requires the velocities";
+
+		m_numVariables = numVars;
+		m_numBasisFunctions = numBasisFuncs;
+		m_numPolyBasisFunctions = basisFunction::getNumberOfPolynomialBasisFunctions(numBasisFuncs);
+		m_dofs = dofs;
+
+		// Collect the free surface faces and their vertices
+		std::vector<int> vertexIds(geometry.nVertices(), -1);
+		std::vector<double> surfaceVertices;
+		std::vector<unsigned int> triangles;
+
+		for (unsigned int i = 0; i < geometry.nElements(); i++) {
+			for (unsigned int j = 0; j < 4; j++) {
+				if (!geometry.isFreeSurface(i, j))
+					continue;
+
+				for (unsigned int k = 0; k < 3; k++) {
+					const int vertex = geometry.cell(i)[MeshTools::FACE2NODES[j][k]];
+					if (vertexIds[vertex] < 0) {
+						vertexIds[vertex] = surfaceVertices.size() / 3;
+						VrtxCoords coords;
+						geometry.vertex(vertex, coords);
+						surfaceVertices.insert(surfaceVertices.end(), coords, coords+3);
+					}
+					triangles.push_back(vertexIds[vertex]);
+				}
+
+				m_faceCells.push_back(map[i]);
+				m_faceSides.push_back(j);
+			}
+		}
+
+		// Basis functions at the barycenters of the faces
+		static const double FACE_CENTERS[4][3] = {
+			{1./3., 1./3., 0}, {1./3., 0, 1./3.}, {0, 1./3., 1./3.}, {1./3., 1./3., 1./3.}
+		};
+		m_basisValues.assign(4 * m_numBasisFunctions, 0.);
+		for (unsigned int i = 0; i < 4; i++)
+			basisFunction::evaluateTetra(FACE_CENTERS[i], m_numPolyBasisFunctions,
+					&m_basisValues[i * m_numBasisFunctions]);
+
+		std::vector<const char*> variables(NUM_OUTPUT_VARIABLES);
+		variables[0] = "u";
+		variables[1] = "v";
+		variables[2] = "w";
+
+		m_xdmfWriter = new xdmfwriter::XdmfWriter<xdmfwriter::TRIANGLE>(
+				m_rank, m_outputPrefix.c_str(), variables, timestep);
+		m_xdmfWriter->init(m_faceCells.size(), (triangles.empty() ? 0L : &triangles[0]),
+				surfaceVertices.size() / 3, (surfaceVertices.empty() ? 0L : &surfaceVertices[0]), true);
+
+		m_outputBuffer = new double[m_faceCells.size() * NUM_OUTPUT_VARIABLES];
+
+		logInfo(m_rank) << "Initializing free surface output. Done.";
+	}
+
+	/**
+	 * Write a time step
+	 */
+	void write(double time)
+	{
+		EPIK_TRACER("FreeSurfaceWriter_write");
+		SCOREP_USER_REGION("FreeSurfaceWriter_write", SCOREP_USER_REGION_TYPE_FUNCTION);
+
+		if (!m_enabled)
+			return;
+
+		const unsigned int nFaces = m_faceCells.size();
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+#endif // _OPENMP
+		for (unsigned int i = 0; i < nFaces; i++) {
+			const double* basis = &m_basisValues[m_faceSides[i] * m_numBasisFunctions];
+
+			for (unsigned int j = 0; j < NUM_OUTPUT_VARIABLES; j++) {
+				const double* dofs = &m_dofs[(m_faceCells[i] * m_numVariables + FIRST_VELOCITY + j) * m_numBasisFunctions];
+
+				double value = 0;
+				for (unsigned int k = 0; k < m_numPolyBasisFunctions; k++)
+					value += basis[k] * dofs[k];
+				m_outputBuffer[j*nFaces + i] = value;
+			}
+		}
+
+		m_xdmfWriter->addTimeStep(time);
+		for (unsigned int i = 0; i < NUM_OUTPUT_VARIABLES; i++)
+			m_xdmfWriter->writeData(i, &m_outputBuffer[i*nFaces]);
+		m_xdmfWriter->flush();
+	}
+
+	/**
+	 * Close the free surface output
+	 */
+	void close()
+	{
+		if (!m_enabled)
+			return;
+
+		delete m_xdmfWriter;
+		m_xdmfWriter = 0L;
+		delete [] m_outputBuffer;
+		m_outputBuffer = 0L;
+	}
+};
+
+}
+
+#endif // FREE_SURFACE_WRITER_H
@@ -0,0 +1,365 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Forwards wave field output from compute ranks to aggregating writer ranks
+ **/
+
+#ifndef OUTPUT_AGGREGATOR_H
+#define OUTPUT_AGGREGATOR_H
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif // USE_MPI
+
+#include <vector>
+
+#include "utils/env.h"
+#include "utils/logger.h"
+
+namespace seissol
+{
+
+/**
+ * Groups ranks for the wave field output. Only the first rank of each group
+ * writes files, the other ranks forward their data with nonblocking sends.
+ *
+ * This is an aggregation on the compute ranks, not a set of dedicated I/O
+ * servers: the writer ranks take part in the simulation as well. Fault
+ * output and checkpoints are not forwarded and are still written by all ranks.
+ *
+ * The group size is set with SEISSOL_OUTPUT_AGGREGATION:
+ * 0 or 1 disables the aggregation, -1 creates one group per shared memory node.
+ */
+class OutputAggregator
+{
+private:
+	/** True if the output is aggregated */
+	bool m_enabled;
+
+#ifdef USE_MPI
+	/** Communicator of the group */
+	MPI_Comm m_groupComm;
+
+	/** Communicator of all writer ranks (MPI_COMM_NULL on non-writers) */
+	MPI_Comm m_ioComm;
+#endif // USE_MPI
+
+	/** Rank in the group */
+	int m_groupRank;
+
+	/** Size of the group */
+	int m_groupSize;
+
+	/** Number of variables */
+	unsigned int m_numVariables;
+
+	/** Number of cells of this rank */
+	unsigned int m_localCells;
+
+	/** Number of cells of the group (writer only) */
+	unsigned int m_groupCells;
+
+	/** Distance between two variables in the output buffer */
+	unsigned int m_stride;
+
+	/** Cell offsets of the group members (writer only) */
+	std::vector<unsigned int> m_cellOffsets;
+
+	/** Aggregated cells (writer only) */
+	std::vector<unsigned int> m_cells;
+
+	/** Aggregated vertices (writer only) */
+	std::vector<double> m_vertices;
+
+#ifdef USE_MPI
+	/** Data types placing the variables of a member into the aggregated buffer (writer only) */
+	std::vector<MPI_Datatype> m_types;
+
+	/** Data type of the variables in the staging buffer (non-writers only) */
+	MPI_Datatype m_sendType;
+
+	/** Pending sends for both staging buffers (non-writers only) */
+	MPI_Request m_requests[2];
+#endif // USE_MPI
+
+public:
+	OutputAggregator()
+		: m_enabled(false),
+		  m_groupRank(0), m_groupSize(1),
+		  m_numVariables(0),
+		  m_localCells(0), m_groupCells(0),
+		  m_stride(0)
+	{
+#ifdef USE_MPI
+		m_groupComm = MPI_COMM_NULL;
+		m_sendType = MPI_DATATYPE_NULL;
+		m_ioComm = MPI_COMM_WORLD;
+		m_requests[0] = m_requests[1] = MPI_REQUEST_NULL;
+#endif // USE_MPI
+	}
+
+	/**
+	 * Creates the groups and collects the mesh on the writer ranks
+	 */
+	void init(unsigned int numVariables,
+			unsigned int nCells, const unsigned int* cells,
+			unsigned int nVertices, const double* vertices)
+	{
+		m_numVariables = numVariables;
+		m_localCells = nCells;
+		m_groupCells = nCells;
+		m_stride = paddedStride(nCells);
+
+#ifdef USE_MPI
+		int aggregation = utils::Env::get<int>("SEISSOL_OUTPUT_AGGREGATION", 0);
+		if (aggregation == 0 || aggregation == 1)
+			return;
+
+		int rank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+		if (aggregation < 0)
+			MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_groupComm);
+		else
+			MPI_Comm_split(MPI_COMM_WORLD, rank / aggregation, rank, &m_groupComm);
+		MPI_Comm_rank(m_groupComm, &m_groupRank);
+		MPI_Comm_size(m_groupComm, &m_groupSize);
+
+		MPI_Comm_split(MPI_COMM_WORLD, (m_groupRank == 0 ? 0 : MPI_UNDEFINED), rank, &m_ioComm);
+
+		m_enabled = true;
+
+		int numWriters = (m_groupRank == 0 ? 1 : 0);
+		MPI_Allreduce(MPI_IN_PLACE, &numWriters, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+		logInfo(rank) << "Aggregating the wave field output on" << numWriters << "writer ranks (writers also compute)";
+
+		// Collect the mesh sizes
+		unsigned int localSize[2] = {nCells, nVertices};
+		std::vector<unsigned int> sizes(m_groupSize*2);
+		MPI_Gather(localSize, 2, MPI_UNSIGNED, &sizes[0], 2, MPI_UNSIGNED, 0, m_groupComm);
+
+		std::vector<int> cellCounts(m_groupSize), cellDispls(m_groupSize);
+		std::vector<int> vertexCounts(m_groupSize), vertexDispls(m_groupSize);
+		unsigned int groupVertices = 0;
+		if (isWriter()) {
+			m_cellOffsets.resize(m_groupSize);
+
+			m_groupCells = 0;
+			for (int i = 0; i < m_groupSize; i++) {
+				m_cellOffsets[i] = m_groupCells;
+				cellCounts[i] = sizes[i*2] * 4;
+				cellDispls[i] = m_groupCells * 4;
+				vertexCounts[i] = sizes[i*2+1] * 3;
+				vertexDispls[i] = groupVertices * 3;
+
+				m_groupCells += sizes[i*2];
+				groupVertices += sizes[i*2+1];
+			}
+
+			m_cells.resize(m_groupCells * 4);
+			m_vertices.resize(groupVertices * 3);
+		}
+
+		MPI_Gatherv(const_cast<unsigned int*>(cells), nCells*4, MPI_UNSIGNED,
+				(m_cells.empty() ? 0L : &m_cells[0]), &cellCounts[0], &cellDispls[0], MPI_UNSIGNED, 0, m_groupComm);
+		MPI_Gatherv(const_cast<double*>(vertices), nVertices*3, MPI_DOUBLE,
+				(m_vertices.empty() ? 0L : &m_vertices[0]), &vertexCounts[0], &vertexDispls[0], MPI_DOUBLE, 0, m_groupComm);
+
+		if (!isWriter()) {
+			MPI_Type_vector(m_numVariables, nCells, m_stride, MPI_DOUBLE, &m_sendType);
+			MPI_Type_commit(&m_sendType);
+			return;
+		}
+
+		m_stride = paddedStride(m_groupCells);
+
+		// Shift the vertex ids of the other members
+		for (int i = 1; i < m_groupSize; i++) {
+			unsigned int vertexOffset = vertexDispls[i] / 3;
+			for (unsigned int j = cellDispls[i]; j < static_cast<unsigned int>(cellDispls[i] + cellCounts[i]); j++)
+				m_cells[j] += vertexOffset;
+		}
+
+		// Receive each variable of a member directly at its position
+		m_types.resize(m_groupSize, MPI_DATATYPE_NULL);
+		for (int i = 1; i < m_groupSize; i++) {
+			MPI_Type_vector(m_numVariables, sizes[i*2], m_stride, MPI_DOUBLE, &m_types[i]);
+			MPI_Type_commit(&m_types[i]);
+		}
+#endif // USE_MPI
+	}
+
+	/**
+	 * @return True if data is forwarded to other ranks
+	 */
+	bool enabled() const
+	{
+		return m_enabled;
+	}
+
+	/**
+	 * @return True if this rank writes the output
+	 */
+	bool isWriter() const
+	{
+		return m_groupRank == 0;
+	}
+
+#ifdef USE_MPI
+	/**
+	 * @return The communicator of the writer ranks
+	 */
+	MPI_Comm ioComm() const
+	{
+		return m_ioComm;
+	}
+#endif // USE_MPI
+
+	/**
+	 * @return Number of cells in the output buffer
+	 */
+	unsigned int nCells() const
+	{
+		return m_groupCells;
+	}
+
+	/**
+	 * @return Distance between two variables in the output buffer
+	 */
+	unsigned int stride() const
+	{
+		return m_stride;
+	}
+
+	/**
+	 * @return The aggregated cells (writer only)
+	 */
+	const unsigned int* cells() const
+	{
+		return (m_cells.empty() ? 0L : &m_cells[0]);
+	}
+
+	/**
+	 * @return The number of aggregated vertices (writer only)
+	 */
+	unsigned int nVertices() const
+	{
+		return m_vertices.size() / 3;
+	}
+
+	/**
+	 * @return The aggregated vertices (writer only)
+	 */
+	const double* vertices() const
+	{
+		return (m_vertices.empty() ? 0L : &m_vertices[0]);
+	}
+
+	/**
+	 * Waits until a staging buffer can be reused (non-writers only)
+	 */
+	void wait(unsigned int buffer)
+	{
+#ifdef USE_MPI
+		MPI_Wait(&m_requests[buffer], MPI_STATUS_IGNORE);
+#endif // USE_MPI
+	}
+
+	/**
+	 * Forwards a staging buffer to the writer (non-writers only)
+	 */
+	void send(const double* data, unsigned int buffer)
+	{
+#ifdef USE_MPI
+		MPI_Isend(const_cast<double*>(data), 1, m_sendType,
+				0, 0, m_groupComm, &m_requests[buffer]);
+#endif // USE_MPI
+	}
+
+	/**
+	 * Receives the data of all other members into the aggregated buffer (writer only)
+	 */
+	void receive(double* data)
+	{
+#ifdef USE_MPI
+		std::vector<MPI_Request> requests(m_groupSize-1);
+		for (int i = 1; i < m_groupSize; i++)
+			MPI_Irecv(&data[m_cellOffsets[i]], 1, m_types[i], i, 0, m_groupComm, &requests[i-1]);
+		MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+#endif // USE_MPI
+	}
+
+	/**
+	 * Completes all pending transfers and frees the communicators
+	 */
+	void finalize()
+	{
+#ifdef USE_MPI
+		if (!m_enabled)
+			return;
+
+		MPI_Waitall(2, m_requests, MPI_STATUSES_IGNORE);
+
+		for (std::vector<MPI_Datatype>::iterator it = m_types.begin();
+				it != m_types.end(); it++) {
+			if (*it != MPI_DATATYPE_NULL)
+				MPI_Type_free(&*it);
+		}
+		m_types.clear();
+		if (m_sendType != MPI_DATATYPE_NULL)
+			MPI_Type_free(&m_sendType);
+
+		MPI_Comm_free(&m_groupComm);
+		if (m_ioComm != MPI_COMM_NULL)
+			MPI_Comm_free(&m_ioComm);
+		m_ioComm = MPI_COMM_WORLD;
+
+		m_enabled = false;
+#endif // USE_MPI
+	}
+
+private:
+	/**
+	 * Pads the number of cells to allow aligned stores for each variable
+	 */
+	static unsigned int paddedStride(unsigned int nCells)
+	{
+		return (nCells + 1) / 2 * 2;
+	}
+};
+
+}
+
+#endif // OUTPUT_AGGREGATOR_H
@@ -44,14 +44,20 @@
 #include <mpi.h>
 #endif // USE_MPI
 
+#include <pthread.h>
+
 #include <string>
 #include <vector>
 
+#include "utils/env.h"
 #include "utils/logger.h"
 
 #include "xdmfwriter/XdmfWriter.h"
 
-#include "Geometry/MeshReader.h"
+#include "CompressedXdmfWriter.h"
+#include "OutputAggregator.h"
+#include "Geometry/MeshGeometry.h"
+#include "Geometry/MeshSubset.h"
 #include "Geometry/refinement/TetsNone.h"
 #include "Geometry/refinement/Tets8.h"
 
@@ -70,12 +76,39 @@ private:
 	/** The output prefix for the filename */
 	std::string m_outputPrefix;
 
+	/** The refinement of the output mesh */
+	int m_refinement;
+
+	/** True for each variable that should be written */
+	std::vector<bool> m_outputMask;
+
+	/** The region of the mesh that is written (0: all, 1: bounding box, 2: free surface cells) */
+	int m_outputRegion;
+
+	/** Bounding box of the output region (xmin, xmax, ymin, ymax, zmin, zmax) */
+	double m_outputRegionBounds[6];
+
+	/** Mapping from the cells in the output region to dofs order */
+	std::vector<unsigned int> m_regionMap;
+
 	/** The XMDF Writer used for the wave field */
 	xdmfwriter::XdmfWriter<xdmfwriter::TETRAHEDRON>* m_waveFieldWriter;
 
+	/** The compression mode (0: no compression) */
+	int m_compressionMode;
+
+	/** The error bound for each variable */
+	std::vector<double> m_compressionTolerances;
+
+	/** The writer used for compressed output (replaces the XDMF writer) */
+	CompressedXdmfWriter* m_compressedWriter;
+
 	/** Number of variables */
 	unsigned int m_numVariables;
 
+	/** The variables that are written */
+	std::vector<int> m_outputVariables;
+
 	/** Tet refinement strategy */
 	refinement::Refinement* m_tetRefinement;
 
@@ -85,18 +118,76 @@ private:
 	/** Mapping from the cell order to dofs order */
 	const unsigned int* m_map;
 
-	/** Buffer required to extract the output data from the unknowns */
-	double *m_outputBuffer;
+	/** Forwards the output to the writer ranks */
+	OutputAggregator m_aggregator;
+
+	/** The current time step on ranks that do not write */
+	unsigned int m_timestep;
+
+	/**
+	 * Buffers required to extract the output data from the unknowns (all variables).
+	 * Two buffers are used in asynchronous mode: One is filled while the other one is written.
+	 */
+	double *m_outputBuffers[2];
+
+	/** The buffer that will be filled by the next write */
+	unsigned int m_nextBuffer;
+
+	/** True if the output is written by the I/O thread */
+	bool m_async;
+
+#ifdef USE_MPI
+	/**
+	 * Private communicator of the I/O thread, keeps the collective
+	 * operations of the writers apart from the ones of the main thread
+	 */
+	MPI_Comm m_ioThreadComm;
+#endif // USE_MPI
+
+	/** The I/O thread */
+	pthread_t m_thread;
+
+	/** Protects the job description below */
+	pthread_mutex_t m_mutex;
+
+	/** Signals new jobs and finished jobs */
+	pthread_cond_t m_condition;
+
+	/** True if a job is pending or being written by the I/O thread */
+	bool m_hasJob;
+
+	/** Time of the pending job */
+	double m_jobTime;
+
+	/** Buffer of the pending job */
+	unsigned int m_jobBuffer;
+
+	/** True if the I/O thread should terminate */
+	bool m_shutdown;
 
 public:
 	WaveFieldWriter()
 		: m_enabled(false), m_rank(0),
+		  m_refinement(0),
+		  m_outputRegion(0),
 		  m_waveFieldWriter(0L),
+		  m_compressionMode(0),
+		  m_compressedWriter(0L),
 		  m_numVariables(0),
 		  m_tetRefinement(0L),
 		  m_dofs(0L), m_map(0L),
-		  m_outputBuffer(0L)
+		  m_timestep(0),
+		  m_nextBuffer(0),
+		  m_async(false),
+		  m_hasJob(false),
+		  m_jobTime(0),
+		  m_jobBuffer(0),
+		  m_shutdown(false)
 	{
+		m_outputBuffers[0] = m_outputBuffers[1] = 0L;
+#ifdef USE_MPI
+		m_ioThreadComm = MPI_COMM_NULL;
+#endif // USE_MPI
 	}
 
 	/**
@@ -123,13 +214,59 @@ public:
 		m_outputPrefix = outputPrefix;
 	}
 
+	/**
+	 * Set the refinement of the output mesh
+	 *
+	 * @param refinement 0: no refinement, 1: 8 subtetrahedra per cell
+	 */
+	void setRefinement(int refinement)
+	{
+		m_refinement = refinement;
+	}
+
+	/**
+	 * Select the variables that should be written
+	 *
+	 * @param mask 1 for each variable that should be written, 0 otherwise
+	 */
+	void setOutputMask(const int* mask, unsigned int numVars)
+	{
+		m_outputMask.assign(mask, mask+numVars);
+	}
+
+	/**
+	 * Restrict the output to a region of the mesh
+	 *
+	 * @param region 0: whole mesh, 1: cells with the barycenter in the bounding box,
+	 *  2: cells with a free surface face
+	 * @param bounds The bounding box (xmin, xmax, ymin, ymax, zmin, zmax)
+	 */
+	void setOutputRegion(int region, const double bounds[6])
+	{
+		m_outputRegion = region;
+		for (unsigned int i = 0; i < 6; i++)
+			m_outputRegionBounds[i] = bounds[i];
+	}
+
+	/**
+	 * Enable lossy compression of the output data
+	 *
+	 * @param mode 0: no compression, 1: absolute error bound, 2: relative error bound
+	 * @param tolerances The error bound for each variable (0 for single precision)
+	 */
+	void setCompression(int mode, const double* tolerances, unsigned int numVars)
+	{
+		m_compressionMode = mode;
+		m_compressionTolerances.assign(tolerances, tolerances+numVars);
+	}
+
 	/**
 	 * Initialize the wave field ouput
 	 *
 	 * @param map The mapping from the cell order to dofs order
 	 */
 	void init(int numVars, int numBasisFuncs,
-			const MeshReader &meshReader,
+			const MeshGeometry &geometry,
 			const double* dofs, const unsigned int* map,
 			int timestep)
 	{
@@ -142,52 +279,182 @@ public:
 
 		logInfo(m_rank) << "Initializing HDF5 wave field output.";
 
-		if (m_waveFieldWriter != 0L)
+		if (m_waveFieldWriter != 0L || m_compressedWriter != 0L)
 			logError() << "Wave field writer already initialized";
 
-		m_numVariables = numVars;
+		// Select the variables (memory variables are not written)
+		static const char* const VARIABLE_NAMES[9] = {
+			"sigma_xx", "sigma_yy", "sigma_zz", "sigma_xy", "sigma_yz", "sigma_xz",
+			"u", "v", "w"
+		};
+		if (numVars < 9)
+			logError() << "XDMF output requires at least 9 variables. Number of variables specified:" << numVars;
+
+		std::vector<const char*> variables;
+		m_outputVariables.clear();
+		for (unsigned int i = 0; i < 9; i++) {
+			if (i < m_outputMask.size() && !m_outputMask[i])
+				continue;
+
+			m_outputVariables.push_back(i);
+			variables.push_back(VARIABLE_NAMES[i]);
+		}
+		m_numVariables = m_outputVariables.size();
+		if (m_numVariables == 0)
+			logWarning(m_rank) << "No variables selected for the wave field output";
+
+		// iOutputMask used to be ignored by the XDMF output, show the selection
+		std::string variableList;
+		for (unsigned int i = 0; i < m_numVariables; i++) {
+			if (i > 0)
+				variableList += ", ";
+			variableList += variables[i];
+		}
+		logInfo(m_rank) << "Wave field output variables:" << variableList;
+		if (m_numVariables > 0 && m_numVariables < 9)
+			logInfo(m_rank) << "Variables disabled in iOutputMask are not written to the wave field output";
+
+		// Select the cells
+		const MeshGeometry* outputMesh = &geometry;
+		MeshSubset* subset = 0L;
+		if (m_outputRegion != 0) {
+			std::vector<bool> selected(geometry.nElements());
+			for (unsigned int i = 0; i < geometry.nElements(); i++)
+				selected[i] = inOutputRegion(geometry, i);
+
+			subset = new MeshSubset(geometry, selected);
+			outputMesh = subset;
+
+			m_regionMap.resize(subset->originalIds().size());
+			for (unsigned int i = 0; i < m_regionMap.size(); i++)
+				m_regionMap[i] = map[subset->originalIds()[i]];
+			map = (m_regionMap.empty() ? 0L : &m_regionMap[0]);
+		}
+
+		switch (m_refinement) {
+		case 0:
+			m_tetRefinement = new refinement::TetsNone(*outputMesh,
+					numVars, numBasisFuncs);
+			break;
+		case 1:
+			logInfo(m_rank) << "Refining the output mesh into 8 subtetrahedra per cell";
+			m_tetRefinement = new refinement::Tets8(*outputMesh,
+					numVars, numBasisFuncs);
+			break;
+		default:
+			logError() << "Unknown wave field output refinement" << m_refinement;
+		}
 
-		if (numVars != 9)
-			logError() << "XDMF output supports currently only 9 variables. Number of variables specified:" << m_numVariables;
-		std::vector<const char*> variables(m_numVariables);
-		variables[0] = "sigma_xx";
-		variables[1] = "sigma_yy";
-		variables[2] = "sigma_zz";
-		variables[3] = "sigma_xy";
-		variables[4] = "sigma_yz";
-		variables[5] = "sigma_xz";
-		variables[6] = "u";
-		variables[7] = "v";
-		variables[8] = "w";
+		delete subset;
 
-		m_waveFieldWriter = new xdmfwriter::XdmfWriter<xdmfwriter::TETRAHEDRON>(
-				m_rank, m_outputPrefix.c_str(), variables, timestep);
+		m_aggregator.init(m_numVariables, m_tetRefinement->nCells(), m_tetRefinement->cells(),
+				m_tetRefinement->nVertices(), m_tetRefinement->vertices());
+		m_timestep = timestep;
 
-		m_tetRefinement = new refinement::TetsNone(meshReader,
-				numVars, numBasisFuncs);
+		// Asynchronous output requires MPI calls from the I/O thread,
+		// forwarding ranks only send and do not need the thread
+		m_async = m_aggregator.isWriter() && utils::Env::get<int>("SEISSOL_ASYNC_OUTPUT", 0) != 0;
+#ifdef USE_MPI
+		int threadLevel;
+		MPI_Query_thread(&threadLevel);
+		if (m_async && threadLevel < MPI_THREAD_MULTIPLE) {
+			logWarning(m_rank) << "MPI does not support MPI_THREAD_MULTIPLE, using synchronous wave field output";
+			m_async = false;
+		}
 
-		// TODO option to disable the vertex filter
-		m_waveFieldWriter->init(m_tetRefinement->nCells(), m_tetRefinement->cells(),
-				m_tetRefinement->nVertices(), m_tetRefinement->vertices(), true);
+		// The I/O thread uses its own copy of the communicator, so its collective
+		// operations cannot be mixed up with the ones of the main thread
+		MPI_Comm ioComm = m_aggregator.ioComm();
+		if (m_async) {
+			MPI_Comm_dup(ioComm, &m_ioThreadComm);
+			ioComm = m_ioThreadComm;
+		}
+#endif // USE_MPI
 
-		// Create output buffer
-		m_outputBuffer = new double[m_tetRefinement->nCells()];
+		if (m_aggregator.isWriter() && m_compressionMode != 0) {
+			if (m_compressionMode < 0 || m_compressionMode > 2)
+				logError() << "Unknown wave field compression mode" << m_compressionMode;
+			logInfo(m_rank) << "Using compressed wave field output";
+
+			std::vector<double> tolerances(m_numVariables, 0.);
+			for (unsigned int i = 0; i < m_numVariables; i++) {
+				if (static_cast<unsigned int>(m_outputVariables[i]) < m_compressionTolerances.size())
+					tolerances[i] = m_compressionTolerances[m_outputVariables[i]];
+			}
+
+			m_compressedWriter = new CompressedXdmfWriter(m_rank, m_outputPrefix.c_str(), variables, timestep);
+			m_compressedWriter->setCompression(static_cast<CompressedXdmfWriter::Mode>(m_compressionMode),
+					tolerances);
+			// Do not start an OpenMP team from the I/O thread
+			m_compressedWriter->setSerial(m_async);
+#ifdef USE_MPI
+			m_compressedWriter->setComm(ioComm);
+#endif // USE_MPI
+
+			if (m_aggregator.enabled()) {
+				m_compressedWriter->init(m_aggregator.nCells(), m_aggregator.cells(),
+						m_aggregator.nVertices(), m_aggregator.vertices());
+			} else {
+				m_compressedWriter->init(m_tetRefinement->nCells(), m_tetRefinement->cells(),
+						m_tetRefinement->nVertices(), m_tetRefinement->vertices());
+			}
+		} else if (m_aggregator.isWriter()) {
+			m_waveFieldWriter = new xdmfwriter::XdmfWriter<xdmfwriter::TETRAHEDRON>(
+					m_rank, m_outputPrefix.c_str(), variables, timestep);
+
+#ifdef USE_MPI
+			m_waveFieldWriter->setComm(ioComm);
+#endif // USE_MPI
+
+			// TODO option to disable the vertex filter
+			if (m_aggregator.enabled()) {
+				m_waveFieldWriter->init(m_aggregator.nCells(), m_aggregator.cells(),
+						m_aggregator.nVertices(), m_aggregator.vertices(), true);
+			} else {
+				m_waveFieldWriter->init(m_tetRefinement->nCells(), m_tetRefinement->cells(),
+						m_tetRefinement->nVertices(), m_tetRefinement->vertices(), true);
+			}
+		}
+
+		// Create output buffers
+		m_outputBuffers[0] = new double[m_aggregator.stride() * m_numVariables];
+		if (m_async || !m_aggregator.isWriter())
+			m_outputBuffers[1] = new double[m_aggregator.stride() * m_numVariables];
 
 		// Save dof/map pointer
 		m_dofs = dofs;
 		m_map = map;
 
+		if (m_async) {
+			logInfo(m_rank) << "Using asynchronous wave field output";
+
+			m_shutdown = false;
+			m_hasJob = false;
+			pthread_mutex_init(&m_mutex, 0L);
+			pthread_cond_init(&m_condition, 0L);
+			if (pthread_create(&m_thread, 0L, runIOThread, this) != 0)
+				logError() << "Could not create the wave field output thread";
+		}
+
 		logInfo(m_rank) << "Initializing HDF5 wave field output. Done.";
 	}
 
 	/**
 	 * @return The current time step of the wave field output
 	 */
-	unsigned int timestep() const
+	unsigned int timestep()
 	{
 		if (!m_enabled)
 			return 0;
 
+		if (!m_aggregator.isWriter())
+			return m_timestep;
+
+		// The I/O thread updates the time step
+		wait();
+
+		if (m_compressedWriter)
+			return m_compressedWriter->timestep();
 		return m_waveFieldWriter->timestep();
 	}
 
@@ -202,19 +469,52 @@ public:
 		if (!m_enabled)
 			return;
 
-		logInfo(m_rank) << "Writing wave field at time" << utils::nospace << time << '.';
-
-		m_waveFieldWriter->addTimeStep(time);
-
-		for (unsigned int i = 0; i < m_numVariables; i++) {
-			m_tetRefinement->get(m_dofs, m_map, i, m_outputBuffer);
+		// Snapshot the output data, overlaps with the write of the previous time step
+		double* buffer = m_outputBuffers[m_nextBuffer];
+		if (!m_aggregator.isWriter())
+			m_aggregator.wait(m_nextBuffer);
+		if (m_numVariables > 0)
+			m_tetRefinement->getAll(m_dofs, m_map, m_numVariables, &m_outputVariables[0],
+					buffer, m_aggregator.stride());
+
+		if (!m_aggregator.isWriter()) {
+			// Forward the data, the writer rank does the file I/O
+			m_aggregator.send(buffer, m_nextBuffer);
+			m_nextBuffer = 1 - m_nextBuffer;
+			m_timestep++;
+			return;
+		}
 
-			m_waveFieldWriter->writeData(i, m_outputBuffer);
+		if (!m_async) {
+			writeStep(time, buffer);
+			return;
 		}
 
-		m_waveFieldWriter->flush();
+		// Wait for the previous time step and hand over the buffer to the I/O thread
+		pthread_mutex_lock(&m_mutex);
+		while (m_hasJob)
+			pthread_cond_wait(&m_condition, &m_mutex);
+		m_jobTime = time;
+		m_jobBuffer = m_nextBuffer;
+		m_hasJob = true;
+		pthread_cond_broadcast(&m_condition);
+		pthread_mutex_unlock(&m_mutex);
+
+		m_nextBuffer = 1 - m_nextBuffer;
+	}
 
-		logInfo(m_rank) << "Writing wave field at time" << utils::nospace << time << ". Done.";
+	/**
+	 * Waits until all pending time steps are written
+	 */
+	void wait()
+	{
+		if (!m_async)
+			return;
+
+		pthread_mutex_lock(&m_mutex);
+		while (m_hasJob)
+			pthread_cond_wait(&m_condition, &m_mutex);
+		pthread_mutex_unlock(&m_mutex);
 	}
 
 	/**
@@ -225,12 +525,129 @@ public:
 		if (!m_enabled)
 			return;
 
+		if (m_async) {
+			// Write pending time steps and stop the I/O thread
+			pthread_mutex_lock(&m_mutex);
+			m_shutdown = true;
+			pthread_cond_broadcast(&m_condition);
+			pthread_mutex_unlock(&m_mutex);
+
+			pthread_join(m_thread, 0L);
+			pthread_cond_destroy(&m_condition);
+			pthread_mutex_destroy(&m_mutex);
+			m_async = false;
+		}
+
 		delete m_waveFieldWriter;
 		m_waveFieldWriter = 0L;
+		delete m_compressedWriter;
+		m_compressedWriter = 0L;
+
+		// Free the communicators after the writers are closed
+		m_aggregator.finalize();
 		delete m_tetRefinement;
 		m_tetRefinement = 0L;
-		delete m_outputBuffer;
-		m_outputBuffer = 0L;
+		for (unsigned int i = 0; i < 2; i++) {
+			delete [] m_outputBuffers[i];
+			m_outputBuffers[i] = 0L;
+		}
+
+#ifdef USE_MPI
+		if (m_ioThreadComm != MPI_COMM_NULL)
+			MPI_Comm_free(&m_ioThreadComm);
+#endif // USE_MPI
+	}
+
+private:
+	/**
+	 * @return True if the element is part of the output region
+	 */
+	bool inOutputRegion(const MeshGeometry &geometry, unsigned int element) const
+	{
+		switch (m_outputRegion) {
+		case 1:
+			{
+				VrtxCoords center;
+				geometry.center(element, center);
+				for (unsigned int i = 0; i < 3; i++) {
+					if (center[i] < m_outputRegionBounds[i*2] || center[i] > m_outputRegionBounds[i*2+1])
+						return false;
+				}
+				return true;
+			}
+		case 2:
+			for (unsigned int i = 0; i < 4; i++) {
+				if (geometry.isFreeSurface(element, i))
+					return true;
+			}
+			return false;
+		default:
+			logError() << "Unknown wave field output region" << m_outputRegion;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Writes all variables of a time step
+	 *
+	 * @param buffer The extracted data of all variables
+	 */
+	void writeStep(double time, double* buffer)
+	{
+		logInfo(m_rank) << "Writing wave field at time" << utils::nospace << time << '.';
+
+		if (m_aggregator.enabled())
+			m_aggregator.receive(buffer);
+
+		if (m_compressedWriter) {
+			m_compressedWriter->addTimeStep(time);
+
+			for (unsigned int i = 0; i < m_numVariables; i++)
+				m_compressedWriter->writeData(i, &buffer[i * m_aggregator.stride()]);
+
+			m_compressedWriter->flush();
+		} else {
+			m_waveFieldWriter->addTimeStep(time);
+
+			for (unsigned int i = 0; i < m_numVariables; i++)
+				m_waveFieldWriter->writeData(i, &buffer[i * m_aggregator.stride()]);
+
+			m_waveFieldWriter->flush();
+		}
+
+		logInfo(m_rank) << "Writing wave field at time" << utils::nospace << time << ". Done.";
+	}
+
+	/**
+	 * Main loop of the I/O thread: writes the pending time step until shutdown
+	 */
+	void ioThread()
+	{
+		pthread_mutex_lock(&m_mutex);
+		while (true) {
+			while (!m_hasJob && !m_shutdown)
+				pthread_cond_wait(&m_condition, &m_mutex);
+			if (!m_hasJob)
+				break; // Shutdown and nothing left to write
+
+			double time = m_jobTime;
+			double* buffer = m_outputBuffers[m_jobBuffer];
+			pthread_mutex_unlock(&m_mutex);
+
+			writeStep(time, buffer);
+
+			pthread_mutex_lock(&m_mutex);
+			m_hasJob = false;
+			pthread_cond_broadcast(&m_condition);
+		}
+		pthread_mutex_unlock(&m_mutex);
+	}
+
+	static void* runIOThread(void* writer)
+	{
+		static_cast<WaveFieldWriter*>(writer)->ioThread();
+		return 0L;
 	}
 };
 
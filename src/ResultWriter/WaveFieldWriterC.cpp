@@ -61,25 +61,34 @@ extern "C"
 void wavefield_hdf_init(int rank, const char* outputPrefix,
 		const double* dofs,
 		int numVars, int numBasisFuncs,
+		int refinement, const int* outputMask,
+		int outputRegion, const double* outputRegionBounds,
+		int compressionMode, const double* compressionTolerance,
 		int timestep)
 {
 	seissol::SeisSol::main.waveFieldWriter().enable();
 	seissol::SeisSol::main.waveFieldWriter().setFilename(outputPrefix);
+	seissol::SeisSol::main.waveFieldWriter().setRefinement(refinement);
+	seissol::SeisSol::main.waveFieldWriter().setOutputMask(outputMask, 9);
+	seissol::SeisSol::main.waveFieldWriter().setOutputRegion(outputRegion, outputRegionBounds);
+	seissol::SeisSol::main.waveFieldWriter().setCompression(compressionMode, compressionTolerance, 9);
+
+	// I/O is currently the last initialization that requires the mesh reader,
+	// the output is initialized from the remaining geometry
+	seissol::SeisSol::main.requireGeometry();
+	seissol::SeisSol::main.freeMeshReader();
+	const MeshGeometry& geometry = seissol::SeisSol::main.geometry();
 
 	// Create the map (really required for clustered lts)
-	MeshReader& meshReader = seissol::SeisSol::main.meshReader();
-	cellMap = new unsigned int[meshReader.getElements().size()];
+	cellMap = new unsigned int[geometry.nElements()];
 #ifdef _OPENMP
 	#pragma omp parallel for
 #endif //_OPENMP
-	for (unsigned int i = 0; i < meshReader.getElements().size(); i++)
+	for (unsigned int i = 0; i < geometry.nElements(); i++)
 		cellMap[i] = i;
 
 	seissol::SeisSol::main.waveFieldWriter().init(numVars, numBasisFuncs,
-			meshReader,	dofs, cellMap, timestep);
-
-	// I/O is currently the last initialization that requires the mesh reader
-	seissol::SeisSol::main.freeMeshReader();
+			geometry, dofs, cellMap, timestep);
 }
 
 void wavefield_hdf_close()
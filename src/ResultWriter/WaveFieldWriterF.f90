@@ -47,6 +47,8 @@ module WaveFieldWriter
     ! C functions
     interface
         subroutine wavefield_hdf_init(rank, outputPrefix, dofs, numVars, numBasisFuncs, &
+                refinement, outputMask, outputRegion, outputRegionBounds, &
+                compressionMode, compressionTolerance, &
                 timestep) bind(C, name="wavefield_hdf_init")
             use, intrinsic :: iso_c_binding
 
@@ -55,6 +57,12 @@ module WaveFieldWriter
             real( kind=c_double ), dimension(*), intent(in)    :: dofs
             integer( kind=c_int ), value                       :: numVars
             integer( kind=c_int ), value                       :: numBasisFuncs
+            integer( kind=c_int ), value                       :: refinement
+            integer( kind=c_int ), dimension(*), intent(in)    :: outputMask
+            integer( kind=c_int ), value                       :: outputRegion
+            real( kind=c_double ), dimension(*), intent(in)    :: outputRegionBounds
+            integer( kind=c_int ), value                       :: compressionMode
+            real( kind=c_double ), dimension(*), intent(in)    :: compressionTolerance
             integer( kind=c_int ), value                       :: timestep
         end subroutine wavefield_hdf_init
 
@@ -85,6 +93,9 @@ contains
         call wavefield_hdf_init(mpi%myRank, trim(io%OutputFile) // c_null_char, &
             disc%galerkin%dgvar(:, :, :, 1), &
             eqn%nVarTotal, disc%Galerkin%nDegFr, &
+            io%Refinement, merge(1, 0, io%OutputMask(4:12)), &
+            io%OutputRegion, io%OutputRegionBounds, &
+            io%CompressionMode, io%CompressionTolerance, &
             timestep)
     end subroutine waveFieldWriterInit
 
@@ -42,6 +42,8 @@
 #include <mpi.h>
 #endif
 
+#include <cassert>
+
 #ifdef GENERATEDKERNELS
 #include "Solver/time_stepping/TimeManager.h"
 #include "Solver/Simulator.h"
@@ -49,8 +51,11 @@
 #include "Checkpoint/Manager.h"
 #endif // GENERATEDKERNELS
 
+#include "Geometry/MeshGeometry.h"
 #include "ResultWriter/WaveFieldWriter.h"
+#include "ResultWriter/FreeSurfaceWriter.h"
 
+#include "utils/env.h"
 #include "utils/logger.h"
 
 #define SEISSOL_VERSION_STRING "SVN Mainline"
@@ -68,6 +73,12 @@ class SeisSol
 private:
 	MeshReader* m_meshReader;
 
+	/** Geometry of the local mesh, retained after the mesh reader is freed */
+	MeshGeometry* m_geometry;
+
+	/** True if a module requires the geometry after the mesh reader is freed */
+	bool m_geometryRequired;
+
 #ifdef GENERATEDKERNELS
 	/*
 	 * initializers
@@ -87,12 +98,15 @@ private:
 	/** Wavefield output module */
 	seissol::WaveFieldWriter m_waveFieldWriter;
 
+	/** Free surface output module */
+	seissol::FreeSurfaceWriter m_freeSurfaceWriter;
+
 private:
 	/**
 	 * Only one instance of this class should exist (private constructor).
 	 */
 	SeisSol()
-		: m_meshReader(0L)
+		: m_meshReader(0L), m_geometry(0L), m_geometryRequired(false)
 	{}
 
 public:
@@ -102,6 +116,7 @@ public:
 	virtual ~SeisSol()
 	{
 		delete m_meshReader;
+		delete m_geometry;
 	}
 
 	/**
@@ -134,6 +149,14 @@ public:
 		return m_waveFieldWriter;
 	}
 
+	/**
+	 * Get the free surface writer module
+	 */
+	FreeSurfaceWriter& freeSurfaceWriter()
+	{
+		return m_freeSurfaceWriter;
+	}
+
 	/**
 	 * Set the mesh reader
 	 */
@@ -145,13 +168,47 @@ public:
 		m_meshReader = meshReader;
 	}
 
+	/**
+	 * Registers a module that is initialized from the {@link MeshGeometry}
+	 * (must be called before the mesh reader is freed)
+	 */
+	void requireGeometry()
+	{
+		if (m_meshReader == 0L && m_geometry == 0L)
+			logError() << "Mesh geometry requested after the mesh reader was freed";
+
+		m_geometryRequired = true;
+	}
+
 	/**
 	 * Delete the mesh reader to free memory resources.
 	 *
+	 * If a module registered with {@link requireGeometry}, the vertex
+	 * coordinates and the element connectivity are kept in a compact
+	 * {@link MeshGeometry}. Coordinates are stored in single precision
+	 * if SEISSOL_GEOMETRY_SINGLE is set.
+	 *
 	 * Should be called after initialization
 	 */
 	void freeMeshReader()
 	{
+		if (m_meshReader == 0L)
+			return;
+
+		if (m_geometryRequired && m_geometry == 0L) {
+			int rank = 0;
+#ifdef USE_MPI
+			MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif // USE_MPI
+
+			m_geometry = new MeshGeometry(*m_meshReader,
+				utils::Env::get<int>("SEISSOL_GEOMETRY_SINGLE", 0) != 0);
+
+			logInfo(rank) << "Keeping mesh geometry:" << m_geometry->memoryUsage() / (1024.*1024.)
+				<< "MiB instead of" << m_meshReader->memoryUsage() / (1024.*1024.)
+				<< "MiB for the mesh reader (on rank 0)";
+		}
+
 		delete m_meshReader;
 		m_meshReader = 0L;
 	}
@@ -172,6 +229,18 @@ public:
 		return *m_meshReader;
 	}
 
+	/**
+	 * Get the geometry of the local mesh
+	 *
+	 * Only available after the mesh reader was freed and only if
+	 * {@link requireGeometry} was called
+	 */
+	const MeshGeometry& geometry() const
+	{
+		assert(m_geometry != 0L);
+		return *m_geometry;
+	}
+
 public:
 	/** The only instance of this class; the main C++ functionality */
 	static SeisSol main;
@@ -41,6 +41,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <vector>
 
 #include "Interoperability.h"
 #include "time_stepping/TimeManager.h"
@@ -150,13 +151,21 @@ extern "C" {
     e_interoperability.synchronizeCopyLayerDofs();
   }
 
-  void c_interoperability_enableWaveFieldOutput( double *i_waveFieldInterval, const char* i_waveFieldFilename ) {
-    e_interoperability.enableWaveFieldOutput( i_waveFieldInterval, i_waveFieldFilename );
+  void c_interoperability_enableWaveFieldOutput( double *i_waveFieldInterval, const char* i_waveFieldFilename, int *i_waveFieldRefinement,
+                                                 int *i_outputMask, int *i_outputRegion, double *i_outputRegionBounds,
+                                                 int *i_compressionMode, double *i_compressionTolerance ) {
+    e_interoperability.enableWaveFieldOutput( i_waveFieldInterval, i_waveFieldFilename, i_waveFieldRefinement,
+                                              i_outputMask, i_outputRegion, i_outputRegionBounds,
+                                              i_compressionMode, i_compressionTolerance );
   }
 
-  void c_interoperability_enableCheckPointing( double *i_checkPointInterval,
+  void c_interoperability_enableFreeSurfaceOutput( double *i_freeSurfaceInterval, const char* i_freeSurfaceFilename ) {
+    e_interoperability.enableFreeSurfaceOutput( i_freeSurfaceInterval, i_freeSurfaceFilename );
+  }
+
+  void c_interoperability_enableCheckPointing( double *i_checkPointInterval, double *i_checkPointMtbf,
 		  const char* i_checkPointFilename, const char* i_checkPointBackend ) {
-    e_interoperability.enableCheckPointing( i_checkPointInterval,
+    e_interoperability.enableCheckPointing( i_checkPointInterval, i_checkPointMtbf,
     		i_checkPointFilename, i_checkPointBackend );
   }
 
@@ -300,12 +309,15 @@ void seissol::Interoperability::setTimeStepWidth( int    *i_meshId,
 
 void seissol::Interoperability::initializeClusteredLts( int *i_clustering ) {
   // assert a valid clustering
-  assert( *i_clustering > 0 );
+  assert( *i_clustering != 0 );
 
-  // either derive a GTS or LTS layout
+  // either derive a GTS, an optimal LTS or a fixed rate LTS layout
   if( *i_clustering == 1 ) {
     seissol::SeisSol::main.getLtsLayout().deriveLayout( single, 1);
   }
+  else if( *i_clustering < 0 ) {
+    seissol::SeisSol::main.getLtsLayout().deriveLayout( optimalMultiRate, -(*i_clustering) );
+  }
   else {
     seissol::SeisSol::main.getLtsLayout().deriveLayout( multiRate, *i_clustering );
   }
@@ -585,17 +597,32 @@ void seissol::Interoperability::synchronizeCopyLayerDofs() {
   }
 }
 
-void seissol::Interoperability::enableWaveFieldOutput( double *i_waveFieldInterval, const char *i_waveFieldFilename ) {
+void seissol::Interoperability::enableWaveFieldOutput( double *i_waveFieldInterval, const char *i_waveFieldFilename, int *i_waveFieldRefinement,
+                                                       int *i_outputMask, int *i_outputRegion, double *i_outputRegionBounds,
+                                                       int *i_compressionMode, double *i_compressionTolerance ) {
   seissol::SeisSol::main.simulator().setWaveFieldInterval( *i_waveFieldInterval );
   seissol::SeisSol::main.waveFieldWriter().enable();
   seissol::SeisSol::main.waveFieldWriter().setFilename( i_waveFieldFilename );
+  seissol::SeisSol::main.waveFieldWriter().setRefinement( *i_waveFieldRefinement );
+  seissol::SeisSol::main.waveFieldWriter().setOutputMask( i_outputMask, 9 );
+  seissol::SeisSol::main.waveFieldWriter().setOutputRegion( *i_outputRegion, i_outputRegionBounds );
+  seissol::SeisSol::main.waveFieldWriter().setCompression( *i_compressionMode, i_compressionTolerance, 9 );
+}
+
+void seissol::Interoperability::enableFreeSurfaceOutput( double *i_freeSurfaceInterval, const char *i_freeSurfaceFilename ) {
+  seissol::SeisSol::main.simulator().setFreeSurfaceInterval( *i_freeSurfaceInterval );
+  seissol::SeisSol::main.freeSurfaceWriter().enable();
+  seissol::SeisSol::main.freeSurfaceWriter().setFilename( i_freeSurfaceFilename );
 }
 
-void seissol::Interoperability::enableCheckPointing( double *i_checkPointInterval,
+void seissol::Interoperability::enableCheckPointing( double *i_checkPointInterval, double *i_checkPointMtbf,
 		const char *i_checkPointFilename, const char *i_checkPointBackend ) {
   seissol::SeisSol::main.simulator().setCheckPointInterval( *i_checkPointInterval );
+  seissol::SeisSol::main.simulator().setCheckPointMtbf( *i_checkPointMtbf );
   if (strcmp(i_checkPointBackend, "posix") == 0)
 	  seissol::SeisSol::main.checkPointManager().setBackend(checkpoint::POSIX);
+  else if (strcmp(i_checkPointBackend, "posix_async") == 0)
+	  seissol::SeisSol::main.checkPointManager().setBackend(checkpoint::POSIX_ASYNC);
   else if (strcmp(i_checkPointBackend, "hdf5") == 0)
 	  seissol::SeisSol::main.checkPointManager().setBackend(checkpoint::HDF5);
   else if (strcmp(i_checkPointBackend, "mpio") == 0)
@@ -612,6 +639,32 @@ void seissol::Interoperability::initializeIO(
 		  double* slip1, double* slip2, double* state, double* strength,
 		  int numSides, int numBndGP)
 {
+	  // Global element ids allow checkpoints that are independent of the partitioning
+	  // (partitions without cells still have global ids)
+	  const std::vector<int> &meshGlobalIds = seissol::SeisSol::main.meshReader().getGlobalElementIds();
+	  int hasGlobalIds = seissol::SeisSol::main.meshReader().hasGlobalElementIds();
+	  int rank = 0;
+#ifdef USE_MPI
+	  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	  MPI_Allreduce(MPI_IN_PLACE, &hasGlobalIds, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+#endif // USE_MPI
+	  if (!hasGlobalIds)
+		  logInfo(rank) << "The mesh reader provides no global element ids, checkpoints are stored in rank order";
+	  std::vector<int> globalIds;
+	  std::vector<unsigned int> sourceCells;
+	  if (hasGlobalIds) {
+		  globalIds.resize(m_numberOfCopyInteriorCells);
+		  sourceCells.resize(m_numberOfCopyInteriorCells);
+		  for (unsigned int i = 0; i < m_numberOfCopyInteriorCells; i++) {
+			  globalIds[i] = meshGlobalIds[m_copyInteriorToMesh[i]];
+			  // Copy cells may be duplicated, only one of them is up to date
+			  sourceCells[i] = m_meshToCopyInterior[m_copyInteriorToMesh[i]];
+		  }
+		  seissol::SeisSol::main.checkPointManager().setGlobalIds(
+				  m_numberOfCopyInteriorCells > 0 ? &globalIds[0] : 0L,
+				  m_numberOfCopyInteriorCells > 0 ? &sourceCells[0] : 0L);
+	  }
+
 	  // Initialize checkpointing
 	  double currentTime;
 	  int waveFieldTimeStep = 0;
@@ -626,16 +679,30 @@ void seissol::Interoperability::initializeIO(
 		  f_interoperability_setDynamicRuptureTimeStep(m_domain, &faultTimeStep);
 	  }
 
-	  // Initialize wave field output
-	  seissol::SeisSol::main.waveFieldWriter().init(
-			  NUMBER_OF_QUANTITIES, NUMBER_OF_ALIGNED_BASIS_FUNCTIONS,
-			  seissol::SeisSol::main.meshReader(),
-			  reinterpret_cast<const double*>(m_dofs), m_meshToCopyInterior,
-			  waveFieldTimeStep);
+	  // The output modules are initialized from the mesh geometry
+	  if (seissol::SeisSol::main.waveFieldWriter().isEnabled()
+			  || seissol::SeisSol::main.freeSurfaceWriter().isEnabled())
+		  seissol::SeisSol::main.requireGeometry();
 
-	  // I/O initialization is the last step that requires the mesh reader
+	  // Checkpoints are the last step that requires the mesh reader
 	  // (at least at the moment ...)
 	  seissol::SeisSol::main.freeMeshReader();
+
+	  // Initialize wave field output
+	  if (seissol::SeisSol::main.waveFieldWriter().isEnabled())
+		  seissol::SeisSol::main.waveFieldWriter().init(
+				  NUMBER_OF_QUANTITIES, NUMBER_OF_ALIGNED_BASIS_FUNCTIONS,
+				  seissol::SeisSol::main.geometry(),
+				  reinterpret_cast<const double*>(m_dofs), m_meshToCopyInterior,
+				  waveFieldTimeStep);
+
+	  // Initialize free surface output
+	  if (seissol::SeisSol::main.freeSurfaceWriter().isEnabled())
+		  seissol::SeisSol::main.freeSurfaceWriter().init(
+				  NUMBER_OF_QUANTITIES, NUMBER_OF_ALIGNED_BASIS_FUNCTIONS,
+				  seissol::SeisSol::main.geometry(),
+				  reinterpret_cast<const double*>(m_dofs), m_meshToCopyInterior,
+				  seissol::SeisSol::main.simulator().getFreeSurfaceTimeStep());
 }
 
 void seissol::Interoperability::getDynamicRuptureTimeStep(int &o_timeStep)
@@ -741,6 +808,7 @@ void seissol::Interoperability::simulate( double *i_finalTime ) {
 void seissol::Interoperability::finalizeIO()
 {
 	seissol::SeisSol::main.waveFieldWriter().close();
+	seissol::SeisSol::main.freeSurfaceWriter().close();
 	seissol::SeisSol::main.checkPointManager().close();
 }
 
@@ -164,6 +164,7 @@ class seissol::Interoperability {
     * Clustering stategy is mapped as follows:
     *   1:  Global time stepping
     *   2+: Fixed rate between clusters
+    *   -n: Rate (up to n) and cluster boundaries with lowest predicted time to solution
     *
     * @param i_clustering clustering strategy 
     **/
@@ -246,17 +247,34 @@ class seissol::Interoperability {
     *
     * @param i_waveFieldInterval plotting interval of the wave field.
     * @param i_waveFieldFilename file name prefix of the wave field.
+    * @param i_waveFieldRefinement refinement of the output mesh.
+    * @param i_outputMask 1 for each of the 9 variables that should be written.
+    * @param i_outputRegion region of the mesh that is written.
+    * @param i_outputRegionBounds bounding box of the output region.
+    * @param i_compressionMode lossy compression of the output (0: none, 1: absolute, 2: relative error bound).
+    * @param i_compressionTolerance error bound of each of the 9 variables.
     **/
-   void enableWaveFieldOutput( double *i_waveFieldInterval, const char *i_waveFieldFilename );
+   void enableWaveFieldOutput( double *i_waveFieldInterval, const char *i_waveFieldFilename, int *i_waveFieldRefinement,
+                               int *i_outputMask, int *i_outputRegion, double *i_outputRegionBounds,
+                               int *i_compressionMode, double *i_compressionTolerance );
+
+   /**
+    * Enable the free surface output.
+    *
+    * @param i_freeSurfaceInterval output interval of the free surface.
+    * @param i_freeSurfaceFilename file name prefix of the free surface output.
+    **/
+   void enableFreeSurfaceOutput( double *i_freeSurfaceInterval, const char *i_freeSurfaceFilename );
 
    /**
     * Enable checkpointing.
     *
     * @param i_checkPointInterval check pointing interval.
+    * @param i_checkPointMtbf mean time between failures (wall clock seconds, 0 for a fixed interval).
     * @param i_checkPointFilename file name prefix for checkpointing.
     * @param i_checkPointBackend name of the checkpoint backend
     **/
-   void enableCheckPointing( double *i_checkPointInterval,
+   void enableCheckPointing( double *i_checkPointInterval, double *i_checkPointMtbf,
 		   const char *i_checkPointFilename, const char* i_checkPointBackend );
 
    void initializeIO(double* mu, double* slipRate1, double* slipRate2,
@@ -39,12 +39,14 @@
  * Entry point of the simulation.
  **/
 
+#include <cmath>
 #include <limits>
 
 #include "Simulator.h"
 #include "SeisSol.h"
 #include "Interoperability.h"
 #include "time_stepping/TimeManager.h"
+#include "Monitoring/PhaseStatistics.hpp"
 
 extern seissol::Interoperability e_interoperability;
 
@@ -54,8 +56,12 @@ seissol::Simulator::Simulator():
   m_finalTime(          0 ),
   m_waveFieldTime(      0 ),
   m_waveFieldInterval(  std::numeric_limits< double >::max() ),
+  m_freeSurfaceTime(    0 ),
+  m_freeSurfaceInterval( std::numeric_limits< double >::max() ),
   m_checkPointTime(     0 ),
   m_checkPointInterval( std::numeric_limits< double >::max() ),
+  m_checkPointMtbf(     0 ),
+  m_checkPointWallTime( 0 ),
   m_loadCheckPoint( false ) {};
 
 void seissol::Simulator::setWaveFieldInterval( double i_waveFieldInterval ) {
@@ -63,11 +69,62 @@ void seissol::Simulator::setWaveFieldInterval( double i_waveFieldInterval ) {
   m_waveFieldInterval = i_waveFieldInterval;
 }
 
+void seissol::Simulator::setFreeSurfaceInterval( double i_freeSurfaceInterval ) {
+  assert( i_freeSurfaceInterval > 0 );
+  m_freeSurfaceInterval = i_freeSurfaceInterval;
+}
+
+int seissol::Simulator::getFreeSurfaceTimeStep() const {
+  if( m_currentTime == 0.0 ) {
+    return 0;
+  }
+
+  double l_timeTolerance = seissol::SeisSol::main.timeManager().getTimeTolerance();
+  return static_cast<int>( std::floor( (m_currentTime + l_timeTolerance) / m_freeSurfaceInterval ) ) + 1;
+}
+
 void seissol::Simulator::setCheckPointInterval( double i_checkPointInterval ) {
   assert( m_checkPointInterval > 0 );
   m_checkPointInterval = i_checkPointInterval;
 }
 
+void seissol::Simulator::setCheckPointMtbf( double i_checkPointMtbf ) {
+  assert( i_checkPointMtbf >= 0 );
+  m_checkPointMtbf = i_checkPointMtbf;
+}
+
+void seissol::Simulator::adaptCheckPointInterval( double i_simulationWallTime ) {
+  // time blocked by the last finished checkpoint (maximum over all ranks)
+  double l_cost = seissol::SeisSol::main.checkPointManager().telemetry().lastBlocked();
+
+#ifdef USE_MPI
+  // all ranks have to agree on the next synchronization point
+  MPI_Allreduce( MPI_IN_PLACE, &i_simulationWallTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+#endif // USE_MPI
+
+  // no measurements yet (e.g. first asynchronous checkpoint)
+  if( l_cost <= 0 || i_simulationWallTime <= 0 ) {
+    return;
+  }
+
+  // Young/Daly optimum in wall clock time
+  double l_wallInterval = m_checkPointMtbf;
+  if( l_cost < 0.5 * m_checkPointMtbf ) {
+    l_wallInterval = std::sqrt( 2.0 * l_cost * m_checkPointMtbf ) - l_cost;
+  }
+
+  // convert to simulated time using the measured simulation speed
+  double l_speed = m_checkPointInterval / i_simulationWallTime;
+  m_checkPointInterval = l_wallInterval * l_speed;
+
+  int l_rank = 0;
+#ifdef USE_MPI
+  MPI_Comm_rank( MPI_COMM_WORLD, &l_rank );
+#endif // USE_MPI
+  logInfo(l_rank) << "Adapted checkpoint interval:" << m_checkPointInterval
+                  << "(cost:" << l_cost << "s, wall clock interval:" << l_wallInterval << "s)";
+}
+
 void seissol::Simulator::setFinalTime( double i_finalTime ) {
   assert( i_finalTime > 0 );
   m_finalTime = i_finalTime;
@@ -88,12 +145,20 @@ void seissol::Simulator::simulate() {
   double l_timeTolerance = seissol::SeisSol::main.timeManager().getTimeTolerance();
 
   // Write initial wave field snapshot
-  if (m_currentTime == 0.0)
+  if (m_currentTime == 0.0) {
 	  seissol::SeisSol::main.waveFieldWriter().write(0.0);
+	  seissol::SeisSol::main.freeSurfaceWriter().write(0.0);
+  }
 
   // intialize wave field and checkpoint time
   m_waveFieldTime  = m_currentTime;
   m_checkPointTime = m_currentTime;
+  m_checkPointWallTime = seissol::monitoring::getWallTime();
+
+  // free surface output times are multiples of the interval (allows appending after restarts)
+  if( m_freeSurfaceInterval < std::numeric_limits< double >::max() ) {
+    m_freeSurfaceTime = std::floor( (m_currentTime + l_timeTolerance) / m_freeSurfaceInterval ) * m_freeSurfaceInterval;
+  }
 
   // start the communication thread (if applicable)
   seissol::SeisSol::main.timeManager().startCommunicationThread();
@@ -102,6 +167,7 @@ void seissol::Simulator::simulate() {
     // derive next synchronization time
     m_upcomingTime = m_finalTime;
     m_upcomingTime = std::min( m_upcomingTime, std::abs(m_waveFieldTime  + m_waveFieldInterval ) );
+    m_upcomingTime = std::min( m_upcomingTime, std::abs(m_freeSurfaceTime + m_freeSurfaceInterval) );
     m_upcomingTime = std::min( m_upcomingTime, std::abs(m_checkPointTime + m_checkPointInterval) );
 
     // update the DOFs
@@ -116,14 +182,27 @@ void seissol::Simulator::simulate() {
       m_waveFieldTime += m_waveFieldInterval;
     }
 
+    // write free surface output if required
+    if( std::abs( m_currentTime - ( m_freeSurfaceTime + m_freeSurfaceInterval) ) < l_timeTolerance ) {
+      seissol::SeisSol::main.freeSurfaceWriter().write(m_currentTime);
+      m_freeSurfaceTime += m_freeSurfaceInterval;
+    }
+
     // write checkpoint if required
     if( std::abs( m_currentTime - ( m_checkPointTime + m_checkPointInterval ) ) < l_timeTolerance ) {
 		int waveFieldTimeStep = seissol::SeisSol::main.waveFieldWriter().timestep();
 		int faultTimeStep;
 		e_interoperability.getDynamicRuptureTimeStep(faultTimeStep);
 
+      double l_writeStart = seissol::monitoring::getWallTime();
       seissol::SeisSol::main.checkPointManager().write(m_currentTime, waveFieldTimeStep, faultTimeStep);
       m_checkPointTime += m_checkPointInterval;
+
+      // choose the next interval from the measured checkpoint cost
+      if( m_checkPointMtbf > 0 ) {
+        adaptCheckPointInterval( l_writeStart - m_checkPointWallTime );
+      }
+      m_checkPointWallTime = seissol::monitoring::getWallTime();
     }
   }
 
@@ -65,12 +65,24 @@ class seissol::Simulator {
     //! time interval of the wave field output
     double m_waveFieldInterval;
 
+    //! last time the free surface was written
+    double m_freeSurfaceTime;
+
+    //! time interval of the free surface output
+    double m_freeSurfaceInterval;
+
     //! last time a checkpoint was written
     double m_checkPointTime;
  
     //! time interval of the checkpoints
     double m_checkPointInterval;
 
+    //! mean time between failures in wall clock seconds (0 = fixed checkpoint interval)
+    double m_checkPointMtbf;
+
+    //! wall clock time when the last checkpoint was finished
+    double m_checkPointWallTime;
+
     //! If true, a checkpoint is loaded before the simulation
     bool m_loadCheckPoint;
 
@@ -109,6 +121,19 @@ class seissol::Simulator {
      **/
     void setWaveFieldInterval( double i_waveFieldInterval );
 
+    /**
+     * Sets the interval for the free surface output.
+     *
+     * @param i_freeSurfaceInterval free surface interval.
+     **/
+    void setFreeSurfaceInterval( double i_freeSurfaceInterval );
+
+    /**
+     * Gets the number of free surface outputs written until the current time.
+     * The output times are multiples of the interval.
+     **/
+    int getFreeSurfaceTimeStep() const;
+
     /**
      * Sets the interval for checkpointing.
      *
@@ -116,10 +141,28 @@ class seissol::Simulator {
      **/
     void setCheckPointInterval( double i_checkPointInterval );
 
+    /**
+     * Sets the mean time between failures for adaptive checkpointing.
+     * If positive, the checkpoint interval is recomputed after each checkpoint
+     * from the measured checkpoint cost and simulation speed (Young/Daly optimum).
+     * The interval set by setCheckPointInterval() is only used until the first checkpoint.
+     *
+     * @param i_checkPointMtbf mean time between failures in wall clock seconds.
+     **/
+    void setCheckPointMtbf( double i_checkPointMtbf );
+
     /**
      * Simulates until finished.
      **/
     void simulate();
+
+  private:
+    /**
+     * Computes the next checkpoint interval from the cost of the last checkpoint.
+     *
+     * @param i_simulationWallTime wall clock time spent in the simulation since the last checkpoint.
+     **/
+    void adaptCheckPointInterval( double i_simulationWallTime );
 };
 
 #endif
@@ -154,19 +154,37 @@ module f_ftoc_bind_interoperability
   end interface
 
   interface
-    subroutine c_interoperability_enableWaveFieldOutput( i_waveFieldInterval, i_waveFieldFilename ) bind( C, name='c_interoperability_enableWaveFieldOutput' )
-      use iso_c_binding, only: c_ptr, c_char
+    subroutine c_interoperability_enableWaveFieldOutput( i_waveFieldInterval, i_waveFieldFilename, i_waveFieldRefinement, &
+                                                         i_outputMask, i_outputRegion, i_outputRegionBounds, &
+                                                         i_compressionMode, i_compressionTolerance ) bind( C, name='c_interoperability_enableWaveFieldOutput' )
+      use iso_c_binding, only: c_ptr, c_char, c_int
       implicit none
       type(c_ptr), value :: i_waveFieldInterval
       character(kind=c_char), dimension(*), intent(in) :: i_waveFieldFilename
+      type(c_ptr), value :: i_waveFieldRefinement
+      integer(kind=c_int), dimension(*), intent(in) :: i_outputMask
+      type(c_ptr), value :: i_outputRegion
+      type(c_ptr), value :: i_outputRegionBounds
+      type(c_ptr), value :: i_compressionMode
+      type(c_ptr), value :: i_compressionTolerance
+    end subroutine
+  end interface
+
+  interface
+    subroutine c_interoperability_enableFreeSurfaceOutput( i_freeSurfaceInterval, i_freeSurfaceFilename ) bind( C, name='c_interoperability_enableFreeSurfaceOutput' )
+      use iso_c_binding, only: c_ptr, c_char
+      implicit none
+      type(c_ptr), value :: i_freeSurfaceInterval
+      character(kind=c_char), dimension(*), intent(in) :: i_freeSurfaceFilename
     end subroutine
   end interface
 
   interface
-    subroutine c_interoperability_enableCheckPointing( i_checkPointInterval, i_checkPointFilename, i_checkPointBackend ) bind( C, name='c_interoperability_enableCheckPointing' )
+    subroutine c_interoperability_enableCheckPointing( i_checkPointInterval, i_checkPointMtbf, i_checkPointFilename, i_checkPointBackend ) bind( C, name='c_interoperability_enableCheckPointing' )
       use iso_c_binding, only: c_ptr, c_char
       implicit none
       type(c_ptr), value :: i_checkPointInterval
+      type(c_ptr), value :: i_checkPointMtbf
       character(kind=c_char), dimension(*), intent(in) :: i_checkPointFilename
       character(kind=c_char), dimension(*), intent(in) :: i_checkPointBackend
     end subroutine
@@ -43,15 +43,11 @@
 #endif
 
 #include "TimeCluster.h"
+#include <SeisSol.h>
 #include <Solver/Interoperability.h>
 #include <Physics/PointSource.h>
 
-#ifndef NDEBUG
-extern long long g_SeisSolNonZeroFlopsLocal;
-extern long long g_SeisSolHardwareFlopsLocal;
-extern long long g_SeisSolNonZeroFlopsNeighbor;
-extern long long g_SeisSolHardwareFlopsNeighbor;
-#endif
+#include <Monitoring/FlopCounter.hpp>
 
 #include <cstring>
 
@@ -144,6 +140,21 @@ seissol::time_stepping::TimeCluster::TimeCluster( unsigned int
 
   // disable dynamic rupture by default
   m_dynamicRuptureFaces = false;
+
+  // derive flops and bytes of the layers
+  for( unsigned int l_phase = 0; l_phase < 4; l_phase++ ) {
+    m_nonZeroFlops[l_phase] = m_hardwareFlops[l_phase] = m_bytes[l_phase] = 0;
+  }
+#ifdef USE_MPI
+  computeFlopsAndBytes( m_meshStructure->numberOfCopyCells,
+                        m_copyCellInformation,
+                        monitoring::localCopyPhase,
+                        monitoring::neighboringCopyPhase );
+#endif
+  computeFlopsAndBytes( m_meshStructure->numberOfInteriorCells,
+                        m_interiorCellInformation,
+                        monitoring::localInteriorPhase,
+                        monitoring::neighboringInteriorPhase );
 }
 
 seissol::time_stepping::TimeCluster::~TimeCluster() {  
@@ -152,6 +163,56 @@ seissol::time_stepping::TimeCluster::~TimeCluster() {
 #endif
 }
 
+void seissol::time_stepping::TimeCluster::computeFlopsAndBytes( unsigned int                i_numberOfCells,
+                                                                const CellLocalInformation *i_cellInformation,
+                                                                monitoring::Phase           i_localPhase,
+                                                                monitoring::Phase           i_neighboringPhase ) {
+  unsigned int l_nonZeroFlops, l_hardwareFlops;
+
+  // element-local kernels independent of the cell
+  unsigned long long l_cellNonZeroFlops = 0, l_cellHardwareFlops = 0;
+  l_nonZeroFlops = l_hardwareFlops = 0;
+  m_timeKernel.flopsAder( l_nonZeroFlops, l_hardwareFlops );
+  l_cellNonZeroFlops += l_nonZeroFlops; l_cellHardwareFlops += l_hardwareFlops;
+  l_nonZeroFlops = l_hardwareFlops = 0;
+  m_volumeKernel.flopsIntegral( l_nonZeroFlops, l_hardwareFlops );
+  l_cellNonZeroFlops += l_nonZeroFlops; l_cellHardwareFlops += l_hardwareFlops;
+
+  for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
+    unsigned short l_ltsSetup = i_cellInformation[l_cell].ltsSetup;
+
+    /*
+     * local integration: DOFs (read & write), local integration data, buffers and derivatives (write)
+     */
+    m_nonZeroFlops[i_localPhase]  += l_cellNonZeroFlops;
+    m_hardwareFlops[i_localPhase] += l_cellHardwareFlops;
+    m_boundaryKernel.flopsLocalIntegral( i_cellInformation[l_cell].faceTypes, l_nonZeroFlops, l_hardwareFlops );
+    m_nonZeroFlops[i_localPhase]  += l_nonZeroFlops;
+    m_hardwareFlops[i_localPhase] += l_hardwareFlops;
+
+    m_bytes[i_localPhase] += 2 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + sizeof(LocalIntegrationData);
+    if( (l_ltsSetup >> 8) % 2 == 1 ) m_bytes[i_localPhase] += NUMBER_OF_ALIGNED_DOFS * sizeof(real);
+    if( (l_ltsSetup >> 9) % 2 == 1 ) m_bytes[i_localPhase] += NUMBER_OF_ALIGNED_DERS * sizeof(real);
+
+    /*
+     * neighboring integration: DOFs (read & write), neighboring integration data, buffers or derivatives of the face-neighbors (read)
+     */
+    m_boundaryKernel.flopsNeighborsIntegral( i_cellInformation[l_cell].faceTypes,
+                                             i_cellInformation[l_cell].faceRelations,
+                                             l_nonZeroFlops,
+                                             l_hardwareFlops );
+    m_nonZeroFlops[i_neighboringPhase]  += l_nonZeroFlops;
+    m_hardwareFlops[i_neighboringPhase] += l_hardwareFlops;
+
+    m_bytes[i_neighboringPhase] += 2 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + sizeof(NeighboringIntegrationData);
+    for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+      if( i_cellInformation[l_cell].faceTypes[l_face] != outflow && i_cellInformation[l_cell].faceTypes[l_face] != dynamicRupture ) {
+        m_bytes[i_neighboringPhase] += ( (l_ltsSetup >> l_face) % 2 == 1 ? NUMBER_OF_ALIGNED_DERS : NUMBER_OF_ALIGNED_DOFS ) * sizeof(real);
+      }
+    }
+  }
+}
+
 void seissol::time_stepping::TimeCluster::setPointSources( CellToPointSourcesMapping* i_cellToPointSources,
                                                            unsigned i_numberOfCellToPointSourcesMappings,
                                                            PointSources* i_pointSources )
@@ -177,10 +238,12 @@ void seissol::time_stepping::TimeCluster::writeReceivers() {
   if( m_receivers.size() > 0 && m_fullUpdateTime + m_timeStepWidth > m_receiverTime ) {
     logDebug() << "cluster" << m_clusterId << "is writing a total of" << m_receivers.size() << "receivers at time" << m_receiverTime;
 
+    m_phaseStatistics.start( monitoring::receiversPhase );
     e_interoperability.writeReceivers( m_fullUpdateTime,
                                        m_timeStepWidth,
                                        m_receiverTime,
                                        m_receivers );
+    m_phaseStatistics.stop( m_receivers.size() );
 
     // increase receiver time until larger than next update time
     while( m_fullUpdateTime + m_timeStepWidth > m_receiverTime ) {
@@ -199,6 +262,7 @@ void seissol::time_stepping::TimeCluster::computeSources() {
   // Return when point sources not initialised. This might happen if there
   // are no point sources on this rank.
   if (m_numberOfCellToPointSourcesMappings != 0) {
+    m_phaseStatistics.start( monitoring::sourcesPhase );
 #ifdef _OPENMP
   #pragma omp parallel for schedule(static)
 #endif
@@ -225,6 +289,7 @@ void seissol::time_stepping::TimeCluster::computeSources() {
 #endif
       }
     }
+    m_phaseStatistics.stop( m_numberOfCellToPointSourcesMappings );
   }
 }
 
@@ -232,6 +297,11 @@ void seissol::time_stepping::TimeCluster::computeDynamicRupture() {
   SCOREP_USER_REGION( "computeDynamicRupture", SCOREP_USER_REGION_TYPE_FUNCTION )
 
   if( m_dynamicRuptureFaces == true ) {
+    m_phaseStatistics.start( monitoring::dynamicRupturePhase );
+
+    // dynamic rupture updates DOFs of arbitrary cells
+    seissol::SeisSol::main.checkPointManager().prepareUpdateAll();
+
     e_interoperability.computeDynamicRupture( m_fullUpdateTime,
                                               m_timeStepWidth );
 
@@ -239,6 +309,7 @@ void seissol::time_stepping::TimeCluster::computeDynamicRupture() {
     // TODO: This is not optimal as we are syncing all copy layers
     e_interoperability.synchronizeCopyLayerDofs();
 #endif
+    m_phaseStatistics.stop( 1 );
   }
 }
 
@@ -432,44 +503,6 @@ void seissol::time_stepping::TimeCluster::computeLocalIntegration( unsigned int
                                            io_dofs[l_cell] );
 #endif
 
-#ifndef NDEBUG
-    unsigned int l_tempHardwareFlops = 0;
-    unsigned int l_tempNonZeroFlops = 0;
-    m_timeKernel.flopsAder(              l_tempNonZeroFlops,
-                                         l_tempHardwareFlops);
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolNonZeroFlopsLocal += (long long)l_tempNonZeroFlops;
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolHardwareFlopsLocal += (long long)l_tempHardwareFlops;
-    
-    m_volumeKernel.flopsIntegral(        l_tempNonZeroFlops,
-                                         l_tempHardwareFlops);
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolNonZeroFlopsLocal += (long long)l_tempNonZeroFlops;
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolHardwareFlopsLocal += (long long)l_tempHardwareFlops;
-
-    m_boundaryKernel.flopsLocalIntegral( i_cellInformation[l_cell].faceTypes, 
-                                         l_tempNonZeroFlops,
-                                         l_tempHardwareFlops);
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolNonZeroFlopsLocal += (long long)l_tempNonZeroFlops;
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolHardwareFlopsLocal += (long long)l_tempHardwareFlops;
-#endif
-
     // update lts buffers if required
     // TODO: Integrate this step into the kernel
     if( !l_resetBuffers && l_buffersProvided ) {
@@ -483,13 +516,42 @@ void seissol::time_stepping::TimeCluster::computeLocalIntegration( unsigned int
   }
 }
 
+void seissol::time_stepping::TimeCluster::computeSharedTimeIntegration( TimeIntegrationScratch &io_scratch ) {
+  SCOREP_USER_REGION( "computeSharedTimeIntegration", SCOREP_USER_REGION_TYPE_FUNCTION )
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for( unsigned int l_derivative = 0; l_derivative < io_scratch.numberOfDerivatives; l_derivative++ ) {
+    // GTS: expansion point at the start of the time step, LTS: common point zero
+    double l_expansionPoint = io_scratch.gts[l_derivative] ? m_subTimeStart : 0;
+
+    m_timeKernel.computeIntegral( l_expansionPoint,
+                                  m_subTimeStart,
+                                  m_subTimeStart + m_timeStepWidth,
+                                  io_scratch.derivatives[l_derivative],
+                                  io_scratch.timeIntegrated[l_derivative] );
+  }
+}
+
 void seissol::time_stepping::TimeCluster::computeNeighboringIntegration( unsigned int            i_numberOfCells,
                                                                          CellLocalInformation   *i_cellInformation,
                                                                          CellData               *i_cellData,
                                                                          real                 *(*i_faceNeighbors)[4],
+                                                                         TimeIntegrationScratch &io_scratch,
                                                                          real                  (*io_dofs)[NUMBER_OF_ALIGNED_DOFS] ) {
   SCOREP_USER_REGION( "computeNeighboringIntegration", SCOREP_USER_REGION_TYPE_FUNCTION )
 
+  // mask of the LTS setup: derivatives in the shared scratch are integrated already (bits 0-3)
+  unsigned short l_ltsSetupMask = 0xFFFF;
+
+  if( io_scratch.numberOfDerivatives > 0 ) {
+    computeSharedTimeIntegration( io_scratch );
+
+    i_faceNeighbors = io_scratch.faceNeighbors;
+    l_ltsSetupMask  = 0xFFF0;
+  }
+
   real  l_integrationBuffer[4][NUMBER_OF_ALIGNED_DOFS] __attribute__((aligned(PAGESIZE_STACK)));
   real *l_timeIntegrated[4];
 #ifdef ENABLE_MATRIX_PREFETCH
@@ -505,7 +567,7 @@ void seissol::time_stepping::TimeCluster::computeNeighboringIntegration( unsigne
 #endif
 #endif
   for( int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
-    m_timeKernel.computeIntegrals(             i_cellInformation[l_cell].ltsSetup,
+    m_timeKernel.computeIntegrals(             i_cellInformation[l_cell].ltsSetup & l_ltsSetupMask,
                                                i_cellInformation[l_cell].faceTypes,
                                                m_subTimeStart,
                                                m_timeStepWidth,
@@ -565,23 +627,6 @@ void seissol::time_stepping::TimeCluster::computeNeighboringIntegration( unsigne
                                          i_cellData->neighboringIntegration[l_cell].initialLoading,
                                          io_dofs[l_cell] );
 #endif
-
-#ifndef NDEBUG
-    unsigned int l_tempHardwareFlops = 0;
-    unsigned int l_tempNonZeroFlops = 0;
-    m_boundaryKernel.flopsNeighborsIntegral( i_cellInformation[l_cell].faceTypes,
-                                             i_cellInformation[l_cell].faceRelations,
-                                             l_tempNonZeroFlops,
-                                             l_tempHardwareFlops);
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolNonZeroFlopsNeighbor += (long long)l_tempNonZeroFlops;
-#ifdef _OPENMP
-    #pragma omp atomic
-#endif
-    g_SeisSolHardwareFlopsNeighbor += (long long)l_tempHardwareFlops;
-#endif
   }
 }
 
@@ -597,7 +642,12 @@ bool seissol::time_stepping::TimeCluster::computeLocalCopy(){
   }
 
   // continue only if copy layer sends are complete
-  if( !testForCopyLayerSends() ) return false;
+  if( !testForCopyLayerSends() ) {
+    m_phaseStatistics.wait( monitoring::localCopyPhase );
+    return false;
+  }
+  m_phaseStatistics.proceed( monitoring::localCopyPhase );
+  m_phaseStatistics.start(   monitoring::localCopyPhase );
 
   // post receive requests
 #if defined(_OPENMP) && defined(USE_COMM_THREAD)
@@ -609,6 +659,10 @@ bool seissol::time_stepping::TimeCluster::computeLocalCopy(){
   // MPI checks for receiver writes receivers either in the copy layer or interior
   if( m_updatable.localInterior ) writeReceivers();
 
+  // asynchronous checkpoints have to save the DOFs before they are modified
+  seissol::SeisSol::main.checkPointManager().prepareUpdate( m_cells->copyDofs[0],
+                                                            m_meshStructure->numberOfCopyCells * NUMBER_OF_ALIGNED_DOFS );
+
   // integrate copy layer locally
   computeLocalIntegration( m_meshStructure->numberOfCopyCells,
                            m_copyCellInformation,
@@ -642,6 +696,13 @@ bool seissol::time_stepping::TimeCluster::computeLocalCopy(){
   waitForInits();
 #endif
 
+  g_SeisSolNonZeroFlopsLocal  += m_nonZeroFlops[ monitoring::localCopyPhase];
+  g_SeisSolHardwareFlopsLocal += m_hardwareFlops[monitoring::localCopyPhase];
+  m_phaseStatistics.stop( m_meshStructure->numberOfCopyCells,
+                          m_nonZeroFlops[ monitoring::localCopyPhase],
+                          m_hardwareFlops[monitoring::localCopyPhase],
+                          m_bytes[        monitoring::localCopyPhase] );
+
   return true;
 }
 #endif
@@ -656,6 +717,8 @@ void seissol::time_stepping::TimeCluster::computeLocalInterior(){
       << m_fullUpdateTime << m_predictionTime << m_timeStepWidth   << m_subTimeStart      << m_resetLtsBuffers;
   }
 
+  m_phaseStatistics.start( monitoring::localInteriorPhase );
+
   // MPI checks for receiver writes receivers either in the copy layer or interior
 #ifdef USE_MPI
   if( m_updatable.localCopy ) writeReceivers();
@@ -664,6 +727,10 @@ void seissol::time_stepping::TimeCluster::computeLocalInterior(){
   writeReceivers();
 #endif
 
+  // asynchronous checkpoints have to save the DOFs before they are modified
+  seissol::SeisSol::main.checkPointManager().prepareUpdate( m_cells->interiorDofs[0],
+                                                            m_meshStructure->numberOfInteriorCells * NUMBER_OF_ALIGNED_DOFS );
+
   // integrate interior cells locally
   computeLocalIntegration( m_meshStructure->numberOfInteriorCells,
                            m_interiorCellInformation,
@@ -688,6 +755,13 @@ void seissol::time_stepping::TimeCluster::computeLocalInterior(){
 
   // update finished
   m_updatable.localInterior = false;
+
+  g_SeisSolNonZeroFlopsLocal  += m_nonZeroFlops[ monitoring::localInteriorPhase];
+  g_SeisSolHardwareFlopsLocal += m_hardwareFlops[monitoring::localInteriorPhase];
+  m_phaseStatistics.stop( m_meshStructure->numberOfInteriorCells,
+                          m_nonZeroFlops[ monitoring::localInteriorPhase],
+                          m_hardwareFlops[monitoring::localInteriorPhase],
+                          m_bytes[        monitoring::localInteriorPhase] );
 }
 
 #ifdef USE_MPI
@@ -702,7 +776,12 @@ bool seissol::time_stepping::TimeCluster::computeNeighboringCopy() {
   }
 
   // continue only of ghost layer receives are complete
-  if( !testForGhostLayerReceives() ) return false;
+  if( !testForGhostLayerReceives() ) {
+    m_phaseStatistics.wait( monitoring::neighboringCopyPhase );
+    return false;
+  }
+  m_phaseStatistics.proceed( monitoring::neighboringCopyPhase );
+  m_phaseStatistics.start(   monitoring::neighboringCopyPhase );
 
 #ifndef USE_COMM_THREAD
   // continue with communication
@@ -713,6 +792,7 @@ bool seissol::time_stepping::TimeCluster::computeNeighboringCopy() {
                                  m_copyCellInformation,
                                  m_copyCellData,
                                  m_cells->copyFaceNeighbors,
+                                 m_cells->copyScratch,
                                  m_cells->copyDofs );
 
 #ifndef USE_COMM_THREAD
@@ -732,6 +812,13 @@ bool seissol::time_stepping::TimeCluster::computeNeighboringCopy() {
   // update finished
   m_updatable.neighboringCopy = false;
 
+  g_SeisSolNonZeroFlopsNeighbor  += m_nonZeroFlops[ monitoring::neighboringCopyPhase];
+  g_SeisSolHardwareFlopsNeighbor += m_hardwareFlops[monitoring::neighboringCopyPhase];
+  m_phaseStatistics.stop( m_meshStructure->numberOfCopyCells,
+                          m_nonZeroFlops[ monitoring::neighboringCopyPhase],
+                          m_hardwareFlops[monitoring::neighboringCopyPhase],
+                          m_bytes[        monitoring::neighboringCopyPhase] );
+
   return true;
 }
 #endif
@@ -746,11 +833,14 @@ void seissol::time_stepping::TimeCluster::computeNeighboringInterior() {
       << m_fullUpdateTime << m_predictionTime << m_timeStepWidth   << m_subTimeStart      << m_resetLtsBuffers;
   }
 
+  m_phaseStatistics.start( monitoring::neighboringInteriorPhase );
+
   // Update all cells in the interior with the neighboring boundary contribution.
   computeNeighboringIntegration( m_meshStructure->numberOfInteriorCells,
                                  m_interiorCellInformation,
                                  m_interiorCellData,
                                  m_cells->interiorFaceNeighbors,
+                                 m_cells->interiorScratch,
                                  m_cells->interiorDofs );
 
   // compute dynamic rupture, update simulation time and statistics
@@ -764,6 +854,13 @@ void seissol::time_stepping::TimeCluster::computeNeighboringInterior() {
 
   // update finished
   m_updatable.neighboringInterior = false;
+
+  g_SeisSolNonZeroFlopsNeighbor  += m_nonZeroFlops[ monitoring::neighboringInteriorPhase];
+  g_SeisSolHardwareFlopsNeighbor += m_hardwareFlops[monitoring::neighboringInteriorPhase];
+  m_phaseStatistics.stop( m_meshStructure->numberOfInteriorCells,
+                          m_nonZeroFlops[ monitoring::neighboringInteriorPhase],
+                          m_hardwareFlops[monitoring::neighboringInteriorPhase],
+                          m_bytes[        monitoring::neighboringInteriorPhase] );
 }
 
 #if defined(_OPENMP) && defined(USE_MPI) && defined(USE_COMM_THREAD)
@@ -51,6 +51,7 @@
 #include <Kernels/Time.h>
 #include <Kernels/Volume.h>
 #include <Kernels/Boundary.h>
+#include <Monitoring/PhaseStatistics.hpp>
 #ifdef REQUIRE_SOURCE_MATRIX
 #include <Kernels/Source.h>
 #endif
@@ -142,6 +143,32 @@ class seissol::time_stepping::TimeCluster {
     //! true if dynamic rupture faces are present
     bool m_dynamicRuptureFaces;
 
+    /*
+     * Precomputed counters of a single update of the layers, indexed by the phase (local/neighboring copy/interior).
+     */
+    //! non-zero floating point operations
+    unsigned long long m_nonZeroFlops[4];
+
+    //! floating point operations in hardware
+    unsigned long long m_hardwareFlops[4];
+
+    //! transferred bytes (estimate based on the accessed cell data)
+    unsigned long long m_bytes[4];
+
+    /**
+     * Derives the floating point operations and bytes of the local and neighboring integration of a layer.
+     * The counts depend only on the face types and LTS setups of the cells and are computed once.
+     *
+     * @param i_numberOfCells number of cells in the layer.
+     * @param i_cellInformation cell local information of the cells.
+     * @param i_localPhase phase of the local integration.
+     * @param i_neighboringPhase phase of the neighboring integration.
+     **/
+    void computeFlopsAndBytes( unsigned int                i_numberOfCells,
+                               const CellLocalInformation *i_cellInformation,
+                               monitoring::Phase           i_localPhase,
+                               monitoring::Phase           i_neighboringPhase );
+
 #ifdef USE_MPI
     /**
      * Receives the copy layer data from relevant neighboring MPI clusters.
@@ -221,6 +248,13 @@ class seissol::time_stepping::TimeCluster {
                                   real                 **io_derivatives,
                                   real                 (*io_dofs)[NUMBER_OF_ALIGNED_DOFS] );
 
+    /**
+     * Integrates all face-neighboring derivatives of the shared scratch in time.
+     *
+     * @param io_scratch shared time integration scratch.
+     **/
+    void computeSharedTimeIntegration( TimeIntegrationScratch &io_scratch );
+
     /**
      * Computes the contribution of the neighboring cells to the boundary integral.
      *
@@ -231,12 +265,14 @@ class seissol::time_stepping::TimeCluster {
      * @param i_cellInformation cell local information.
      * @param i_cellData cell data.
      * @param i_faceNeighbors pointers to neighboring time buffers or derivatives.
+     * @param io_scratch shared time integration scratch; used instead of the per-face integration if enabled.
      * @param io_dofs degrees of freedom.
      **/
     void computeNeighboringIntegration( unsigned int            i_numberOfCells,
                                         CellLocalInformation   *i_cellInformation,
                                         CellData               *i_cellData,
                                         real                 *(*i_faceNeighbors)[4],
+                                        TimeIntegrationScratch &io_scratch,
                                         real                  (*io_dofs)[NUMBER_OF_ALIGNED_DOFS] );
 
   public:
@@ -298,6 +334,9 @@ class seissol::time_stepping::TimeCluster {
     //! time of the next receiver output
     double m_receiverTime;
 
+    //! per-phase timing and update statistics since the last synchronization
+    monitoring::PhaseStatistics m_phaseStatistics;
+
     /**
      * Constructs a new LTS cluster.
      *
@@ -40,6 +40,7 @@
 #include "TimeManager.h"
 
 #include "SeisSol.h"
+#include <utils/env.h>
 #include <Initializer/preProcessorMacros.fpp>
 #include <Initializer/time_stepping/common.hpp>
 
@@ -58,6 +59,8 @@ pthread_t g_commThread;
 seissol::time_stepping::TimeManager::TimeManager():
   m_mpiRank(0),
   m_logUpdates(std::numeric_limits<unsigned int>::max()),
+  m_reportImbalance( utils::Env::get<int>( "SEISSOL_IMBALANCE_REPORT", 0 ) != 0 ),
+  m_reportPerformance( utils::Env::get<int>( "SEISSOL_PERFORMANCE_REPORT", 0 ) != 0 ),
   m_xmlParser(            MATRIXXMLFILE   ),
   m_memoryManager(        m_xmlParser     ) {
 }
@@ -392,6 +395,37 @@ void seissol::time_stepping::TimeManager::advanceInTime( const double &i_synchro
                          << " @ "                       << m_clusters[m_timeStepping.numberOfLocalClusters-1]->m_fullUpdateTime;
     }
   }
+
+  // print the load imbalance and performance of the clusters
+  reportStatistics();
+}
+
+void seissol::time_stepping::TimeManager::reportStatistics() {
+  SCOREP_USER_REGION( "reportStatistics", SCOREP_USER_REGION_TYPE_FUNCTION )
+
+  std::vector< unsigned int > l_globalClusterIds;
+  std::vector< const monitoring::PhaseStatistics* > l_statistics;
+
+  for( unsigned int l_cluster = 0; l_cluster < m_timeStepping.numberOfLocalClusters; l_cluster++ ) {
+    l_globalClusterIds.push_back( m_clusters[l_cluster]->m_globalClusterId );
+    l_statistics.push_back( &m_clusters[l_cluster]->m_phaseStatistics );
+  }
+
+  if( m_reportImbalance ) {
+    monitoring::reportImbalance( m_timeStepping.numberOfGlobalClusters,
+                                 l_globalClusterIds,
+                                 l_statistics );
+  }
+
+  if( m_reportPerformance ) {
+    monitoring::reportPerformance( m_timeStepping.numberOfGlobalClusters,
+                                   l_globalClusterIds,
+                                   l_statistics );
+  }
+
+  for( unsigned int l_cluster = 0; l_cluster < m_timeStepping.numberOfLocalClusters; l_cluster++ ) {
+    m_clusters[l_cluster]->m_phaseStatistics.reset();
+  }
 }
 
 double seissol::time_stepping::TimeManager::getTimeTolerance() {
@@ -92,6 +92,12 @@ class seissol::time_stepping::TimeManager {
     //! last #updates of log
     unsigned int m_logUpdates;
 
+    //! true if a load imbalance report is printed at synchronization points (opt-in via SEISSOL_IMBALANCE_REPORT)
+    bool m_reportImbalance;
+
+    //! true if a performance report (GFLOP/s, GB/s) is printed at synchronization points (opt-in via SEISSOL_PERFORMANCE_REPORT)
+    bool m_reportPerformance;
+
     //! time stepping
     TimeStepping m_timeStepping;
 
@@ -135,6 +141,11 @@ class seissol::time_stepping::TimeManager {
      **/
     void updateClusterDependencies( unsigned int i_localClusterId );
 
+    /**
+     * Prints the MPI-reduced per-phase load imbalance and the performance of all clusters and resets the statistics.
+     **/
+    void reportStatistics();
+
   public:
     /**
      * Construct a new time manager.
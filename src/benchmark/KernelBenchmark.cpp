@@ -0,0 +1,528 @@
+/**
+ * @file
+ * This file is part of SeisSol.
+ *
+ * @section LICENSE
+ * Copyright (c) 2015, SeisSol Group
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Standalone micro-benchmark of the time, volume and boundary kernels.
+ *
+ * The benchmark sets up a synthetic cluster with random global matrices, star matrices and flux solvers.
+ * Face types, face relations and the LTS setup (buffers/derivatives of the face-neighbors) are mixed randomly.
+ * Order, precision and architecture are fixed at compile time; one build per configuration is required.
+ *
+ * Environment variables:
+ *   SEISSOL_BENCHMARK_CELLS           number of cells (default 10000)
+ *   SEISSOL_BENCHMARK_REPETITIONS     number of timed repetitions (default 10)
+ *   SEISSOL_BENCHMARK_DERIVATIVES     fraction of regular faces, which get derivatives of the face-neighbor (default 0.25)
+ *   SEISSOL_BENCHMARK_FREE_SURFACE    fraction of free surface faces (default 0.05)
+ *   SEISSOL_BENCHMARK_RUPTURE         fraction of dynamic rupture faces (default 0.01)
+ *   SEISSOL_BENCHMARK_SEED            seed of the random number generator (default 1)
+ **/
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <utils/env.h>
+#include <utils/logger.h>
+
+#include <Initializer/typedefs.hpp>
+#include <Kernels/Time.h>
+#include <Kernels/Volume.h>
+#include <Kernels/Boundary.h>
+#include <Monitoring/PhaseStatistics.hpp>
+
+#ifndef NDEBUG
+// counted by the generated kernels in debug builds; Monitoring/FlopCounter.cpp is not linked into the benchmark
+long long libxsmm_num_total_flops = 0;
+#endif
+
+namespace seissol {
+  namespace benchmark {
+    //! benchmarked kernels
+    enum Kernel {
+      aderKernel = 0,
+      timeIntegralKernel,
+      volumeKernel,
+      localBoundaryKernel,
+      timeIntegralsKernel,
+      neighborsBoundaryKernel,
+      numberOfKernels
+    };
+
+    //! names of the benchmarked kernels
+    static const char* const c_kernelNames[numberOfKernels] = { "computeAder",
+                                                                 "computeIntegral",
+                                                                 "Volume::computeIntegral",
+                                                                 "computeLocalIntegral",
+                                                                 "computeIntegrals",
+                                                                 "computeNeighborsIntegral" };
+
+    /**
+     * Synthetic cluster of cells.
+     **/
+    struct Cluster {
+      //! number of cells
+      unsigned int numberOfCells;
+
+      //! cell information (face types, face relations, lts setup)
+      CellLocalInformation *cellInformation;
+
+      //! star matrices and flux solvers
+      LocalIntegrationData *localIntegration;
+      NeighboringIntegrationData *neighboringIntegration;
+
+      //! degrees of freedom and the pristine copy used to reset them
+      real (*dofs)[NUMBER_OF_ALIGNED_DOFS];
+      real (*initialDofs)[NUMBER_OF_ALIGNED_DOFS];
+
+      //! time integrated degrees of freedom and time derivatives
+      real (*buffers)[NUMBER_OF_ALIGNED_DOFS];
+      real (*derivatives)[NUMBER_OF_ALIGNED_DERS];
+
+      //! buffers or derivatives of the face-neighbors as used by the time integration
+      real *(*faceNeighbors)[4];
+
+      //! time integrated degrees of freedom of the face-neighbors as used by the neighboring boundary integration
+      real *(*timeIntegrated)[4];
+    };
+
+    /**
+     * Allocates aligned memory.
+     *
+     * @param i_size size in bytes.
+     * @return pointer to the memory.
+     **/
+    static void* allocate( size_t i_size ) {
+      void *l_pointer;
+      if( posix_memalign( &l_pointer, PAGESIZE_HEAP, i_size ) != 0 ) {
+        logError() << "could not allocate" << i_size << "bytes";
+      }
+      return l_pointer;
+    }
+
+    /**
+     * Fills the given array with random numbers in [-i_scale, i_scale].
+     **/
+    static void fillRandom( real *o_array, size_t i_size, double i_scale ) {
+      for( size_t l_entry = 0; l_entry < i_size; l_entry++ ) {
+        o_array[l_entry] = (real) ( i_scale * ( 2.0 * rand() / RAND_MAX - 1.0 ) );
+      }
+    }
+
+    /**
+     * Returns true with the given probability.
+     **/
+    static bool draw( double i_probability ) {
+      return rand() < i_probability * RAND_MAX;
+    }
+
+    /**
+     * Derives the number of flops of the time integration of the derivatives, which has no flop function of its own.
+     **/
+    static void flopsTimeIntegral( unsigned int &o_nonZeroFlops,
+                                   unsigned int &o_hardwareFlops ) {
+      o_nonZeroFlops = o_hardwareFlops = 0;
+      for( unsigned int l_derivative = 0; l_derivative < CONVERGENCE_ORDER; l_derivative++ ) {
+        o_nonZeroFlops  += 2 * NUMBER_OF_QUANTITIES * seissol::kernels::getNumberOfBasisFunctions( CONVERGENCE_ORDER-l_derivative );
+        o_hardwareFlops += 2 * NUMBER_OF_QUANTITIES * seissol::kernels::getNumberOfAlignedBasisFunctions( CONVERGENCE_ORDER-l_derivative );
+      }
+    }
+
+    /**
+     * Sets up random global matrices.
+     * Dense storage is an upper bound for the sparse storage, thus every kernel finds enough data.
+     **/
+    static void initializeGlobalData( GlobalData &o_globalData ) {
+      const size_t l_matrixSize = NUMBER_OF_ALIGNED_BASIS_FUNCTIONS * NUMBER_OF_BASIS_FUNCTIONS;
+      real *l_matrices = (real*) allocate( (52+3+3) * l_matrixSize * sizeof(real) );
+      // scale the entries to keep the recursive derivative computation in a sane range
+      fillRandom( l_matrices, (52+3+3) * l_matrixSize, 1.0 / NUMBER_OF_BASIS_FUNCTIONS );
+
+      for( unsigned int l_matrix = 0; l_matrix < 52; l_matrix++ ) {
+        o_globalData.fluxMatrices[l_matrix] = l_matrices + l_matrix * l_matrixSize;
+      }
+      for( unsigned int l_matrix = 0; l_matrix < 3; l_matrix++ ) {
+        o_globalData.stiffnessMatrices[l_matrix]           = l_matrices + (52+l_matrix) * l_matrixSize;
+        o_globalData.stiffnessMatricesTransposed[l_matrix] = l_matrices + (55+l_matrix) * l_matrixSize;
+      }
+    }
+
+    /**
+     * Sets up a synthetic cluster.
+     *
+     * @param i_numberOfCells number of cells.
+     * @param i_derivativesRatio fraction of regular faces, which get derivatives of the face-neighbor.
+     * @param i_freeSurfaceRatio fraction of free surface faces.
+     * @param i_ruptureRatio fraction of dynamic rupture faces.
+     * @param o_cluster will be set to the cluster.
+     **/
+    static void initializeCluster( unsigned int  i_numberOfCells,
+                                   double        i_derivativesRatio,
+                                   double        i_freeSurfaceRatio,
+                                   double        i_ruptureRatio,
+                                   Cluster      &o_cluster ) {
+      o_cluster.numberOfCells          = i_numberOfCells;
+      o_cluster.cellInformation        = (CellLocalInformation*)       allocate( i_numberOfCells * sizeof(CellLocalInformation) );
+      o_cluster.localIntegration       = (LocalIntegrationData*)       allocate( i_numberOfCells * sizeof(LocalIntegrationData) );
+      o_cluster.neighboringIntegration = (NeighboringIntegrationData*) allocate( i_numberOfCells * sizeof(NeighboringIntegrationData) );
+      o_cluster.dofs           = (real (*)[NUMBER_OF_ALIGNED_DOFS]) allocate( i_numberOfCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real) );
+      o_cluster.initialDofs    = (real (*)[NUMBER_OF_ALIGNED_DOFS]) allocate( i_numberOfCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real) );
+      o_cluster.buffers        = (real (*)[NUMBER_OF_ALIGNED_DOFS]) allocate( i_numberOfCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real) );
+      o_cluster.derivatives    = (real (*)[NUMBER_OF_ALIGNED_DERS]) allocate( i_numberOfCells * NUMBER_OF_ALIGNED_DERS * sizeof(real) );
+      o_cluster.faceNeighbors  = (real *(*)[4]) allocate( i_numberOfCells * 4 * sizeof(real*) );
+      o_cluster.timeIntegrated = (real *(*)[4]) allocate( i_numberOfCells * 4 * sizeof(real*) );
+
+      fillRandom( o_cluster.localIntegration[0].starMatrices[0],   i_numberOfCells * sizeof(LocalIntegrationData)       / sizeof(real), 1.0 );
+      fillRandom( o_cluster.neighboringIntegration[0].nAmNm1[0],   i_numberOfCells * sizeof(NeighboringIntegrationData) / sizeof(real), 1.0 );
+      fillRandom( o_cluster.initialDofs[0], i_numberOfCells * NUMBER_OF_ALIGNED_DOFS, 1.0 );
+      fillRandom( o_cluster.buffers[0],     i_numberOfCells * NUMBER_OF_ALIGNED_DOFS, 1.0 );
+      fillRandom( o_cluster.derivatives[0], i_numberOfCells * NUMBER_OF_ALIGNED_DERS, 1.0 );
+
+      // every cell holds a buffer; derivatives are added if required by a face-neighbor
+      for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
+        o_cluster.cellInformation[l_cell].ltsSetup  = (1 << 8);
+        o_cluster.cellInformation[l_cell].clusterId = 0;
+      }
+
+      for( unsigned int l_cell = 0; l_cell < i_numberOfCells; l_cell++ ) {
+        CellLocalInformation &l_information = o_cluster.cellInformation[l_cell];
+
+        for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+          l_information.faceRelations[l_face][0] = rand() % 4;
+          l_information.faceRelations[l_face][1] = rand() % 3;
+
+          double l_type = (double) rand() / RAND_MAX;
+          if( l_type < i_ruptureRatio ) {
+            l_information.faceTypes[l_face]       = dynamicRupture;
+            l_information.faceNeighborIds[l_face] = l_cell;
+            o_cluster.faceNeighbors[l_cell][l_face]  = NULL;
+            o_cluster.timeIntegrated[l_cell][l_face] = NULL;
+          }
+          else if( l_type < i_ruptureRatio + i_freeSurfaceRatio ) {
+            // free surfaces use the cell's own buffer
+            l_information.faceTypes[l_face]       = freeSurface;
+            l_information.faceNeighborIds[l_face] = l_cell;
+            o_cluster.faceNeighbors[l_cell][l_face]  = o_cluster.buffers[l_cell];
+            o_cluster.timeIntegrated[l_cell][l_face] = o_cluster.buffers[l_cell];
+          }
+          else {
+            // face-neighbors are close in memory, as for a reordered mesh
+            int l_neighbor = (int) l_cell + rand() % 129 - 64;
+            if( l_neighbor < 0 ) l_neighbor = 0;
+            if( l_neighbor >= (int) i_numberOfCells ) l_neighbor = i_numberOfCells - 1;
+
+            l_information.faceTypes[l_face]       = regular;
+            l_information.faceNeighborIds[l_face] = l_neighbor;
+            o_cluster.timeIntegrated[l_cell][l_face] = o_cluster.buffers[l_neighbor];
+
+            if( draw( i_derivativesRatio ) ) {
+              // neighbor provides derivatives; GTS relation for every second of those
+              l_information.ltsSetup |= (1 << l_face);
+              if( draw( 0.5 ) ) l_information.ltsSetup |= (1 << (l_face+4));
+              o_cluster.cellInformation[l_neighbor].ltsSetup |= (1 << 9);
+              o_cluster.faceNeighbors[l_cell][l_face] = o_cluster.derivatives[l_neighbor];
+            }
+            else {
+              o_cluster.faceNeighbors[l_cell][l_face] = o_cluster.buffers[l_neighbor];
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * Derives the flops and bytes of the kernels for the given cluster.
+     **/
+    static void flopsAndBytes( const Cluster                      &i_cluster,
+                               seissol::kernels::Time             &i_timeKernel,
+                               seissol::kernels::Volume           &i_volumeKernel,
+                               seissol::kernels::Boundary         &i_boundaryKernel,
+                               unsigned long long                  o_nonZeroFlops[numberOfKernels],
+                               unsigned long long                  o_hardwareFlops[numberOfKernels],
+                               unsigned long long                  o_bytes[numberOfKernels] ) {
+      unsigned int l_nonZeroFlops, l_hardwareFlops;
+      unsigned int l_integralNonZeroFlops, l_integralHardwareFlops;
+      flopsTimeIntegral( l_integralNonZeroFlops, l_integralHardwareFlops );
+
+      for( unsigned int l_kernel = 0; l_kernel < numberOfKernels; l_kernel++ ) {
+        o_nonZeroFlops[l_kernel] = o_hardwareFlops[l_kernel] = o_bytes[l_kernel] = 0;
+      }
+
+      for( unsigned int l_cell = 0; l_cell < i_cluster.numberOfCells; l_cell++ ) {
+        const CellLocalInformation &l_information = i_cluster.cellInformation[l_cell];
+
+        l_nonZeroFlops = l_hardwareFlops = 0;
+        i_timeKernel.flopsAder( l_nonZeroFlops, l_hardwareFlops );
+        o_nonZeroFlops[aderKernel] += l_nonZeroFlops; o_hardwareFlops[aderKernel] += l_hardwareFlops;
+        o_bytes[aderKernel] += 2 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + 3 * STAR_NNZ * sizeof(real);
+        if( (l_information.ltsSetup >> 9) % 2 == 1 ) o_bytes[aderKernel] += NUMBER_OF_ALIGNED_DERS * sizeof(real);
+
+        o_nonZeroFlops[timeIntegralKernel] += l_integralNonZeroFlops; o_hardwareFlops[timeIntegralKernel] += l_integralHardwareFlops;
+        o_bytes[timeIntegralKernel] += ( NUMBER_OF_ALIGNED_DERS + NUMBER_OF_ALIGNED_DOFS ) * sizeof(real);
+
+        l_nonZeroFlops = l_hardwareFlops = 0;
+        i_volumeKernel.flopsIntegral( l_nonZeroFlops, l_hardwareFlops );
+        o_nonZeroFlops[volumeKernel] += l_nonZeroFlops; o_hardwareFlops[volumeKernel] += l_hardwareFlops;
+        o_bytes[volumeKernel] += 3 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + 3 * STAR_NNZ * sizeof(real);
+
+        i_boundaryKernel.flopsLocalIntegral( l_information.faceTypes, l_nonZeroFlops, l_hardwareFlops );
+        o_nonZeroFlops[localBoundaryKernel] += l_nonZeroFlops; o_hardwareFlops[localBoundaryKernel] += l_hardwareFlops;
+        o_bytes[localBoundaryKernel] += 3 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + 4 * NUMBER_OF_QUANTITIES * NUMBER_OF_QUANTITIES * sizeof(real);
+
+        i_boundaryKernel.flopsNeighborsIntegral( l_information.faceTypes, l_information.faceRelations, l_nonZeroFlops, l_hardwareFlops );
+        o_nonZeroFlops[neighborsBoundaryKernel] += l_nonZeroFlops; o_hardwareFlops[neighborsBoundaryKernel] += l_hardwareFlops;
+        o_bytes[neighborsBoundaryKernel] += 2 * NUMBER_OF_ALIGNED_DOFS * sizeof(real) + 4 * NUMBER_OF_QUANTITIES * NUMBER_OF_QUANTITIES * sizeof(real);
+
+        for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+          if( l_information.faceTypes[l_face] != outflow && l_information.faceTypes[l_face] != dynamicRupture ) {
+            o_bytes[neighborsBoundaryKernel] += NUMBER_OF_ALIGNED_DOFS * sizeof(real);
+
+            if( (l_information.ltsSetup >> l_face) % 2 == 1 ) {
+              o_nonZeroFlops[timeIntegralsKernel]  += l_integralNonZeroFlops;
+              o_hardwareFlops[timeIntegralsKernel] += l_integralHardwareFlops;
+              o_bytes[timeIntegralsKernel] += ( NUMBER_OF_ALIGNED_DERS + NUMBER_OF_ALIGNED_DOFS ) * sizeof(real);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+int main( int i_argc, char **i_argv ) {
+  int l_rank = 0;
+#ifdef USE_MPI
+  MPI_Init( &i_argc, &i_argv );
+  MPI_Comm_rank( MPI_COMM_WORLD, &l_rank );
+#endif
+
+  using namespace seissol::benchmark;
+
+  unsigned int l_numberOfCells   = utils::Env::get<unsigned int>( "SEISSOL_BENCHMARK_CELLS", 10000 );
+  unsigned int l_repetitions     = utils::Env::get<unsigned int>( "SEISSOL_BENCHMARK_REPETITIONS", 10 );
+  double       l_derivativesRatio = utils::Env::get<double>( "SEISSOL_BENCHMARK_DERIVATIVES", 0.25 );
+  double       l_freeSurfaceRatio = utils::Env::get<double>( "SEISSOL_BENCHMARK_FREE_SURFACE", 0.05 );
+  double       l_ruptureRatio     = utils::Env::get<double>( "SEISSOL_BENCHMARK_RUPTURE", 0.01 );
+  srand( utils::Env::get<unsigned int>( "SEISSOL_BENCHMARK_SEED", 1 ) );
+
+  if( l_numberOfCells == 0 || l_repetitions == 0 ) {
+    logError() << "the benchmark requires at least one cell and one repetition";
+  }
+
+  logInfo(l_rank) << "Kernel micro-benchmark: order" << CONVERGENCE_ORDER
+                  << ", quantities" << NUMBER_OF_QUANTITIES
+                  << ", precision" << sizeof(real)*8 << "bit"
+                  << ", alignment" << ALIGNMENT;
+  logInfo(l_rank) << "Cells:" << l_numberOfCells << ", repetitions:" << l_repetitions
+                  << ", derivatives:" << l_derivativesRatio << ", free surface:" << l_freeSurfaceRatio
+                  << ", rupture:" << l_ruptureRatio;
+
+  GlobalData l_globalData;
+  initializeGlobalData( l_globalData );
+
+  Cluster l_cluster;
+  initializeCluster( l_numberOfCells, l_derivativesRatio, l_freeSurfaceRatio, l_ruptureRatio, l_cluster );
+
+  seissol::kernels::Time     l_timeKernel;
+  seissol::kernels::Volume   l_volumeKernel;
+  seissol::kernels::Boundary l_boundaryKernel;
+
+  unsigned long long l_nonZeroFlops[numberOfKernels], l_hardwareFlops[numberOfKernels], l_bytes[numberOfKernels];
+  flopsAndBytes( l_cluster, l_timeKernel, l_volumeKernel, l_boundaryKernel, l_nonZeroFlops, l_hardwareFlops, l_bytes );
+
+  // small time step width keeps the Taylor series bounded
+  const double l_timeStepWidth = 1E-3;
+
+  double l_minTime[numberOfKernels], l_sumTime[numberOfKernels];
+  for( unsigned int l_kernel = 0; l_kernel < numberOfKernels; l_kernel++ ) {
+    l_minTime[l_kernel] = std::numeric_limits<double>::max();
+    l_sumTime[l_kernel] = 0;
+  }
+
+  // the first repetition warms up caches and page tables and is not timed
+  for( unsigned int l_repetition = 0; l_repetition <= l_repetitions; l_repetition++ ) {
+    // reset the degrees of freedom to prevent an exponential growth over the repetitions
+    memcpy( l_cluster.dofs[0], l_cluster.initialDofs[0], (size_t) l_numberOfCells * NUMBER_OF_ALIGNED_DOFS * sizeof(real) );
+
+    double l_time[numberOfKernels+1];
+    l_time[aderKernel] = seissol::monitoring::getWallTime();
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+      l_timeKernel.computeAder( l_timeStepWidth,
+                                l_globalData.stiffnessMatricesTransposed,
+                                l_cluster.dofs[l_cell],
+                                l_cluster.localIntegration[l_cell].starMatrices,
+#ifdef REQUIRE_SOURCE_MATRIX
+                                l_cluster.localIntegration[l_cell].sourceMatrix,
+#endif
+                                l_cluster.buffers[l_cell],
+                                (l_cluster.cellInformation[l_cell].ltsSetup >> 9) % 2 == 1 ? l_cluster.derivatives[l_cell] : NULL );
+    }
+    l_time[timeIntegralKernel] = seissol::monitoring::getWallTime();
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+      l_timeKernel.computeIntegral( 0, 0, l_timeStepWidth,
+                                    l_cluster.derivatives[l_cell],
+                                    l_cluster.buffers[l_cell] );
+    }
+    l_time[volumeKernel] = seissol::monitoring::getWallTime();
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+      l_volumeKernel.computeIntegral( l_globalData.stiffnessMatrices,
+                                      l_cluster.buffers[l_cell],
+                                      l_cluster.localIntegration[l_cell].starMatrices,
+                                      l_cluster.dofs[l_cell] );
+    }
+    l_time[localBoundaryKernel] = seissol::monitoring::getWallTime();
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+      l_boundaryKernel.computeLocalIntegral( l_cluster.cellInformation[l_cell].faceTypes,
+                                             l_globalData.fluxMatrices,
+                                             l_cluster.buffers[l_cell],
+                                             l_cluster.localIntegration[l_cell].nApNm1,
+                                             l_cluster.dofs[l_cell] );
+    }
+    l_time[timeIntegralsKernel] = seissol::monitoring::getWallTime();
+
+    real  l_integrationBuffer[4][NUMBER_OF_ALIGNED_DOFS] __attribute__((aligned(PAGESIZE_STACK)));
+    real *l_timeIntegrated[4];
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) private(l_integrationBuffer, l_timeIntegrated)
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+      l_timeKernel.computeIntegrals( l_cluster.cellInformation[l_cell].ltsSetup,
+                                     l_cluster.cellInformation[l_cell].faceTypes,
+                                     0.0,
+                                     l_timeStepWidth,
+                                     l_cluster.faceNeighbors[l_cell],
+                                     l_integrationBuffer,
+                                     l_timeIntegrated );
+    }
+    l_time[neighborsBoundaryKernel] = seissol::monitoring::getWallTime();
+
+#ifdef ENABLE_MATRIX_PREFETCH
+    real *l_faceNeighbors_prefetch[4];
+    real *l_fluxMatricies_prefetch[4];
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) private(l_faceNeighbors_prefetch, l_fluxMatricies_prefetch)
+#endif
+#else
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+#endif
+    for( int l_cell = 0; l_cell < (int) l_numberOfCells; l_cell++ ) {
+#ifdef ENABLE_MATRIX_PREFETCH
+      // prefetch the data of the next face (of the next cell for the last face)
+      for( unsigned int l_face = 0; l_face < 4; l_face++ ) {
+        unsigned int l_prefetchCell = ( l_face < 3 || l_cell == (int) l_numberOfCells-1 ) ? l_cell : l_cell+1;
+        unsigned int l_prefetchFace = (l_face+1) % 4;
+        l_faceNeighbors_prefetch[l_face] = l_cluster.timeIntegrated[l_prefetchCell][l_prefetchFace];
+        l_fluxMatricies_prefetch[l_face] = l_globalData.fluxMatrices[4+(l_prefetchFace*12)
+                                                                     +(l_cluster.cellInformation[l_prefetchCell].faceRelations[l_prefetchFace][0]*3)
+                                                                     +(l_cluster.cellInformation[l_prefetchCell].faceRelations[l_prefetchFace][1])];
+      }
+#endif
+      l_boundaryKernel.computeNeighborsIntegral( l_cluster.cellInformation[l_cell].faceTypes,
+                                                 l_cluster.cellInformation[l_cell].faceRelations,
+                                                 l_globalData.fluxMatrices,
+                                                 l_cluster.timeIntegrated[l_cell],
+                                                 l_cluster.neighboringIntegration[l_cell].nAmNm1,
+#ifdef ENABLE_MATRIX_PREFETCH
+                                                 l_cluster.dofs[l_cell],
+                                                 l_faceNeighbors_prefetch,
+                                                 l_fluxMatricies_prefetch );
+#else
+                                                 l_cluster.dofs[l_cell] );
+#endif
+    }
+    l_time[numberOfKernels] = seissol::monitoring::getWallTime();
+
+    if( l_repetition > 0 ) {
+      for( unsigned int l_kernel = 0; l_kernel < numberOfKernels; l_kernel++ ) {
+        double l_kernelTime = l_time[l_kernel+1] - l_time[l_kernel];
+        l_minTime[l_kernel]  = std::min( l_minTime[l_kernel], l_kernelTime );
+        l_sumTime[l_kernel] += l_kernelTime;
+      }
+    }
+  }
+
+  /*
+   * report
+   */
+  double l_totalTime = 0, l_totalNonZeroFlops = 0, l_totalHardwareFlops = 0, l_totalBytes = 0;
+  for( unsigned int l_kernel = 0; l_kernel < numberOfKernels; l_kernel++ ) {
+    double l_averageTime = l_sumTime[l_kernel] / l_repetitions;
+
+    logInfo(l_rank) << c_kernelNames[l_kernel] << ":"
+                    << l_averageTime * 1E9 / l_numberOfCells << "ns/cell (min"
+                    << l_minTime[l_kernel] * 1E9 / l_numberOfCells << "ns/cell),"
+                    << l_hardwareFlops[l_kernel] / l_averageTime * 1E-9 << "HW-GFLOP/s,"
+                    << l_nonZeroFlops[l_kernel]  / l_averageTime * 1E-9 << "NZ-GFLOP/s,"
+                    << l_bytes[l_kernel]         / l_averageTime * 1E-9 << "GB/s";
+
+    l_totalTime          += l_averageTime;
+    l_totalNonZeroFlops  += l_nonZeroFlops[l_kernel];
+    l_totalHardwareFlops += l_hardwareFlops[l_kernel];
+    l_totalBytes         += l_bytes[l_kernel];
+  }
+
+  logInfo(l_rank) << "Total:"
+                  << l_totalTime * 1E9 / l_numberOfCells << "ns/cell,"
+                  << l_totalHardwareFlops / l_totalTime * 1E-9 << "HW-GFLOP/s,"
+                  << l_totalNonZeroFlops  / l_totalTime * 1E-9 << "NZ-GFLOP/s,"
+                  << l_totalBytes         / l_totalTime * 1E-9 << "GB/s";
+
+#ifdef USE_MPI
+  MPI_Finalize();
+#endif
+
+  return 0;
+}
@@ -79,6 +79,10 @@ PROGRAM SeisSol
   CHARACTER(LEN=600)                     :: name
   INTEGER                                :: iTry
   LOGICAL                                :: fexist
+#ifdef PARALLEL
+  CHARACTER(LEN=16)                      :: asyncOutput
+  INTEGER                                :: threadLevel
+#endif
   !----------------------------------------------------------------------------
   
   ! register epik/scorep function SeisSol
@@ -101,7 +105,13 @@ PROGRAM SeisSol
 #ifdef PARALLEL
   ! Initialize MPI 
 
-   CALL MPI_INIT(domain%MPI%iErr)
+   ! Asynchronous output requires MPI calls from the I/O thread
+   CALL get_environment_variable('SEISSOL_ASYNC_OUTPUT', asyncOutput)
+   IF (TRIM(asyncOutput) .NE. '' .AND. TRIM(asyncOutput) .NE. '0') THEN
+     CALL MPI_INIT_THREAD(MPI_THREAD_MULTIPLE, threadLevel, domain%MPI%iErr)
+   ELSE
+     CALL MPI_INIT(domain%MPI%iErr)
+   ENDIF
    CALL MPI_COMM_RANK(MPI_COMM_WORLD, domain%MPI%myrank, domain%MPI%iErr)
    CALL MPI_COMM_SIZE(MPI_COMM_WORLD, domain%MPI%nCPU,   domain%MPI%iErr)
 
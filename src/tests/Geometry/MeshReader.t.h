@@ -165,10 +165,11 @@ private:
 		for (int i = 0; i < nVertices; i++) {
 			for (int j = 0; j < nVertices; j++) {
 				if (isSameVertex(verticesNew[i].coords, &verticesXY[j*3])) {
-					TS_ASSERT_EQUALS(verticesNew[i].elements.size(), vrtxnelements[j]);
+					VertexElements vertexElements = meshReader.getVertexElements(i);
+					TS_ASSERT_EQUALS(vertexElements.size(), vrtxnelements[j]);
 
-					for (int k = 0; k < verticesNew[i].elements.size(); k++) {
-						TS_ASSERT_EQUALS(verticesNew[i].elements[k], vrtxelements[j+k*nVertices]-1);
+					for (int k = 0; k < vertexElements.size(); k++) {
+						TS_ASSERT_EQUALS(vertexElements[k], vrtxelements[j+k*nVertices]-1);
 					}
 				}
 			}